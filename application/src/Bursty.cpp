@@ -31,28 +31,20 @@
 /// Constructor
 ////////////////////////////////////////////////
 BurstyTraffic::BurstyTraffic(sc_module_name BurstyTraffic) : TrafficGenerator(BurstyTraffic), var_burstlen(0.0), var_offtime(0.0) {
-	// clear traffic log
-	system("rm -f log/traffic/*");
-	
-	char str_id[3];
-	ofstream trafstream;
-	// create new traffic log file
-	for(int i = 0; i < num_tiles; i++) {
-		sprintf(str_id, "%d", i);
-		string traffic_filename = string("log/traffic/tile-") + string(str_id);
-		trafstream.open(traffic_filename.c_str());
-		trafstream.close();
-	}
-	// thread sensitive to clock
-	SC_CTHREAD(init, clock.pos());
+	pkt_interval = 0;
+	pkt_size = 0;
+	load = 100;
+	avg_burstlen = 0;
+	avg_offtime = 0;
+	rem = 0;
 }
 
 ////////////////////////////////////////////////
-/// Process to generate Bursty traffic
+/// Method to prepare Bursty traffic source
 /// - read traffic configuration file
-/// - generate traffic pattern in log file
+/// - packets are generated on the fly by next_packet()
 ////////////////////////////////////////////////
-void BurstyTraffic::init() {
+void BurstyTraffic::init_source() {
 	// open traffic config file
 	char str_id[3];
 	sprintf(str_id, "%d", tileID);
@@ -99,21 +91,21 @@ void BurstyTraffic::init() {
 	// compute number of packets in first burst
 	rem = int(var_burstlen.value() + .5);
 	
-	// open traffic log file
-	traffic_filename = string("log/traffic/tile-") + string(str_id);
-	ofstream trafstream;
-	trafstream.open(traffic_filename.c_str());
-	// write inter-flit interval
-	trafstream<<"FLIT_INTERVAL: "<<flit_interval<<endl;
-	for(int i = WARMUP; i <= TG_NUM; i++) {
-		next_pkt_time = (int)next_interval();	// get next packet interval
-		trafstream<<"NEXT_PKT_INTERVAL: "<<next_pkt_time<<endl;	// write next packet interval
-		if(dst_type == "RANDOM")
-			route_info = get_random_dest();		// get random destination
-		trafstream<<"NUM_FLITS: "<<num_flits<<endl;	// write number of flits
-		trafstream<<"DESTINATION: "<<route_info<<endl;	// write destination ID or route code
-	}
-	trafstream.close();	// close traffic log file
+	// export of generated pattern (optional)
+	open_export();
+}
+
+////////////////////////////////////////////////
+/// Method to generate next packet
+/// \return always true, generation is bounded by TG_NUM
+////////////////////////////////////////////////
+bool BurstyTraffic::next_packet()
+{
+	next_pkt_time = (int)next_interval();	// get next packet interval
+	if(dst_type == "RANDOM")
+		route_info = get_random_dest();		// get random destination
+	export_packet();
+	return true;
 }
 
 ////////////////////////////////////////////////
@@ -41,7 +41,8 @@ struct BurstyTraffic : public TrafficGenerator {
 	SC_CTOR(BurstyTraffic);
 	
 	// PROCESSES /////////////////////////////////////////////////////////
-	void init();		///< generate traffic log as per traffic configuration
+	void init_source();	///< read traffic configuration
+	bool next_packet();	///< generate next packet as per traffic configuration
 	double next_interval();	///< return next packet interval
 	// PROCESSES END /////////////////////////////////////////////////////
 	
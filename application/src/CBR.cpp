@@ -32,31 +32,17 @@
 ////////////////////////////////////////////////
 CBRTraffic::CBRTraffic(sc_module_name CBRTraffic) : TrafficGenerator(CBRTraffic)
 {
-	// clear traffic log
-	system("rm -f log/traffic/*");
-	// initialize random number generator
-	//rnum = new RNG((RNG::RNGSources)2, 1); //HEURISTIC_SEED_SOURCE
-	char str_id[3];
-	ofstream trafstream;
-	
-	// create new traffic log file
-	for(int i = 0; i < num_tiles; i++) {
-		sprintf(str_id, "%d", i);
-		string traffic_filename = string("log/traffic/tile-") + string(str_id);
-		trafstream.open(traffic_filename.c_str());
-		trafstream.close();
-	}
-	
-	// thread sensitive to clock
-	SC_CTHREAD(init, clock.pos());
+	pkt_interval = 0;
+	pkt_size = 0;
+	load = 100;
 }
 
 ////////////////////////////////////////////////
-/// Process to generate CBR traffic
+/// Method to prepare CBR traffic source
 /// - read traffic configuration file
-/// - generate traffic pattern in log file
+/// - packets are generated on the fly by next_packet()
 ////////////////////////////////////////////////
-void CBRTraffic::init()
+void CBRTraffic::init_source()
 {
 	// open traffic config file
 	char str_id[3];
@@ -92,39 +78,21 @@ void CBRTraffic::init()
 	// compute inter-packet interval
 	pkt_interval = (int)((ceil)(100.0/load) * num_flits * cycles_per_flit);
 	
-	// open traffic log file
-	string dest_type;
-	traffic_filename = string("log/traffic/tile-") + string(str_id);
-	ofstream trafstream;
-	trafstream.open(traffic_filename.c_str());
-	// write inter-flit interval
-	trafstream<<"FLIT_INTERVAL: "<<flit_interval<<endl;
-	
-    ULL total_time = WARMUP;
-    int next_pkt_time;
-    
-    while (total_time <= TG_NUM)
-    {
-        next_pkt_time = (int)next_interval();	// get next packet interval
-        total_time += (ULL)next_pkt_time;
-        trafstream<<"NEXT_PKT_INTERVAL: "<<next_pkt_time<<endl;	// write next packet interval
-		if(dst_type == "RANDOM")
-			route_info = get_random_dest();		// get random destination
-		trafstream<<"NUM_FLITS: "<<num_flits<<endl;	// write number of flits
-		trafstream<<"DESTINATION: "<<route_info<<endl;	// write destination ID or route code        
-    }
-    
-    /*
-	for(int i = WARMUP; i <= TG_NUM; i++) {
-		next_pkt_time = (int)next_interval();	// get next packet interval
-		trafstream<<"NEXT_PKT_INTERVAL: "<<next_pkt_time<<endl;	// write next packet interval
-		if(dst_type == "RANDOM")
-			route_info = get_random_dest();		// get random destination
-		trafstream<<"NUM_FLITS: "<<num_flits<<endl;	// write number of flits
-		trafstream<<"DESTINATION: "<<route_info<<endl;	// write destination ID or route code
-	}
-     * */
-	trafstream.close();	// close traffic log file
+	// export of generated pattern (optional)
+	open_export();
+}
+
+////////////////////////////////////////////////
+/// Method to generate next packet
+/// \return always true, generation is bounded by TG_NUM
+////////////////////////////////////////////////
+bool CBRTraffic::next_packet()
+{
+	next_pkt_time = (int)next_interval();	// get next packet interval
+	if(dst_type == "RANDOM")
+		route_info = get_random_dest();		// get random destination
+	export_packet();
+	return true;
 }
 
 ////////////////////////////////////////////////
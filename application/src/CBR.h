@@ -42,7 +42,8 @@ struct CBRTraffic : public TrafficGenerator {
 	SC_CTOR(CBRTraffic);
 	
 	// PROCESSES /////////////////////////////////////////////////////////
-	void init();		///< generate traffic log as per traffic configuration
+	void init_source();	///< read traffic configuration
+	bool next_packet();	///< generate next packet as per traffic configuration
 	double next_interval();	///< return next packet interval (constant for CBR)
 	// PROCESSES END /////////////////////////////////////////////////////
 	
@@ -0,0 +1,499 @@
+
+/*
+ * Coherence.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * Author: Lavina Jain
+ *
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file Coherence.cpp
+/// \brief Implements directory-based cache-coherence traffic model
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Coherence.h"
+#include "../../config/extern.h"
+#include <iomanip>
+
+/// number of parts miss latency is split into
+#define COH_NUM_PARTS	5
+
+// statistics shared by all tiles running this application
+static map<ULL, coh_timing> timings;					///< timing of misses at home, key is (requester, block)
+static ULL    kind_count[COH_NUM_KINDS];				///< measured misses of each kind
+static double kind_parts[COH_NUM_KINDS][COH_NUM_PARTS];	///< total latency of each part by kind
+static ULL    msg_sent[COH_NUM_MSGS];					///< packets sent of each message type
+static bool   reported = false;							///< report is written once for all tiles
+
+static const char *msg_names[COH_NUM_MSGS] = {"GETS", "GETX", "FWD_GETS", "FWD_GETX", "INV", "INV_ACK", "DATA", "WB", "PUTX", "UNBLOCK"};
+static const char *kind_names[COH_NUM_KINDS] = {"2-hop (home)", "3-hop (owner)", "invalidation"};
+
+/// returns home tile of block
+#define coh_home(block) ((block) % num_tiles)
+/// returns key of miss in timings
+#define coh_key(requester, block) (((ULL)(requester) << 32) | (block))
+/// true if message carries data
+#define coh_is_data(msg) ((msg) == COH_DATA || (msg) == COH_WB || (msg) == COH_PUTX)
+
+////////////////////////////////////////////////
+/// Constructor
+////////////////////////////////////////////////
+Coherence::Coherence(sc_module_name Coherence): ipcore(Coherence) {
+	miss_rate = 0.01;
+	write_fraction = 0.3;
+	mshrs = 4;
+	shared_fraction = 0.3;
+	shared_blocks = 256;
+	private_blocks = 1024;
+	cache_blocks = 512;
+	dir_latency = 4;
+	mem_latency = 40;
+	data_flits = 5;
+	flit_interval = 1;
+	out_seq = 0;
+	busy_entries = 0;
+}
+
+////////////////////////////////////////////////
+/// Method to read configuration of tile
+////////////////////////////////////////////////
+void Coherence::init_app() {
+	// open traffic config file
+	char str_id[4];
+	sprintf(str_id, "%d", tileID);
+	string traffic_filename = string("config/traffic/tile-") + string(str_id);
+	ifstream instream;
+	instream.open(traffic_filename.c_str());
+
+	while(!instream.eof()) {
+		string field;
+		instream >> field;
+		if(field == "MISS_RATE") {
+			double value; instream >> value; miss_rate = value;
+		}
+		else if(field == "WRITE_FRACTION") {
+			double value; instream >> value; write_fraction = value;
+		}
+		else if(field == "MSHRS") {
+			UI value; instream >> value; mshrs = value;
+		}
+		else if(field == "SHARED_FRACTION") {
+			double value; instream >> value; shared_fraction = value;
+		}
+		else if(field == "SHARED_BLOCKS") {
+			UI value; instream >> value; shared_blocks = value;
+		}
+		else if(field == "PRIVATE_BLOCKS") {
+			UI value; instream >> value; private_blocks = value;
+		}
+		else if(field == "CACHE_BLOCKS") {
+			UI value; instream >> value; cache_blocks = value;
+		}
+		else if(field == "DIR_LATENCY") {
+			ULL value; instream >> value; dir_latency = value;
+		}
+		else if(field == "MEM_LATENCY") {
+			ULL value; instream >> value; mem_latency = value;
+		}
+		else if(field == "DATA_FLITS") {
+			int value; instream >> value; data_flits = value;
+		}
+		else if(field == "FLIT_INTERVAL") {	// read inter-flit interval
+			int value; instream >> value; flit_interval = value;
+		}
+	}
+	instream.close();
+	
+	if(private_blocks < 1)
+		private_blocks = 1;
+	if(cache_blocks < 1)
+		cache_blocks = 1;
+	
+	if(LOG >= 1)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" coherence miss rate "<<miss_rate
+		        <<" write fraction "<<write_fraction<<" mshrs "<<mshrs;
+}
+
+////////////////////////////////////////////////
+/// Thread sensitive to clock
+/// - inherited from ipcore
+/// - issue miss with probability MISS_RATE while MSHRs are free (until TG_NUM)
+/// - send protocol messages whose delay has passed, messages to own
+///   tile are handled without network
+/// - inject one flit per flit_interval from injection queue
+/// - core reports itself finished while it has nothing in flight, it is
+///   never left since other tiles may still send requests
+////////////////////////////////////////////////
+void Coherence::send_app() {
+	wait(WARMUP);	// wait for WARMUP period
+	init_app();
+	ULL next_inject = sim_count;
+	
+	while(true) {
+		if(sim_count <= TG_NUM && mshr.size() < mshrs && !inj_queue_full() && ran_var->uniform() < miss_rate)
+			issue_miss();
+		
+		while(!out.empty() && out.top().ready <= sim_count) {
+			coh_out m = out.top();
+			out.pop();
+			if(m.dst == tileID)
+				handle(tileID, m.msg, m.aux, m.block);
+			else {
+				enqueue_packet(m.dst, coh_is_data(m.msg) ? data_flits : 1, m.msg | (m.aux << 8), m.block);
+				msg_sent[m.msg]++;
+			}
+		}
+		
+		// inject front flit of queue, flits of one packet are flit_interval apart
+		inject_step(next_inject, flit_interval);
+		
+		send_finished = sim_count > TG_NUM && mshr.empty() && out.empty() && inj_queue.empty() && busy_entries == 0;
+		wait();
+	}
+}
+
+////////////////////////////////////////////////
+/// Thread sensitive to clock and inport event
+/// - inherited from ipcore
+/// - message is handled when its last flit arrives
+////////////////////////////////////////////////
+void Coherence::recv_app() {
+	wait();	// wait until inport event
+	if(!flit_inport.event())
+		return;
+	flit flit_recd = flit_inport.read();	// read incoming flit
+	flit_type type = flit_recd.pkthdr.nochdr.flittype;
+	if(type != TAIL && type != HDT)
+		return;
+	int cmd, block;
+	get_payload(flit_recd, cmd, block);
+	handle(flit_recd.src, cmd & 0xff, (UI)cmd >> 8, (UI)block);
+}
+
+////////////////////////////////////////////////
+/// Method to issue miss
+/// - blocks that would hit are redrawn (up to 8 times)
+/// - access to block with outstanding miss is merged into it
+////////////////////////////////////////////////
+void Coherence::issue_miss() {
+	for(UI tries = 0; tries < 8; tries++) {
+		UI block;
+		if(shared_blocks > 0 && ran_var->uniform() < shared_fraction)
+			block = ran_var->uniform((int)shared_blocks);
+		else
+			block = shared_blocks + tileID * private_blocks + ran_var->uniform((int)private_blocks);
+		bool write = ran_var->uniform() < write_fraction;
+		
+		if(mshr.find(block) != mshr.end())
+			return;
+		map<UI, bool>::iterator it = cache.find(block);
+		if(it != cache.end() && (!write || it->second))
+			continue;	// hit
+		
+		coh_miss m;
+		m.write = write;
+		m.issue = sim_count;
+		m.data = false;
+		m.acks_needed = 0;
+		m.acks = 0;
+		m.data_src = 0;
+		m.data_time = 0;
+		mshr[block] = m;
+		send_msg(coh_home(block), write ? COH_GETX : COH_GETS, 0, block, 0);
+		return;
+	}
+}
+
+////////////////////////////////////////////////
+/// Method to queue protocol message
+/// \param dst destination tile
+/// \param msg message type (coh_msg)
+/// \param aux auxiliary tile or count
+/// \param block block address
+/// \param delay cycles before message may leave
+////////////////////////////////////////////////
+void Coherence::send_msg(UI dst, int msg, UI aux, UI block, ULL delay) {
+	coh_out m;
+	m.ready = sim_count + delay;
+	m.seq = out_seq++;
+	m.dst = dst;
+	m.msg = msg;
+	m.aux = aux;
+	m.block = block;
+	out.push(m);
+}
+
+////////////////////////////////////////////////
+/// Method to process protocol message
+/// \param src sending tile
+/// \param msg message type (coh_msg)
+/// \param aux auxiliary tile or count
+/// \param block block address
+////////////////////////////////////////////////
+void Coherence::handle(UI src, int msg, UI aux, UI block) {
+	if(LOG >= 3)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" coherence "
+		        <<((msg < COH_NUM_MSGS) ? msg_names[msg] : "?")<<" from "<<src<<" block "<<block;
+	switch(msg) {
+		case COH_GETS:
+		case COH_GETX:
+			home_request(src, msg, block);
+			break;
+		case COH_FWD_GETS:	// owner supplies data (from writeback buffer if evicted) and keeps shared copy
+			send_msg(aux, COH_DATA, 0, block, 0);
+			send_msg(coh_home(block), COH_WB, 0, block, 0);
+			if(cache.find(block) != cache.end())
+				cache[block] = false;
+			break;
+		case COH_FWD_GETX:
+			send_msg(aux, COH_DATA, 0, block, 0);
+			cache_remove(block);
+			break;
+		case COH_INV:
+			cache_remove(block);
+			send_msg(aux, COH_INV_ACK, 0, block, 0);
+			break;
+		case COH_INV_ACK: {
+			map<UI, coh_miss>::iterator it = mshr.find(block);
+			if(it == mshr.end())
+				break;
+			it->second.acks++;
+			if(it->second.data && it->second.acks >= it->second.acks_needed)
+				complete_miss(block);
+			break;
+		}
+		case COH_DATA: {
+			map<UI, coh_miss>::iterator it = mshr.find(block);
+			if(it == mshr.end())
+				break;
+			it->second.data = true;
+			it->second.acks_needed = aux;
+			it->second.data_src = src;
+			it->second.data_time = sim_count;
+			if(it->second.acks >= it->second.acks_needed)
+				complete_miss(block);
+			break;
+		}
+		case COH_WB:
+			break;
+		case COH_PUTX: {
+			coh_dir_entry &entry = dir[block];
+			if(!entry.busy && entry.state == DIR_M && entry.owner == src)
+				entry.state = DIR_I;
+			break;
+		}
+		case COH_UNBLOCK: {
+			coh_dir_entry &entry = dir[block];
+			if(entry.busy) {
+				entry.busy = false;
+				busy_entries--;
+			}
+			if(!entry.waiting.empty()) {
+				pair<UI, int> req = entry.waiting.front();
+				entry.waiting.pop_front();
+				home_serve(req.first, req.second, block);
+			}
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+////////////////////////////////////////////////
+/// Method to accept request at home directory
+/// \param requester requesting tile
+/// \param msg COH_GETS or COH_GETX
+/// \param block block address
+////////////////////////////////////////////////
+void Coherence::home_request(UI requester, int msg, UI block) {
+	timings[coh_key(requester, block)].home_arrive = sim_count;
+	coh_dir_entry &entry = dir[block];
+	if(entry.busy)
+		entry.waiting.push_back(pair<UI, int>(requester, msg));
+	else
+		home_serve(requester, msg, block);
+}
+
+////////////////////////////////////////////////
+/// Method to serve request at home directory
+/// \param requester requesting tile
+/// \param msg COH_GETS or COH_GETX
+/// \param block block address
+/// - entry stays busy until requester unblocks it
+////////////////////////////////////////////////
+void Coherence::home_serve(UI requester, int msg, UI block) {
+	coh_dir_entry &entry = dir[block];
+	coh_timing &t = timings[coh_key(requester, block)];
+	entry.busy = true;
+	busy_entries++;
+	t.home_start = sim_count;
+	t.home_send = sim_count + dir_latency;
+	bool other_owner = (entry.state == DIR_M && entry.owner != requester);
+	
+	if(msg == COH_GETS) {
+		if(other_owner) {
+			send_msg(entry.owner, COH_FWD_GETS, requester, block, dir_latency);
+			entry.sharers.reset();
+			entry.sharers.set(entry.owner);
+		}
+		else {
+			ULL delay = dir_latency + ((entry.state == DIR_S) ? 0 : mem_latency);
+			t.home_send = sim_count + delay;
+			send_msg(requester, COH_DATA, 0, block, delay);
+			if(entry.state != DIR_S)
+				entry.sharers.reset();
+		}
+		entry.state = DIR_S;
+		entry.sharers.set(requester);
+		return;
+	}
+	
+	// write miss
+	if(other_owner)
+		send_msg(entry.owner, COH_FWD_GETX, requester, block, dir_latency);
+	else if(entry.state == DIR_S) {
+		UI acks = 0;
+		for(UI s = 0; s < num_tiles; s++) {
+			if(s == requester || !entry.sharers.test(s))
+				continue;
+			send_msg(s, COH_INV, requester, block, dir_latency);
+			acks++;
+		}
+		send_msg(requester, COH_DATA, acks, block, dir_latency);
+	}
+	else {
+		t.home_send = sim_count + dir_latency + mem_latency;
+		send_msg(requester, COH_DATA, 0, block, dir_latency + mem_latency);
+	}
+	entry.state = DIR_M;
+	entry.owner = requester;
+	entry.sharers.reset();
+}
+
+////////////////////////////////////////////////
+/// Method to finish miss
+/// \param block block address
+/// - install block, unblock home and record latency breakdown
+////////////////////////////////////////////////
+void Coherence::complete_miss(UI block) {
+	coh_miss m = mshr[block];
+	mshr.erase(block);
+	cache_insert(block, m.write);
+	send_msg(coh_home(block), COH_UNBLOCK, 0, block, 0);
+	record_transaction(m.issue);
+	
+	map<ULL, coh_timing>::iterator it = timings.find(coh_key(tileID, block));
+	if(it == timings.end())
+		return;
+	coh_timing t = it->second;
+	timings.erase(it);
+	if(!in_measure_window(m.issue))
+		return;
+	coh_kind kind = (m.data_src != coh_home(block)) ? COH_KIND_FWD : ((m.acks_needed > 0) ? COH_KIND_INV : COH_KIND_HOME);
+	ULL data_sent = (t.home_send < m.data_time) ? t.home_send : m.data_time;
+	kind_count[kind]++;
+	kind_parts[kind][0] += t.home_arrive - m.issue;		// request to home
+	kind_parts[kind][1] += t.home_start - t.home_arrive;	// waiting for busy block
+	kind_parts[kind][2] += data_sent - t.home_start;		// directory and memory
+	kind_parts[kind][3] += m.data_time - data_sent;		// data (and forward) to requester
+	kind_parts[kind][4] += sim_count - m.data_time;		// remaining invalidation acks
+}
+
+////////////////////////////////////////////////
+/// Method to install block in private cache
+/// \param block block address
+/// \param modified block is written
+/// - random victim is evicted when cache is full, modified victim is written back
+////////////////////////////////////////////////
+void Coherence::cache_insert(UI block, bool modified) {
+	map<UI, bool>::iterator it = cache.find(block);
+	if(it != cache.end()) {
+		it->second = it->second || modified;
+		return;
+	}
+	if(cache_list.size() >= cache_blocks) {
+		UI victim = cache_list[ran_var->uniform((int)cache_list.size())];
+		if(cache[victim])
+			send_msg(coh_home(victim), COH_PUTX, 0, victim, 0);
+		cache_remove(victim);
+	}
+	cache[block] = modified;
+	cache_pos[block] = cache_list.size();
+	cache_list.push_back(block);
+}
+
+////////////////////////////////////////////////
+/// Method to remove block from private cache
+/// \param block block address
+////////////////////////////////////////////////
+void Coherence::cache_remove(UI block) {
+	map<UI, UI>::iterator it = cache_pos.find(block);
+	if(it == cache_pos.end())
+		return;
+	UI pos = it->second;
+	UI last = cache_list.back();
+	cache_list[pos] = last;
+	cache_pos[last] = pos;
+	cache_list.pop_back();
+	cache_pos.erase(block);
+	cache.erase(block);
+}
+
+////////////////////////////////////////////////
+/// Method to write results of coherence model
+/// \param out results file
+/// - statistics are shared by all tiles, so only first call writes them
+////////////////////////////////////////////////
+void Coherence::report(ofstream &out) {
+	if(reported)
+		return;
+	reported = true;
+	
+	ULL total = 0;
+	double latency = 0.0;
+	for(UI k = 0; k < COH_NUM_KINDS; k++) {
+		total += kind_count[k];
+		for(UI p = 0; p < COH_NUM_PARTS; p++)
+			latency += kind_parts[k][p];
+	}
+	out<<"\nCoherence misses (measured)                                    = "<<total<<endl;
+	out<<"Average miss latency              (in clock cycles)            = "<<((total == 0) ? 0.0 : latency / total)<<endl;
+	out<<"  miss kind       count      request   dir wait  dir/mem   data      inv acks"<<endl;
+	for(UI k = 0; k < COH_NUM_KINDS; k++) {
+		out<<"  "<<setw(14)<<left<<kind_names[k]<<"  "<<setw(9)<<kind_count[k]<<right;
+		for(UI p = 0; p < COH_NUM_PARTS; p++)
+			out<<"  "<<setw(8)<<left<<((kind_count[k] == 0) ? 0.0 : kind_parts[k][p] / kind_count[k])<<right;
+		out<<endl;
+	}
+	out<<"Coherence packets sent (control / data) : ";
+	ULL ctrl = 0, data = 0;
+	for(UI m = 0; m < COH_NUM_MSGS; m++) {
+		out<<msg_names[m]<<" "<<msg_sent[m]<<" ";
+		if(coh_is_data(m))
+			data += msg_sent[m];
+		else
+			ctrl += msg_sent[m];
+	}
+	out<<endl<<"  control packets = "<<ctrl<<" , data packets = "<<data<<endl;
+}
+
+// for dynamic linking
+extern "C" {
+ipcore *maker() {
+	return new Coherence("Coherence");
+}
+}
@@ -0,0 +1,190 @@
+
+/*
+ * Coherence.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * Author: Lavina Jain
+ *
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file Coherence.h
+/// \brief Defines directory-based cache-coherence traffic model
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Coherence_H_
+#define _Coherence_H_
+
+#include "../../core/ipcore.h"
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <queue>
+#include <bitset>
+
+/// required for stl
+using namespace std;
+
+/// coherence messages, carried in cmd field (low byte) with auxiliary tile/count in higher bits
+enum coh_msg {
+	COH_GETS,		///< read miss, requester to home (control)
+	COH_GETX,		///< write miss, requester to home (control)
+	COH_FWD_GETS,	///< read forwarded to owner, aux = requester (control)
+	COH_FWD_GETX,	///< write forwarded to owner, aux = requester (control)
+	COH_INV,		///< invalidation, home to sharer, aux = requester (control)
+	COH_INV_ACK,	///< invalidation ack, sharer to requester (control)
+	COH_DATA,		///< data reply to requester, aux = number of acks to wait for (data)
+	COH_WB,			///< sharing writeback, owner to home after forwarded read (data)
+	COH_PUTX,		///< writeback of evicted modified block, owner to home (data)
+	COH_UNBLOCK,	///< miss completed, requester to home (control)
+	COH_NUM_MSGS
+};
+
+/// kinds of misses by protocol path
+enum coh_kind {
+	COH_KIND_HOME,	///< 2 hops: data from home
+	COH_KIND_FWD,	///< 3 hops: forwarded to owner, data from owner
+	COH_KIND_INV,	///< data from home, invalidation acks from sharers
+	COH_NUM_KINDS
+};
+
+/// directory states
+enum coh_state {
+	DIR_I,			///< no cached copy
+	DIR_S,			///< shared by sharers
+	DIR_M			///< modified by owner
+};
+
+///////////////////////////////////////////
+/// \brief outstanding miss at requester (MSHR)
+///////////////////////////////////////////
+struct coh_miss {
+	bool write;			///< write miss (GETX)
+	ULL  issue;			///< cycle miss was issued
+	bool data;			///< data received
+	int  acks_needed;	///< acks to wait for (known with data)
+	int  acks;			///< acks received
+	UI   data_src;		///< tile data came from
+	ULL  data_time;		///< cycle data arrived
+};
+
+///////////////////////////////////////////
+/// \brief directory entry of block at its home
+///////////////////////////////////////////
+struct coh_dir_entry {
+	coh_state state;					///< directory state
+	bitset<MAX_NUM_TILES> sharers;		///< sharers (DIR_S)
+	UI   owner;							///< owner (DIR_M)
+	bool busy;							///< waiting for unblock of present miss
+	deque< pair<UI, int> > waiting;		///< queued requests (requester, message) while busy
+	
+	/// directory entry constructor
+	coh_dir_entry() {
+		state = DIR_I;
+		owner = 0;
+		busy = false;
+	};
+};
+
+///////////////////////////////////////////
+/// \brief message waiting to be sent
+///////////////////////////////////////////
+struct coh_out {
+	ULL ready;		///< cycle message may leave
+	ULL seq;		///< order of messages with same ready cycle
+	UI  dst;		///< destination tile
+	int msg;		///< coh_msg
+	UI  aux;		///< auxiliary tile or count
+	UI  block;		///< block address
+	
+	/// order for priority queue (earliest first)
+	bool operator > (const coh_out &other) const {
+		return (ready != other.ready) ? ready > other.ready : seq > other.seq;
+	};
+};
+
+///////////////////////////////////////////
+/// \brief timing of miss for latency breakdown (shared by all tiles)
+///////////////////////////////////////////
+struct coh_timing {
+	ULL home_arrive;	///< request reached home
+	ULL home_start;		///< home started request (after waiting for busy block)
+	ULL home_send;		///< home sent data, forward or invalidations
+};
+
+//////////////////////////////////////////////////////////////
+/// \brief Module to define cache-coherence traffic model
+///
+/// - Module derived from ipcore
+/// - every tile holds a private cache and home directory of blocks
+///   with (block % num_tiles) == tileID; MSI protocol with blocking directory
+/// - each cycle, core misses with probability MISS_RATE while it has a free MSHR
+/// - control messages are single (HDT) flits, data messages DATA_FLITS flits
+/// - miss latency (round trip) is split into request, directory wait,
+///   directory/memory, data (incl. forward) and invalidation parts
+/// - configuration in config/traffic/tile-N:
+///   MISS_RATE, WRITE_FRACTION, MSHRS, SHARED_FRACTION, SHARED_BLOCKS, PRIVATE_BLOCKS,
+///   CACHE_BLOCKS, DIR_LATENCY, MEM_LATENCY, DATA_FLITS, FLIT_INTERVAL
+/////////////////////////////////////////////////////////////
+struct Coherence : public ipcore {
+	
+	/// Constructor
+	SC_CTOR(Coherence);
+	
+	// PROCESSES /////////////////////////////////////////////////////
+	void send_app();			///< issue misses and send protocol messages
+	void recv_app();			///< recieve protocol messages
+	void init_app();			///< read configuration
+	void report(ofstream &out);	///< write miss latency breakdown and message mix
+	// PROCESSES END /////////////////////////////////////////////////////
+	
+	// FUNCTIONS /////////////////////////////////////////////////////
+	void issue_miss();			///< pick block and send request to its home
+	void send_msg(UI dst, int msg, UI aux, UI block, ULL delay);	///< queue protocol message
+	void handle(UI src, int msg, UI aux, UI block);	///< process received message
+	void home_request(UI requester, int msg, UI block);	///< accept request at home directory (queued while block is busy)
+	void home_serve(UI requester, int msg, UI block);	///< serve request at home directory
+	void complete_miss(UI block);	///< finish miss whose data and acks have arrived
+	void cache_insert(UI block, bool modified);	///< install block in private cache
+	void cache_remove(UI block);	///< remove block from private cache
+	// FUNCTIONS END /////////////////////////////////////////////////////
+	
+	// VARIABLES /////////////////////////////////////////////////////
+	double miss_rate;			///< probability of miss per cycle
+	double write_fraction;		///< fraction of write misses
+	UI mshrs;					///< largest number of outstanding misses
+	double shared_fraction;		///< fraction of misses to shared blocks
+	UI shared_blocks;			///< number of shared blocks (addresses 0 .. shared_blocks - 1)
+	UI private_blocks;			///< number of private blocks of each core
+	UI cache_blocks;			///< capacity of private cache (in blocks)
+	ULL dir_latency;			///< directory access time (in cycles)
+	ULL mem_latency;			///< additional memory access time if no cache holds block
+	int data_flits;				///< size of data messages (in flits)
+	int flit_interval;			///< inter-flit interval (in clock cycles)
+	
+	map<UI, coh_miss> mshr;		///< outstanding misses by block
+	map<UI, bool> cache;		///< cached blocks, true if modified
+	vector<UI> cache_list;		///< cached blocks for random replacement
+	map<UI, UI> cache_pos;		///< position of block in cache_list
+	map<UI, coh_dir_entry> dir;	///< directory of home blocks
+	priority_queue<coh_out, vector<coh_out>, greater<coh_out> > out;	///< messages waiting to be sent
+	ULL out_seq;				///< sequence number of next message
+	UI busy_entries;			///< directory entries waiting for unblock
+	// VARIABLES END /////////////////////////////////////////////////////
+};
+
+#endif
@@ -0,0 +1,423 @@
+
+/*
+ * Collective.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * Author: Lavina Jain
+ *
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file Collective.cpp
+/// \brief Implements collective communication workloads (all-reduce, all-to-all, broadcast)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Collective.h"
+#include "../../config/extern.h"
+
+extern string app_libname[MAX_NUM_TILES];
+
+// statistics shared by all ranks
+static vector<ULL> iter_start;		///< first start of each iteration over all ranks
+static vector<ULL> iter_finish;		///< last finish of each iteration over all ranks
+static vector<UI>  iter_ranks_done;	///< ranks that finished each iteration
+static bool reported = false;		///< results are written once for all ranks
+
+static const char *coll_names[] = {"RING_ALLREDUCE", "RD_ALLREDUCE", "MESH_ALLREDUCE", "ALLTOALL", "BROADCAST", "REDUCE"};
+
+/// returns a / b rounded up, at least 1
+#define coll_chunk(a, b) (((a) + (b) - 1) / (b) < 1 ? 1 : ((a) + (b) - 1) / (b))
+
+////////////////////////////////////////////////
+/// Constructor
+////////////////////////////////////////////////
+Collective::Collective(sc_module_name Collective): ipcore(Collective) {
+	algorithm = COLL_RING_ALLREDUCE;
+	msg_flits = 64;
+	packet_flits = 8;
+	iterations = 1;
+	dependent = true;
+	combine_cycles = 0;
+	root = 0;
+	mcast = MCAST_NONE;
+	reduction = MCAST_REDUCE_END;
+	flit_interval = 1;
+	rank = 0;
+	next_send = 0;
+	done_steps = 0;
+	ready_at = 0;
+}
+
+////////////////////////////////////////////////
+/// Method to read configuration of tile and build schedule
+////////////////////////////////////////////////
+void Collective::init_app() {
+	// open traffic config file
+	char str_id[4];
+	sprintf(str_id, "%d", tileID);
+	string traffic_filename = string("config/traffic/tile-") + string(str_id);
+	ifstream instream;
+	instream.open(traffic_filename.c_str());
+
+	while(!instream.eof()) {
+		string field;
+		instream >> field;
+		if(field == "ALGORITHM") {
+			string value; instream >> value;
+			for(UI a = COLL_RING_ALLREDUCE; a <= COLL_REDUCE; a++)
+				if(value == coll_names[a])
+					algorithm = (coll_algorithm)a;
+		}
+		else if(field == "MSG_FLITS") {
+			UI value; instream >> value; msg_flits = (value < 1) ? 1 : value;
+		}
+		else if(field == "PACKET_FLITS") {
+			UI value; instream >> value; packet_flits = (value < 1) ? 1 : value;
+		}
+		else if(field == "ITERATIONS") {
+			UI value; instream >> value; iterations = value;
+		}
+		else if(field == "DEPENDENT") {
+			UI value; instream >> value; dependent = (value != 0);
+		}
+		else if(field == "COMBINE_CYCLES") {
+			ULL value; instream >> value; combine_cycles = value;
+		}
+		else if(field == "ROOT") {
+			UI value; instream >> value; root = value;
+		}
+		else if(field == "MULTICAST") {
+			string value; instream >> value;
+			if(!parse_mcast_mode(value, mcast))
+				cout<<"Collective: unknown MULTICAST "<<value<<endl;
+		}
+		else if(field == "REDUCTION") {
+			string value; instream >> value;
+			if(!parse_mcast_mode(value, reduction) || !mcast_reduction(reduction)) {
+				cout<<"Collective: unknown REDUCTION "<<value<<endl;
+				reduction = MCAST_REDUCE_END;
+			}
+		}
+		else if(field == "FLIT_INTERVAL") {	// read inter-flit interval
+			int value; instream >> value; flit_interval = value;
+		}
+	}
+	instream.close();
+	
+	// ranks are tiles running this library
+	for(UI i = 0; i < num_tiles; i++) {
+		if(app_libname[i] != app_libname[tileID])
+			continue;
+		if(i == tileID)
+			rank = ranks.size();
+		ranks.push_back(i);
+	}
+	build_schedule();
+	if(iter_start.size() < iterations) {
+		iter_start.resize(iterations, 0);
+		iter_finish.resize(iterations, 0);
+		iter_ranks_done.resize(iterations, 0);
+	}
+	
+	if(LOG >= 1)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" collective "<<coll_names[algorithm]
+		        <<" rank "<<rank<<" of "<<ranks.size()<<", "<<steps.size()<<" steps";
+}
+
+////////////////////////////////////////////////
+/// Method to append ring steps
+/// \param ring tiles of ring in order
+/// \param pos position of this tile in ring
+/// \param chunk flits sent in each step
+/// \param num_steps number of steps
+/// \param reduce received data is combined
+////////////////////////////////////////////////
+void Collective::add_ring(const vector<UI> &ring, UI pos, UI chunk, UI num_steps, bool reduce) {
+	if(ring.size() < 2)
+		return;
+	for(UI s = 0; s < num_steps; s++) {
+		coll_step step;
+		step.sends.push_back(pair<UI, UI>(ring[(pos + 1) % ring.size()], chunk));
+		step.recv_flits = chunk;
+		step.reduce = reduce;
+		step.multicast = false;
+		steps.push_back(step);
+	}
+}
+
+////////////////////////////////////////////////
+/// Method to append exchange step
+/// \param partner tile to exchange with
+/// \param flits flits sent to and received from partner
+/// \param reduce received data is combined
+////////////////////////////////////////////////
+void Collective::add_exchange(UI partner, UI flits, bool reduce) {
+	coll_step step;
+	step.sends.push_back(pair<UI, UI>(partner, flits));
+	step.recv_flits = flits;
+	step.reduce = reduce;
+	step.multicast = false;
+	steps.push_back(step);
+}
+
+////////////////////////////////////////////////
+/// Method to build steps of this rank for one iteration
+/// - MESH_ALLREDUCE needs all tiles as ranks, RD_ALLREDUCE a power of two
+///   ranks, otherwise RING_ALLREDUCE is used
+////////////////////////////////////////////////
+void Collective::build_schedule() {
+	UI P = ranks.size();
+	steps.clear();
+	if(P < 2)
+		return;
+	
+	if(algorithm == COLL_MESH_ALLREDUCE && P != num_tiles) {
+		cout<<"Collective: MESH_ALLREDUCE needs all tiles, using RING_ALLREDUCE"<<endl;
+		algorithm = COLL_RING_ALLREDUCE;
+	}
+	if(algorithm == COLL_RD_ALLREDUCE && (P & (P - 1)) != 0) {
+		cout<<"Collective: RD_ALLREDUCE needs power of two ranks, using RING_ALLREDUCE"<<endl;
+		algorithm = COLL_RING_ALLREDUCE;
+	}
+	
+	switch(algorithm) {
+		case COLL_RING_ALLREDUCE:
+			add_ring(ranks, rank, coll_chunk(msg_flits, P), P - 1, true);	// reduce-scatter
+			add_ring(ranks, rank, coll_chunk(msg_flits, P), P - 1, false);	// all-gather
+			break;
+		case COLL_RD_ALLREDUCE:
+			for(UI k = 1; k < P; k <<= 1)
+				add_exchange(ranks[rank ^ k], msg_flits, true);
+			break;
+		case COLL_MESH_ALLREDUCE: {
+			vector<UI> row, col;
+			UI r = tileID / num_cols, c = tileID % num_cols;
+			for(UI j = 0; j < num_cols; j++)
+				row.push_back(r * num_cols + j);
+			for(UI i = 0; i < num_rows; i++)
+				col.push_back(i * num_cols + c);
+			UI row_chunk = coll_chunk(msg_flits, num_cols);
+			UI col_chunk = coll_chunk(row_chunk, num_rows);
+			add_ring(row, c, row_chunk, num_cols - 1, true);	// reduce-scatter in row
+			add_ring(col, r, col_chunk, num_rows - 1, true);	// all-reduce of own part in column
+			add_ring(col, r, col_chunk, num_rows - 1, false);
+			add_ring(row, c, row_chunk, num_cols - 1, false);	// all-gather in row
+			break;
+		}
+		case COLL_ALLTOALL:
+			for(UI k = 1; k < P; k++) {
+				coll_step step;
+				step.sends.push_back(pair<UI, UI>(ranks[(rank + k) % P], coll_chunk(msg_flits, P)));
+				step.recv_flits = coll_chunk(msg_flits, P);
+				step.reduce = false;
+				step.multicast = false;
+				steps.push_back(step);
+			}
+			break;
+		case COLL_BROADCAST: {
+			UI v = (rank + P - root % P) % P;	// rank relative to root
+			if(mcast != MCAST_NONE) {	// root reaches all ranks at once
+				coll_step step;
+				step.recv_flits = (v == 0) ? 0 : msg_flits;
+				step.reduce = false;
+				step.multicast = true;
+				if(v == 0)
+					for(UI i = 0; i < P; i++)
+						if(i != rank)
+							step.sends.push_back(pair<UI, UI>(ranks[i], msg_flits));
+				steps.push_back(step);
+				break;
+			}
+			for(UI k = 1; k < P; k <<= 1) {
+				coll_step step;
+				step.recv_flits = (v >= k && v < 2 * k) ? msg_flits : 0;
+				step.reduce = false;
+				step.multicast = false;
+				if(v < k && v + k < P)
+					step.sends.push_back(pair<UI, UI>(ranks[(v + k + root) % P], msg_flits));
+				steps.push_back(step);
+			}
+			break;
+		}
+		case COLL_REDUCE: {	// root gets one combined copy per packet if routers reduce
+			coll_step step;
+			bool is_root = (rank == root % P);
+			step.recv_flits = !is_root ? 0 : (reduction == MCAST_REDUCE) ? msg_flits : (P - 1) * msg_flits;
+			step.reduce = true;
+			step.multicast = false;
+			if(!is_root)
+				step.sends.push_back(pair<UI, UI>(ranks[root % P], msg_flits));
+			steps.push_back(step);
+			break;
+		}
+	}
+}
+
+////////////////////////////////////////////////
+/// Method to send packets of step
+/// \param global_step index of step over all iterations
+////////////////////////////////////////////////
+void Collective::send_step(ULL global_step) {
+	coll_step &step = steps[global_step % steps.size()];
+	if(algorithm == COLL_REDUCE && !step.sends.empty()) {	// packet k of every rank is reduced together
+		tile_set members;
+		for(UI i = 0; i < ranks.size(); i++)
+			members.set(ranks[i]);
+		UI per_msg = coll_chunk(step.sends[0].second, packet_flits);
+		UI k = 0;
+		for(UI left = step.sends[0].second; left > 0; k++) {
+			UI size = (left < packet_flits) ? left : packet_flits;
+			enqueue_reduction(step.sends[0].first, members, size, COLL_MSG, (int)global_step, (UI)(global_step * per_msg + k), reduction);
+			left -= size;
+		}
+		return;
+	}
+	if(step.multicast && !step.sends.empty()) {
+		tile_set dsts;
+		for(UI i = 0; i < step.sends.size(); i++)
+			dsts.set(step.sends[i].first);
+		for(UI left = step.sends[0].second; left > 0; ) {
+			UI size = (left < packet_flits) ? left : packet_flits;
+			enqueue_multicast(dsts, size, COLL_MSG, (int)global_step, mcast);
+			left -= size;
+		}
+		return;
+	}
+	for(UI i = 0; i < step.sends.size(); i++) {
+		for(UI left = step.sends[i].second; left > 0; ) {
+			UI size = (left < packet_flits) ? left : packet_flits;
+			enqueue_packet(step.sends[i].first, size, COLL_MSG, (int)global_step);
+			left -= size;
+		}
+	}
+}
+
+////////////////////////////////////////////////
+/// Thread sensitive to clock
+/// - inherited from ipcore
+/// - send next step when allowed: dependent steps wait for data of previous
+///   step and its combining, next iteration waits for previous one
+/// - complete steps in order as their data arrives
+/// - inject one flit per flit_interval from injection queue
+////////////////////////////////////////////////
+void Collective::send_app() {
+	wait(WARMUP);	// wait for WARMUP period
+	init_app();
+	ULL next_inject = sim_count;
+	ULL total = (ULL)iterations * steps.size();
+	
+	while(true) {
+		while(next_send < total && sim_count >= ready_at && !inj_queue_full()
+		      && (dependent ? next_send <= done_steps : next_send / steps.size() <= done_steps / steps.size())) {
+			UI iter = next_send / steps.size();
+			if(next_send % steps.size() == 0 && (iter_start[iter] == 0 || sim_count < iter_start[iter]))
+				iter_start[iter] = sim_count;
+			send_step(next_send);
+			next_send++;
+		}
+		
+		while(done_steps < next_send && recv_count[done_steps] >= steps[done_steps % steps.size()].recv_flits) {
+			coll_step &step = steps[done_steps % steps.size()];
+			if(step.reduce)
+				ready_at = sim_count + combine_cycles * step.recv_flits;
+			recv_count.erase(done_steps);
+			done_steps++;
+			if(done_steps % steps.size() == 0) {	// iteration finished at this rank
+				UI iter = done_steps / steps.size() - 1;
+				ULL finish = (ready_at > sim_count) ? ready_at : sim_count;
+				if(finish > iter_finish[iter])
+					iter_finish[iter] = finish;
+				iter_ranks_done[iter]++;
+			}
+		}
+		
+		// inject front flit of queue, flits of one packet are flit_interval apart
+		inject_step(next_inject, flit_interval);
+		
+		send_finished = (done_steps >= total) && inj_queue.empty();
+		wait();
+	}
+}
+
+////////////////////////////////////////////////
+/// Thread sensitive to clock and inport event
+/// - inherited from ipcore
+/// - every flit counts towards its step
+////////////////////////////////////////////////
+void Collective::recv_app() {
+	wait();	// wait until inport event
+	if(!flit_inport.event())
+		return;
+	flit flit_recd = flit_inport.read();	// read incoming flit
+	int cmd, global_step;
+	get_payload(flit_recd, cmd, global_step);
+	if(cmd != COLL_MSG || global_step < 0)
+		return;
+	recv_count[global_step]++;
+}
+
+////////////////////////////////////////////////
+/// Method to write completion time and bandwidth
+/// \param out results file
+/// - bus bandwidth scales algorithm bandwidth by data each rank must move:
+///   2(P-1)/P for all-reduce, (P-1)/P for all-to-all, 1 for broadcast and reduce
+////////////////////////////////////////////////
+void Collective::report(ofstream &out) {
+	if(reported)
+		return;
+	reported = true;
+	
+	UI P = ranks.size();
+	UI done = 0;
+	ULL total = 0, min_time = 0, max_time = 0;
+	for(UI i = 0; i < iter_start.size(); i++) {
+		if(iter_ranks_done[i] < P)
+			continue;
+		ULL t = iter_finish[i] - iter_start[i];
+		if(done == 0 || t < min_time)
+			min_time = t;
+		if(t > max_time)
+			max_time = t;
+		total += t;
+		done++;
+	}
+	out<<"\nCollective "<<coll_names[algorithm]<<" on "<<P<<" ranks, "<<msg_flits<<" flits per rank"<<(dependent ? "" : " (steps overlapped)");
+	if(algorithm == COLL_BROADCAST && mcast != MCAST_NONE)
+		out<<" (multicast "<<((mcast == MCAST_TREE) ? "TREE" : (mcast == MCAST_UNICAST) ? "UNICAST" : "PATH")<<")";
+	if(algorithm == COLL_REDUCE)
+		out<<((reduction == MCAST_REDUCE) ? " (in-network reduction)" : " (end-point reduction)");
+	out<<endl;
+	out<<"Collectives completed                                          = "<<done<<" of "<<iterations<<endl;
+	if(done == 0)
+		return;
+	double avg = (double)total / done;
+	double factor = 1.0;
+	if(algorithm == COLL_ALLTOALL)
+		factor = (double)(P - 1) / P;
+	else if(algorithm != COLL_BROADCAST && algorithm != COLL_REDUCE)
+		factor = 2.0 * (P - 1) / P;
+	double bytes = (double)msg_flits * FLITSIZE;
+	double algbw = (avg > 0.0) ? bytes * 8 / (avg * CLK_PERIOD) : 0.0;	// Gbps
+	out<<"Completion time                   (in clock cycles)            = avg "<<avg<<" , min "<<min_time<<" , max "<<max_time<<endl;
+	out<<"Algorithm bandwidth               (in Gbps)                    = "<<algbw<<endl;
+	out<<"Bus bandwidth                     (in Gbps)                    = "<<algbw * factor<<endl;
+}
+
+// for dynamic linking
+extern "C" {
+ipcore *maker() {
+	return new Collective("Collective");
+}
+}
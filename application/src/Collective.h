@@ -0,0 +1,125 @@
+
+/*
+ * Collective.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * Author: Lavina Jain
+ *
+ */
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file Collective.h
+/// \brief Defines collective communication workloads (all-reduce, all-to-all, broadcast)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Collective_H_
+#define _Collective_H_
+
+#include "../../core/ipcore.h"
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+
+/// required for stl
+using namespace std;
+
+/// command field of collective packets, data field holds global step index
+#define COLL_MSG	1
+
+/// collective algorithms
+enum coll_algorithm {
+	COLL_RING_ALLREDUCE,	///< reduce-scatter and all-gather around ring of all ranks
+	COLL_RD_ALLREDUCE,		///< recursive doubling, full message exchanged with partner rank ^ 2^k
+	COLL_MESH_ALLREDUCE,	///< ring reduce-scatter in rows, ring all-reduce in columns, ring all-gather in rows
+	COLL_ALLTOALL,			///< pairwise exchange, step k sends to rank + k
+	COLL_BROADCAST,			///< binomial tree from root
+	COLL_REDUCE				///< all ranks send to root, combined by root or by routers
+};
+
+///////////////////////////////////////////
+/// \brief one step of collective at a rank
+///////////////////////////////////////////
+struct coll_step {
+	vector< pair<UI, UI> > sends;	///< (destination tile, flits) sent in step
+	UI   recv_flits;				///< flits to receive in step
+	bool reduce;					///< received data is combined (reduction step)
+	bool multicast;					///< sends form one multicast to all their destinations
+};
+
+//////////////////////////////////////////////////////////////
+/// \brief Module to define collective communication workload
+///
+/// - Module derived from ipcore
+/// - ranks are all tiles running same library, in order of tile id
+/// - each rank follows schedule of steps of chosen ALGORITHM; with DEPENDENT 1
+///   (default) step is sent after all data of previous step arrived and was
+///   combined (COMBINE_CYCLES per received flit), with DEPENDENT 0 all steps of
+///   an iteration are sent at once (overlapped implementation)
+/// - MSG_FLITS is data of each rank, sends are split in packets of PACKET_FLITS
+/// - BROADCAST with MULTICAST TREE|PATH|UNICAST is a single step, root sends each
+///   packet once to all ranks with hardware multicast (or unicast emulation of it)
+/// - REDUCE is a single step to root, with REDUCTION REDUCE routers combine packets
+///   of all ranks on the way, with REDUCTION REDUCE_END (default) root gets all of them
+/// - completion time of each iteration (first start to last finish over all ranks),
+///   algorithm and bus bandwidth are written to results
+/// - configuration in config/traffic/tile-N (same on all ranks):
+///   ALGORITHM RING_ALLREDUCE|RD_ALLREDUCE|MESH_ALLREDUCE|ALLTOALL|BROADCAST|REDUCE,
+///   MSG_FLITS, PACKET_FLITS, ITERATIONS, DEPENDENT, COMBINE_CYCLES, ROOT, MULTICAST,
+///   REDUCTION, FLIT_INTERVAL
+/////////////////////////////////////////////////////////////
+struct Collective : public ipcore {
+	
+	/// Constructor
+	SC_CTOR(Collective);
+	
+	// PROCESSES /////////////////////////////////////////////////////
+	void send_app();			///< send steps of collective
+	void recv_app();			///< recieve data of steps
+	void init_app();			///< read configuration and build schedule
+	void report(ofstream &out);	///< write completion time and bandwidth
+	// PROCESSES END /////////////////////////////////////////////////////
+	
+	// FUNCTIONS /////////////////////////////////////////////////////
+	/// append steps sending chunk to next rank of ring and receiving from previous
+	void add_ring(const vector<UI> &ring, UI pos, UI chunk, UI num_steps, bool reduce);
+	/// append step exchanging flits with one partner
+	void add_exchange(UI partner, UI flits, bool reduce);
+	void build_schedule();		///< build steps of this rank
+	void send_step(ULL global_step);	///< send packets of step
+	// FUNCTIONS END /////////////////////////////////////////////////////
+	
+	// VARIABLES /////////////////////////////////////////////////////
+	coll_algorithm algorithm;	///< collective algorithm
+	UI  msg_flits;				///< data of each rank (in flits)
+	UI  packet_flits;			///< largest packet size (in flits)
+	UI  iterations;				///< number of collectives run back to back
+	bool dependent;				///< step waits for previous step
+	ULL combine_cycles;			///< cycles to combine one received flit
+	UI  root;					///< root rank of broadcast
+	UI  mcast;					///< multicast mode of broadcast (MCAST_NONE - binomial tree of unicasts)
+	UI  reduction;				///< reduction mode of REDUCE (MCAST_REDUCE or MCAST_REDUCE_END)
+	int flit_interval;			///< inter-flit interval (in clock cycles)
+	
+	vector<UI> ranks;			///< tiles taking part, rank is index
+	UI  rank;					///< rank of this tile
+	vector<coll_step> steps;	///< schedule of one iteration
+	ULL next_send;				///< global index of next step to send
+	ULL done_steps;				///< global steps whose data has arrived
+	ULL ready_at;				///< cycle combining of received data finishes
+	map<ULL, UI> recv_count;	///< flits received for each global step
+	// VARIABLES END /////////////////////////////////////////////////////
+};
+
+#endif
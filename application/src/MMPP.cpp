@@ -0,0 +1,244 @@
+/*
+ * MMPP.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file MMPP.cpp
+/// \brief Implements Markov-modulated Poisson process traffic generator
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MMPP.h"
+#include "../../config/extern.h"
+
+////////////////////////////////////////////////
+/// Constructor
+////////////////////////////////////////////////
+MMPPTraffic::MMPPTraffic(sc_module_name MMPPTraffic) : TrafficGenerator(MMPPTraffic) {
+	pkt_flits = 5;
+	state = 0;
+	state_end = 0.0;
+	cur = 0.0;
+	idle = false;
+	dst_type = "RANDOM";
+}
+
+////////////////////////////////////////////////
+/// Method to prepare MMPP traffic source
+/// - read traffic configuration file (STATES first, it sizes the other fields)
+/// - build transition tables
+/// - find states from which no state with positive rate is reachable
+/// - pick first state with probability proportional to its mean sojourn
+////////////////////////////////////////////////
+void MMPPTraffic::init_source() {
+	// open traffic config file
+	char str_id[4];
+	sprintf(str_id, "%d", tileID);
+	string traffic_filename = string("config/traffic/tile-") + string(str_id);
+	ifstream instream;
+	instream.open(traffic_filename.c_str());
+
+	// number of states sizes the other fields, so it is read first
+	UI k = 0;
+	while(!instream.eof()) {
+		string field;
+		instream >> field;
+		if(field == "STATES")
+			instream >> k;
+	}
+	if(k == 0)
+		cout<<traffic_filename<<": STATES missing or 0, tile is idle"<<endl;
+	instream.clear();
+	instream.seekg(0, ios::beg);
+	
+	vector<double> rates(k, 0.0), weights;
+	state_hold.assign(k, 1.0);
+	while(!instream.eof()) {
+		string field;
+		instream >> field;
+		if(field == "STATES") {
+			UI value; instream >> value;
+		}
+		else if(field == "STATE_RATES") {	// flits per cycle in each state
+			for(UI i = 0; i < k; i++)
+				instream >> rates[i];
+		}
+		else if(field == "STATE_HOLD") {	// mean sojourn in cycles
+			for(UI i = 0; i < k; i++)
+				instream >> state_hold[i];
+		}
+		else if(field == "TRANSITIONS") {	// row i: weights of moving from state i
+			weights.assign(k * k, 0.0);
+			for(UI i = 0; i < k * k; i++)
+				instream >> weights[i];
+		}
+		else if(field == "PKT_FLITS") {
+			int value; instream >> value; pkt_flits = value;
+		}
+		else if(field == "DESTINATION") {
+			instream >> dst_type;	// read destination type
+			if(dst_type == "FIXED") {	// if fixed destination, read destination tileID or route code
+				int value; instream >> value; route_info = value;
+			}
+		}
+		else if(field == "FLIT_INTERVAL") {	// read inter-flit interval
+			int value; instream >> value; flit_interval = value;
+		}
+	}
+	instream.close();
+	
+	if(pkt_flits < 1)
+		pkt_flits = 1;
+	num_flits = pkt_flits;
+	
+	// packet rates and transition tables, self transitions are dropped
+	idle = true;
+	state_rate.assign(k, 0.0);
+	transitions.assign(k, alias_table());
+	vector<vector<double> > rows(k);
+	for(UI i = 0; i < k; i++) {
+		state_rate[i] = rates[i] / pkt_flits;
+		if(state_rate[i] > 0.0)
+			idle = false;
+		if(state_hold[i] < 1.0)
+			state_hold[i] = 1.0;
+		vector<double> row(k, 1.0);
+		if(!weights.empty())
+			row.assign(weights.begin() + i * k, weights.begin() + (i + 1) * k);
+		row[i] = 0.0;
+		transitions[i].build(row);
+		rows[i] = row;
+	}
+	
+	// silent states that cannot reach a state with positive rate would never
+	// return a packet, tile goes idle once it enters one of them
+	state_live.assign(k, false);
+	for(UI i = 0; i < k; i++)
+		state_live[i] = (state_rate[i] > 0.0);
+	for(bool changed = true; changed; ) {
+		changed = false;
+		for(UI i = 0; i < k; i++) {
+			if(state_live[i])
+				continue;
+			for(UI j = 0; j < k; j++) {
+				if(rows[i][j] > 0.0 && state_live[j]) {
+					state_live[i] = true;
+					changed = true;
+					break;
+				}
+			}
+		}
+	}
+	for(UI i = 0; i < k; i++) {
+		if(!state_live[i])
+			cout<<traffic_filename<<": state "<<i<<" has rate 0 and never leads to a state with positive rate, tile is idle once it is entered"<<endl;
+	}
+	if(num_tiles < 2)
+		idle = true;
+	
+	if(LOG >= 1)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" MMPP states "<<k<<(idle ? " idle" : "");
+	
+	// export of generated pattern (optional)
+	open_export();
+	
+	if(idle)
+		return;
+	alias_table first;
+	first.build(state_hold);
+	state = first.sample(ran_var);
+	state_end = ran_var->exponential(state_hold[state]);
+	cur = next_event();
+	if(cur < 0.0) {
+		idle = true;
+		return;
+	}
+	sched_time += (ULL)cur;
+}
+
+////////////////////////////////////////////////
+/// Method to move to next state
+/// - state without outgoing transitions is renewed
+////////////////////////////////////////////////
+void MMPPTraffic::next_state() {
+	if(!transitions[state].empty())
+		state = transitions[state].sample(ran_var);
+	state_end += ran_var->exponential(state_hold[state]);
+}
+
+////////////////////////////////////////////////
+/// Method to find next packet
+/// \return time of packet (relative to start of generation),
+/// negative if chain has entered a state that never leads to traffic
+/// - arrivals are memoryless, so arrival drawn past end of state is
+///   discarded and drawn again in next state
+////////////////////////////////////////////////
+double MMPPTraffic::next_event() {
+	double t = cur;
+	while(true) {
+		if(!state_live[state])
+			return -1.0;
+		if(state_rate[state] > 0.0) {
+			double a = t + ran_var->exponential(1.0 / state_rate[state]);
+			if(a < state_end)
+				return a;
+		}
+		t = state_end;
+		next_state();
+	}
+}
+
+////////////////////////////////////////////////
+/// Method to generate next packet
+/// \return false if tile does not generate traffic
+////////////////////////////////////////////////
+bool MMPPTraffic::next_packet() {
+	if(idle)
+		return false;
+	double interval = next_interval();
+	if(interval < 0.0) {
+		idle = true;
+		return false;
+	}
+	next_pkt_time = (int)interval;
+	if(dst_type == "RANDOM")
+		route_info = get_random_dest();		// get random destination
+	export_packet();
+	return true;
+}
+
+////////////////////////////////////////////////
+/// Method to return inter-packet interval
+/// \return negative if no further packet is generated
+////////////////////////////////////////////////
+double MMPPTraffic::next_interval() {
+	double next = next_event();
+	if(next < 0.0)
+		return next;
+	double t = (double)((ULL)next - (ULL)cur);
+	cur = next;
+	return t;
+}
+
+// for dynamic linking
+extern "C" {
+	ipcore *maker() {
+		return new MMPPTraffic("MMPP");
+	}
+}
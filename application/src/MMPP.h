@@ -0,0 +1,74 @@
+/*
+ * MMPP.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file MMPP.h
+/// \brief Defines Markov-modulated Poisson process traffic generator
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _MMPP_
+#define _MMPP_
+
+#include "TG.h"
+#include "../../core/alias_table.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////
+/// \brief Module to define MMPP traffic generator
+///
+/// - derived from TrafficGenerator
+/// - tile moves between STATES of a continuous-time Markov chain,
+///   packets are Poisson with rate of present state
+/// - configuration in config/traffic/tile-N:
+///   STATES k, STATE_RATES r1 .. rk (flits/cycle), STATE_HOLD h1 .. hk
+///   (mean sojourn in cycles), TRANSITIONS k x k weights (optional, default
+///   uniform to other states), PKT_FLITS, DESTINATION, FLIT_INTERVAL
+/// - tile stops generating once it enters a state from which no state with
+///   positive rate is reachable
+//////////////////////////////////////////////////////////////////////
+struct MMPPTraffic : public TrafficGenerator {
+
+	/// Constructor
+	SC_CTOR(MMPPTraffic);
+	
+	// PROCESSES /////////////////////////////////////////////////////////
+	void init_source();		///< read traffic configuration
+	bool next_packet();		///< generate next packet
+	double next_interval();	///< returns inter-packet interval
+	double next_event();	///< returns time of next packet
+	void next_state();		///< move to next state of chain
+	// PROCESSES END /////////////////////////////////////////////////////
+	
+	// VARIABLES /////////////////////////////////////////////////////////
+	int pkt_flits;				///< packet size (in flits)
+	vector<double> state_rate;	///< packets per cycle in each state
+	vector<double> state_hold;	///< mean sojourn time of each state (in cycles)
+	vector<alias_table> transitions;	///< sampling table of next state for each state
+	vector<bool> state_live;	///< state with positive rate is reachable from state
+	UI state;					///< present state
+	double state_end;			///< time present state is left
+	double cur;					///< time of present packet (fractional part is kept)
+	bool idle;					///< tile does not generate traffic
+	string dst_type;			///< string to determine wether destination is fixed or random
+	// VARIABLES END /////////////////////////////////////////////////////
+};
+
+#endif
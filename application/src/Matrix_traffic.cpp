@@ -0,0 +1,236 @@
+/*
+ * Matrix_traffic.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file Matrix_traffic.cpp
+/// \brief Implements traffic generator driven by network-wide traffic matrix
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Matrix_traffic.h"
+#include "../../config/extern.h"
+#include <stdio.h>
+
+/////////////////////////////////////////
+/// \brief traffic matrix shared by all tiles
+/////////////////////////////////////////
+struct traffic_matrix {
+	bool loaded;					///< file has been read
+	injection_type injection;		///< injection process of all tiles
+	int flit_interval;				///< inter-flit interval of all tiles
+	vector<UI> sizes;				///< packet sizes (in flits)
+	vector<double> size_weights;	///< weight of each packet size
+	vector< vector<double> > rates;	///< rates[src][dst] in flits/cycle
+};
+
+static traffic_matrix matrix;
+
+////////////////////////////////////////////////
+/// Function to read traffic matrix file
+/// - file is read once, by first tile that starts generating
+/// - MATRIX, FLOW and PROFILE entries add up, SCALE multiplies all rates
+////////////////////////////////////////////////
+static void load_matrix() {
+	if(matrix.loaded)
+		return;
+	matrix.loaded = true;
+	matrix.injection = INJ_BERNOULLI;
+	matrix.flit_interval = 1;
+	matrix.rates.assign(num_tiles, vector<double>(num_tiles, 0.0));
+	double scale = 1.0;
+
+	ifstream instream;
+	instream.open(TRAFFIC_MATRIX.c_str());
+	if(!instream.is_open()) {
+		cout<<"Cannot open "<<TRAFFIC_MATRIX<<", traffic matrix is empty"<<endl;
+		return;
+	}
+
+	string field;
+	while(instream >> field) {
+		if(field[0] == '#') {	// comment up to end of line
+			getline(instream, field);
+		}
+		else if(field == "INJECTION") {
+			string value; instream >> value;
+			matrix.injection = (value == "POISSON") ? INJ_POISSON : INJ_BERNOULLI;
+		}
+		else if(field == "FLIT_INTERVAL") {
+			int value; instream >> value; matrix.flit_interval = value;
+		}
+		else if(field == "SCALE") {
+			double value; instream >> value; scale = value;
+		}
+		else if(field == "SIZE_DIST") {	// number of sizes followed by (size, weight) pairs
+			UI n; instream >> n;
+			matrix.sizes.clear();
+			matrix.size_weights.clear();
+			for(UI i = 0; i < n; i++) {
+				UI size; double weight;
+				instream >> size >> weight;
+				if(size < 1)
+					size = 1;
+				matrix.sizes.push_back(size);
+				matrix.size_weights.push_back(weight);
+			}
+		}
+		else if(field == "MATRIX") {	// dimension followed by dense rows
+			UI n; instream >> n;
+			for(UI src = 0; src < n; src++)
+				for(UI dst = 0; dst < n; dst++) {
+					double value; instream >> value;
+					if(src < num_tiles && dst < num_tiles)
+						matrix.rates[src][dst] += value;
+				}
+			if(n != num_tiles)
+				cout<<TRAFFIC_MATRIX<<": matrix of "<<n<<" tiles used on "<<num_tiles<<" tiles"<<endl;
+		}
+		else if(field == "FLOW") {
+			UI src, dst; double value;
+			instream >> src >> dst >> value;
+			if(src < num_tiles && dst < num_tiles)
+				matrix.rates[src][dst] += value;
+		}
+		else if(field == "PROFILE") {	// stats/flows.csv of earlier run and number of cycles it covers
+			string filename; double cycles;
+			instream >> filename >> cycles;
+			ifstream profile;
+			profile.open(filename.c_str());
+			if(!profile.is_open() || cycles <= 0.0) {
+				cout<<"Cannot open "<<filename<<endl;
+				continue;
+			}
+			string line;
+			getline(profile, line);	// header
+			while(getline(profile, line)) {
+				UI src, dst;
+				ULL packets, flits;
+				if(sscanf(line.c_str(), "%u,%u,%llu,%llu", &src, &dst, &packets, &flits) != 4)
+					continue;
+				if(src < num_tiles && dst < num_tiles)
+					matrix.rates[src][dst] += flits / cycles;
+			}
+			profile.close();
+		}
+		else
+			cout<<TRAFFIC_MATRIX<<": unknown field "<<field<<endl;
+	}
+	instream.close();
+
+	if(matrix.sizes.empty()) {
+		matrix.sizes.push_back(5);
+		matrix.size_weights.push_back(1.0);
+	}
+	for(UI src = 0; src < num_tiles; src++)
+		for(UI dst = 0; dst < num_tiles; dst++)
+			matrix.rates[src][dst] *= scale;
+}
+
+////////////////////////////////////////////////
+/// Constructor
+////////////////////////////////////////////////
+MatrixTraffic::MatrixTraffic(sc_module_name MatrixTraffic) : TrafficGenerator(MatrixTraffic) {
+	rate = 0.0;
+	pkt_rate = 0.0;
+	idle = false;
+}
+
+////////////////////////////////////////////////
+/// Method to prepare traffic matrix source
+/// - read traffic matrix (once for all tiles)
+/// - build alias tables over destinations of tile row and packet sizes
+/// - delay first packet by random inter-arrival time
+////////////////////////////////////////////////
+void MatrixTraffic::init_source() {
+	load_matrix();
+	injection = matrix.injection;
+	flit_interval = matrix.flit_interval;
+
+	// destinations of tile, own tile is skipped
+	vector<double> weights;
+	rate = 0.0;
+	dests.clear();
+	if(tileID < matrix.rates.size()) {
+		for(UI dst = 0; dst < num_tiles; dst++) {
+			double value = matrix.rates[tileID][dst];
+			if(dst == tileID || value <= 0.0)
+				continue;
+			dests.push_back(dst);
+			weights.push_back(value);
+			rate += value;
+		}
+	}
+	dest_table.build(weights);
+
+	// packet size distribution
+	sizes = matrix.sizes;
+	size_table.build(matrix.size_weights);
+	double total = 0.0, mean_flits = 0.0;
+	for(UI i = 0; i < sizes.size(); i++) {
+		if(matrix.size_weights[i] <= 0.0)
+			continue;
+		total += matrix.size_weights[i];
+		mean_flits += matrix.size_weights[i] * sizes[i];
+	}
+	mean_flits = (total > 0.0) ? mean_flits / total : 1.0;
+	pkt_rate = rate / mean_flits;
+	idle = dest_table.empty() || size_table.empty() || pkt_rate <= 0.0;
+
+	if(injection == INJ_BERNOULLI && pkt_rate > 1.0)
+		cout<<"tile "<<tileID<<": matrix rate "<<rate<<" needs more than one packet per cycle, use INJECTION POISSON"<<endl;
+	if(LOG >= 1)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" matrix rate "<<rate
+		        <<" destinations "<<dests.size()<<(idle ? " idle" : "");
+
+	// export of generated pattern (optional)
+	open_export();
+
+	// first packet after random inter-arrival time
+	if(!idle)
+		sched_time += (ULL)next_interval();
+}
+
+////////////////////////////////////////////////
+/// Method to generate next packet
+/// \return false if tile does not generate traffic
+////////////////////////////////////////////////
+bool MatrixTraffic::next_packet() {
+	if(idle)
+		return false;
+	num_flits = sizes[size_table.sample(ran_var)];
+	route_info = dests[dest_table.sample(ran_var)];
+	next_pkt_time = (int)next_interval();
+	export_packet();
+	return true;
+}
+
+////////////////////////////////////////////////
+/// Method to return inter-packet interval
+////////////////////////////////////////////////
+double MatrixTraffic::next_interval() {
+	return random_interval(pkt_rate);
+}
+
+// for dynamic linking
+extern "C" {
+	ipcore *maker() {
+		return new MatrixTraffic("Matrix_traffic");
+	}
+}
@@ -0,0 +1,67 @@
+/*
+ * Matrix_traffic.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file Matrix_traffic.h
+/// \brief Defines traffic generator driven by network-wide traffic matrix
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _MATRIX_TRAFFIC_
+#define _MATRIX_TRAFFIC_
+
+#include "TG.h"
+#include "../../core/alias_table.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////
+/// \brief Module to define traffic matrix generator
+///
+/// - derived from TrafficGenerator
+/// - all tiles share one rate file (TRAFFIC_MATRIX in nirgam.config), no per-tile files:
+///   INJECTION BERNOULLI|POISSON, FLIT_INTERVAL n, SCALE factor,
+///   SIZE_DIST k s1 w1 ... sk wk (packet sizes in flits with weights),
+///   MATRIX n followed by n x n rates (flits/cycle from row tile to column tile),
+///   FLOW src dst rate, PROFILE flows.csv cycles (replay measured flow matrix)
+/// - destination and size of each packet are drawn from alias tables in O(1)
+//////////////////////////////////////////////////////////////////////
+struct MatrixTraffic : public TrafficGenerator {
+
+	/// Constructor
+	SC_CTOR(MatrixTraffic);
+	
+	// PROCESSES /////////////////////////////////////////////////////////
+	void init_source();		///< build alias tables of tile from traffic matrix
+	bool next_packet();		///< generate next packet
+	double next_interval();	///< returns inter-packet interval
+	// PROCESSES END /////////////////////////////////////////////////////
+	
+	// VARIABLES /////////////////////////////////////////////////////////
+	double rate;			///< offered load of tile (flits/cycle), sum of its matrix row
+	double pkt_rate;		///< packets per cycle
+	vector<UI> dests;		///< destinations with non-zero rate
+	alias_table dest_table;	///< sampling table over dests
+	vector<UI> sizes;		///< packet sizes (in flits)
+	alias_table size_table;	///< sampling table over sizes
+	bool idle;				///< tile does not generate traffic
+	// VARIABLES END /////////////////////////////////////////////////////
+};
+
+#endif
@@ -0,0 +1,276 @@
+
+/*
+ * MemCtrl.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * Author: Lavina Jain
+ *
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file MemCtrl.cpp
+/// \brief Implements memory controller with DRAM bank service model
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MemCtrl.h"
+#include "../../config/extern.h"
+
+static bool header_written = false;	///< header of report is written once for all controllers
+
+////////////////////////////////////////////////
+/// Constructor
+////////////////////////////////////////////////
+MemCtrl::MemCtrl(sc_module_name MemCtrl): ipcore(MemCtrl) {
+	banks = 8;
+	row_blocks = 32;
+	row_hit = 14;
+	row_miss = 42;
+	burst_cycles = 4;
+	queue_size = 16;
+	fr_fcfs = true;
+	row_locality = 0.5;
+	mem_blocks = 1 << 20;
+	reply_flits = 5;
+	flit_interval = 1;
+	partial = 0;
+	bus_free = 0;
+	served = 0;
+	row_hits = 0;
+	queue_delay = 0;
+	occupancy = 0;
+	max_occupancy = 0;
+	full_cycles = 0;
+	measured_cycles = 0;
+}
+
+////////////////////////////////////////////////
+/// Method to read configuration of tile
+////////////////////////////////////////////////
+void MemCtrl::init_app() {
+	// open traffic config file
+	char str_id[4];
+	sprintf(str_id, "%d", tileID);
+	string traffic_filename = string("config/traffic/tile-") + string(str_id);
+	ifstream instream;
+	instream.open(traffic_filename.c_str());
+
+	while(!instream.eof()) {
+		string field;
+		instream >> field;
+		if(field == "BANKS") {
+			UI value; instream >> value; banks = value;
+		}
+		else if(field == "ROW_BLOCKS") {
+			UI value; instream >> value; row_blocks = value;
+		}
+		else if(field == "ROW_HIT") {
+			ULL value; instream >> value; row_hit = value;
+		}
+		else if(field == "ROW_MISS") {
+			ULL value; instream >> value; row_miss = value;
+		}
+		else if(field == "BURST_CYCLES") {
+			ULL value; instream >> value; burst_cycles = value;
+		}
+		else if(field == "QUEUE_SIZE") {
+			UI value; instream >> value; queue_size = value;
+		}
+		else if(field == "SCHEDULER") {
+			string value; instream >> value; fr_fcfs = (value != "FCFS");
+		}
+		else if(field == "ROW_LOCALITY") {
+			double value; instream >> value; row_locality = value;
+		}
+		else if(field == "MEM_BLOCKS") {
+			ULL value; instream >> value; mem_blocks = value;
+		}
+		else if(field == "REPLY_FLITS") {
+			int value; instream >> value; reply_flits = value;
+		}
+		else if(field == "FLIT_INTERVAL") {	// read inter-flit interval
+			int value; instream >> value; flit_interval = value;
+		}
+	}
+	instream.close();
+	
+	if(banks < 1)
+		banks = 1;
+	if(row_blocks < 1)
+		row_blocks = 1;
+	if(queue_size < 1)
+		queue_size = 1;
+	if(mem_blocks < 1)
+		mem_blocks = 1;
+	bank_free.assign(banks, 0);
+	open_row.assign(banks, 0);
+	row_open.assign(banks, false);
+	
+	if(LOG >= 1)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" memory controller banks "<<banks
+		        <<" queue "<<queue_size<<(fr_fcfs ? " FRFCFS" : " FCFS");
+}
+
+////////////////////////////////////////////////
+/// Thread sensitive to clock
+/// - inherited from ipcore
+/// - issue one request to its bank, send replies whose data is transferred
+/// - inject one flit per flit_interval from injection queue
+/// - stop accepting flits while queue is full (packets already entering
+///   are completed, so a full queue never splits a packet)
+////////////////////////////////////////////////
+void MemCtrl::send_app() {
+	wait(WARMUP);	// wait for WARMUP period
+	init_app();
+	ULL next_inject = sim_count;
+	
+	while(true) {
+		schedule();
+		
+		while(!replies.empty() && replies.front().ready <= sim_count) {
+			enqueue_packet(replies.front().requester, reply_flits, RR_REPLY, replies.front().tag);
+			replies.pop_front();
+		}
+		
+		// inject front flit of queue, flits of one packet are flit_interval apart
+		inject_step(next_inject, flit_interval);
+		
+		if(in_measure_window(sim_count)) {
+			measured_cycles++;
+			occupancy += queue.size();
+			if(queue.size() >= queue_size)
+				full_cycles++;
+		}
+		eject_ready.write(queue.size() < queue_size || partial > 0);
+		send_finished = queue.empty() && replies.empty() && inj_queue.empty() && partial == 0;
+		wait();
+	}
+}
+
+////////////////////////////////////////////////
+/// Thread sensitive to clock and inport event
+/// - inherited from ipcore
+/// - request enters queue when its last flit arrives, its address
+///   continues stream of requester or is random
+////////////////////////////////////////////////
+void MemCtrl::recv_app() {
+	wait();	// wait until inport event
+	if(!flit_inport.event())
+		return;
+	flit flit_recd = flit_inport.read();	// read incoming flit
+	flit_type type = flit_recd.pkthdr.nochdr.flittype;
+	if(type == HEAD)
+		partial++;
+	if(type != TAIL && type != HDT)
+		return;
+	if(type == TAIL && partial > 0)
+		partial--;
+	int cmd, tag;
+	get_payload(flit_recd, cmd, tag);
+	if(cmd != RR_REQUEST)
+		return;
+	
+	ULL addr;
+	map<UI, ULL>::iterator it = stream.find(flit_recd.src);
+	if(it != stream.end() && ran_var->uniform() < row_locality)
+		addr = it->second % mem_blocks;
+	else
+		addr = (ULL)(ran_var->uniform() * mem_blocks) % mem_blocks;
+	stream[flit_recd.src] = addr + 1;
+	
+	mc_request req;
+	req.requester = flit_recd.src;
+	req.tag = tag;
+	req.bank = (UI)((addr / row_blocks) % banks);
+	req.row = addr / ((ULL)row_blocks * banks);
+	req.arrive = sim_count;
+	queue.push_back(req);
+	if(queue.size() > max_occupancy)
+		max_occupancy = queue.size();
+	send_finished = false;
+}
+
+////////////////////////////////////////////////
+/// Method to issue one queued request to its bank
+/// - FCFS: oldest request, if its bank is free
+/// - FRFCFS: oldest row hit to a free bank, else oldest request to a free bank
+/// - reply is ready when bank access and data transfer on the bus are done
+////////////////////////////////////////////////
+void MemCtrl::schedule() {
+	int pick = -1;
+	for(UI i = 0; i < queue.size(); i++) {
+		mc_request &req = queue[i];
+		if(bank_free[req.bank] > sim_count) {
+			if(!fr_fcfs)
+				break;
+			continue;
+		}
+		if(pick < 0)
+			pick = i;
+		if(!fr_fcfs || (row_open[req.bank] && open_row[req.bank] == req.row)) {
+			pick = i;
+			break;
+		}
+	}
+	if(pick < 0)
+		return;
+	
+	mc_request req = queue[pick];
+	queue.erase(queue.begin() + pick);
+	bool hit = row_open[req.bank] && open_row[req.bank] == req.row;
+	bank_free[req.bank] = sim_count + (hit ? row_hit : row_miss);
+	open_row[req.bank] = req.row;
+	row_open[req.bank] = true;
+	
+	ULL start = (bank_free[req.bank] > bus_free) ? bank_free[req.bank] : bus_free;
+	bus_free = start + burst_cycles;
+	mc_reply rep;
+	rep.requester = req.requester;
+	rep.tag = req.tag;
+	rep.ready = bus_free;
+	replies.push_back(rep);
+	
+	if(in_measure_window(sim_count)) {
+		served++;
+		if(hit)
+			row_hits++;
+		queue_delay += sim_count - req.arrive;
+	}
+	if(LOG >= 3)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" request "<<req.tag<<" from "<<req.requester
+		        <<" bank "<<req.bank<<(hit ? " row hit" : " row miss")<<" reply at "<<rep.ready;
+}
+
+////////////////////////////////////////////////
+/// Method to write service statistics of controller
+/// \param out results file
+////////////////////////////////////////////////
+void MemCtrl::report(ofstream &out) {
+	if(!header_written) {
+		header_written = true;
+		out<<"\nMemory controllers (measured): tile, requests, row hit rate, avg queue delay, avg queue length,"
+		   <<" max queue length, backpressure cycles (%), requests/cycle, reply flits/cycle"<<endl;
+	}
+	double cycles = (measured_cycles == 0) ? 1.0 : (double)measured_cycles;
+	out<<"  "<<tileID<<"\t"<<served<<"\t"<<((served == 0) ? 0.0 : (double)row_hits / served)
+	   <<"\t"<<((served == 0) ? 0.0 : (double)queue_delay / served)<<"\t"<<occupancy / cycles<<"\t"<<max_occupancy
+	   <<"\t"<<full_cycles<<" ("<<100.0 * full_cycles / cycles<<")\t"<<served / cycles<<"\t"<<served * reply_flits / cycles<<endl;
+}
+
+// for dynamic linking
+extern "C" {
+ipcore *maker() {
+	return new MemCtrl("MemCtrl");
+}
+}
@@ -0,0 +1,127 @@
+
+/*
+ * MemCtrl.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * Author: Lavina Jain
+ *
+ */
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file MemCtrl.h
+/// \brief Defines memory controller with DRAM bank service model
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _MemCtrl_H_
+#define _MemCtrl_H_
+
+#include "../../core/ipcore.h"
+#include "ReqReply.h"
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+
+/// required for stl
+using namespace std;
+
+///////////////////////////////////////////
+/// \brief request waiting in memory controller queue
+///////////////////////////////////////////
+struct mc_request {
+	UI  requester;	///< tile to reply to
+	int tag;		///< tag of request
+	UI  bank;		///< DRAM bank
+	ULL row;		///< row in bank
+	ULL arrive;		///< cycle request entered queue
+};
+
+///////////////////////////////////////////
+/// \brief reply waiting for its data transfer to finish
+///////////////////////////////////////////
+struct mc_reply {
+	UI  requester;	///< tile to reply to
+	int tag;		///< tag of request
+	ULL ready;		///< cycle data transfer completes
+};
+
+//////////////////////////////////////////////////////////////
+/// \brief Module to define memory controller
+///
+/// - Module derived from ipcore
+/// - serves RR_REQUEST packets (e.g. from ReqReply requesters with SERVERS
+///   set to memory controller tiles) and replies with RR_REPLY and same tag
+/// - requests wait in a queue of QUEUE_SIZE entries; while it is full the
+///   core stops accepting flits, so requests back up into the network
+/// - one request per cycle is issued to a free bank, FCFS (oldest only) or
+///   FRFCFS (oldest row hit first); bank is busy ROW_HIT or ROW_MISS cycles
+///   (open page policy), then data takes BURST_CYCLES on the shared data bus
+/// - address of request continues stream of its requester with probability
+///   ROW_LOCALITY, else it is random; blocks are interleaved over banks by row
+/// - replies wait in the source queue, which is not bounded here, so backpressure
+///   of requests can never block reply injection (no protocol deadlock)
+/// - configuration in config/traffic/tile-N:
+///   BANKS, ROW_BLOCKS, ROW_HIT, ROW_MISS, BURST_CYCLES, QUEUE_SIZE, SCHEDULER FCFS|FRFCFS,
+///   ROW_LOCALITY, MEM_BLOCKS, REPLY_FLITS, FLIT_INTERVAL
+/////////////////////////////////////////////////////////////
+struct MemCtrl : public ipcore {
+	
+	/// Constructor
+	SC_CTOR(MemCtrl);
+	
+	// PROCESSES /////////////////////////////////////////////////////
+	void send_app();			///< schedule requests and send replies
+	void recv_app();			///< recieve requests
+	void init_app();			///< read configuration
+	void report(ofstream &out);	///< write service statistics
+	// PROCESSES END /////////////////////////////////////////////////////
+	
+	// FUNCTIONS /////////////////////////////////////////////////////
+	void schedule();			///< issue one queued request to its bank
+	// FUNCTIONS END /////////////////////////////////////////////////////
+	
+	// VARIABLES /////////////////////////////////////////////////////
+	UI  banks;					///< number of DRAM banks
+	UI  row_blocks;				///< blocks per row
+	ULL row_hit;				///< bank busy time on row hit (in cycles)
+	ULL row_miss;				///< bank busy time on row miss (in cycles)
+	ULL burst_cycles;			///< data bus time per request (in cycles)
+	UI  queue_size;				///< request queue capacity
+	bool fr_fcfs;				///< row hits first (FRFCFS) instead of oldest only (FCFS)
+	double row_locality;		///< probability that request continues stream of its requester
+	ULL mem_blocks;				///< size of address space (in blocks)
+	int reply_flits;			///< reply size (in flits)
+	int flit_interval;			///< inter-flit interval (in clock cycles)
+	
+	deque<mc_request> queue;	///< request queue, oldest first
+	UI  partial;				///< requests whose flits are still arriving
+	vector<ULL> bank_free;		///< cycle each bank finishes present request
+	vector<ULL> open_row;		///< open row of each bank
+	vector<bool> row_open;		///< bank has open row
+	ULL bus_free;				///< cycle data bus finishes present transfer
+	deque<mc_reply> replies;	///< replies in order of data transfer
+	map<UI, ULL> stream;		///< next address of each requester stream
+	
+	ULL served;					///< requests issued inside measurement window
+	ULL row_hits;				///< row hits among served requests
+	ULL queue_delay;			///< total cycles served requests waited in queue
+	ULL occupancy;				///< sum of queue length over measured cycles
+	ULL max_occupancy;			///< largest queue length
+	ULL full_cycles;			///< measured cycles queue was full (backpressure)
+	ULL measured_cycles;		///< cycles inside measurement window
+	// VARIABLES END /////////////////////////////////////////////////////
+};
+
+#endif
@@ -0,0 +1,161 @@
+
+/*
+ * Message_traffic.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * Author: Lavina Jain
+ *
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file Message_traffic.cpp
+/// \brief Implements message traffic generator using send_message API
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Message_traffic.h"
+#include "../../config/extern.h"
+
+////////////////////////////////////////////////
+/// Constructor
+////////////////////////////////////////////////
+Message_traffic::Message_traffic(sc_module_name Message_traffic): ipcore(Message_traffic) {
+	random_dst = true;
+	dst = 0;
+	msg_bytes = 64;
+	msg_class = 0;
+	msg_interval = 100.0;
+	exponential = false;
+	window = 0;
+	flit_interval = 1;
+	bytes_recv = 0;
+	msg_inbox_on = true;
+}
+
+////////////////////////////////////////////////
+/// Method to read configuration of tile
+////////////////////////////////////////////////
+void Message_traffic::init_app() {
+	// open traffic config file
+	char str_id[4];
+	sprintf(str_id, "%d", tileID);
+	string traffic_filename = string("config/traffic/tile-") + string(str_id);
+	ifstream instream;
+	instream.open(traffic_filename.c_str());
+
+	while(!instream.eof()) {
+		string field;
+		instream >> field;
+		if(field == "DESTINATION") {
+			string value; instream >> value;
+			random_dst = (value != "FIXED");
+			if(!random_dst) {
+				UI id; instream >> id; dst = id;
+			}
+		}
+		else if(field == "MSG_BYTES") {
+			UI value; instream >> value; msg_bytes = value;
+		}
+		else if(field == "MSG_CLASS") {
+			int value; instream >> value; msg_class = value;
+		}
+		else if(field == "MSG_INTERVAL") {
+			double value; instream >> value; msg_interval = value;
+		}
+		else if(field == "EXPONENTIAL") {
+			exponential = true;
+		}
+		else if(field == "WINDOW") {
+			UI value; instream >> value; window = value;
+		}
+		else if(field == "PACKET_FLITS") {
+			UI value; instream >> value; msg_packet_flits = value;
+		}
+		else if(field == "FLIT_INTERVAL") {	// read inter-flit interval
+			int value; instream >> value; flit_interval = value;
+		}
+	}
+	instream.close();
+	
+	if(!random_dst && (dst >= num_tiles || dst == tileID))
+		random_dst = true;
+	
+	if(LOG >= 1)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" message traffic bytes "<<msg_bytes
+		        <<" class "<<msg_class<<" interval "<<msg_interval<<" window "<<window;
+}
+
+////////////////////////////////////////////////
+/// Thread sensitive to clock
+/// - inherited from ipcore
+/// - send message when its interval elapsed and window has room (until TG_NUM)
+/// - forget handles of delivered messages
+/// - read reassembled messages
+/// - inject one flit per flit_interval from injection queue
+////////////////////////////////////////////////
+void Message_traffic::send_app() {
+	wait(WARMUP);	// wait for WARMUP period
+	init_app();
+	ULL next_inject = sim_count;
+	ULL next_msg = sim_count;
+	
+	while(true) {
+		// messages may be delivered out of order (adaptive routing, other destinations)
+		for(deque<UI>::iterator it = undelivered.begin(); it != undelivered.end(); ) {
+			if(message_status(*it) == MSG_DELIVERED)
+				it = undelivered.erase(it);
+			else
+				it++;
+		}
+		
+		if(num_tiles > 1 && sim_count <= TG_NUM && sim_count >= next_msg && !inj_queue_full()
+		   && (window == 0 || undelivered.size() < window)) {
+			UI handle = send_message(random_dst ? get_random_dest() : dst, msg_bytes, msg_class);
+			if(handle != MSG_NO_HANDLE)
+				undelivered.push_back(handle);
+			double gap = exponential ? ran_var->exponential(msg_interval) : msg_interval;
+			next_msg = sim_count + ((gap < 1.0) ? 1 : (ULL)(gap + 0.5));
+		}
+		
+		message msg;
+		while(recv_message(msg)) {
+			bytes_recv += msg.bytes;
+			if(LOG >= 3)
+				eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" read message "<<msg.id
+				        <<" from "<<msg.src<<" bytes "<<msg.bytes<<" latency "<<msg.arrival - msg.issue;
+		}
+		
+		// inject front flit of queue, flits of one packet are flit_interval apart
+		inject_step(next_inject, flit_interval);
+		
+		send_finished = (sim_count > TG_NUM || num_tiles < 2) && inj_queue.empty();
+		wait();
+	}
+}
+
+////////////////////////////////////////////////
+/// Thread sensitive to clock and inport event
+/// - inherited from ipcore
+/// - nothing to do per flit, ipcore reassembles messages into inbox
+////////////////////////////////////////////////
+void Message_traffic::recv_app() {
+	wait();	// wait until inport event
+}
+
+// for dynamic linking
+extern "C" {
+ipcore *maker() {
+	return new Message_traffic("Message_traffic");
+}
+}
@@ -0,0 +1,77 @@
+
+/*
+ * Message_traffic.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * Author: Lavina Jain
+ *
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file Message_traffic.h
+/// \brief Defines message traffic generator using send_message API
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Message_traffic_H_
+#define _Message_traffic_H_
+
+#include "../../core/ipcore.h"
+#include <fstream>
+#include <string>
+#include <deque>
+
+/// required for stl
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+/// \brief Module to define message traffic generator
+///
+/// - Module derived from ipcore
+/// - sends messages of MSG_BYTES bytes with send_message, packetization
+///   follows HEAD_PAYLOAD/DATA_PAYLOAD with packets of at most PACKET_FLITS flits
+/// - messages are MSG_INTERVAL cycles apart (mean, exponential if EXPONENTIAL is given)
+/// - at most WINDOW messages are not delivered yet (0 - no limit), their
+///   handles are polled with message_status
+/// - reassembled messages are read with recv_message
+/// - configuration in config/traffic/tile-N:
+///   DESTINATION RANDOM|FIXED id, MSG_BYTES, MSG_CLASS, MSG_INTERVAL, EXPONENTIAL,
+///   WINDOW, PACKET_FLITS, FLIT_INTERVAL
+/////////////////////////////////////////////////////////////
+struct Message_traffic : public ipcore {
+	
+	/// Constructor
+	SC_CTOR(Message_traffic);
+	
+	// PROCESSES /////////////////////////////////////////////////////
+	void send_app();			///< send messages and inject their flits
+	void recv_app();			///< wait for flits (messages are reassembled by ipcore)
+	void init_app();			///< read configuration
+	// PROCESSES END /////////////////////////////////////////////////////
+	
+	// VARIABLES /////////////////////////////////////////////////////
+	bool random_dst;			///< destination is chosen randomly for every message
+	UI dst;						///< fixed destination
+	UI msg_bytes;				///< message size (in bytes)
+	int msg_class;				///< class of sent messages
+	double msg_interval;		///< cycles between messages
+	bool exponential;			///< intervals are exponential with mean msg_interval
+	UI window;					///< largest number of undelivered messages (0 - no limit)
+	int flit_interval;			///< inter-flit interval (in clock cycles)
+	deque<UI> undelivered;		///< handles of messages not delivered yet
+	ULL bytes_recv;				///< bytes of reassembled messages
+	// VARIABLES END /////////////////////////////////////////////////////
+};
+
+#endif
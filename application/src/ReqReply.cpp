@@ -0,0 +1,239 @@
+
+/*
+ * ReqReply.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * Author: Lavina Jain
+ *
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file ReqReply.cpp
+/// \brief Implements closed-loop request/reply application
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ReqReply.h"
+#include "../../config/extern.h"
+
+extern string app_libname[MAX_NUM_TILES];
+
+////////////////////////////////////////////////
+/// Function to read role of a tile running this library
+/// \param tile tile ID
+/// \return true if tile serves requests (ROLE RESPONDER or BOTH, default BOTH)
+////////////////////////////////////////////////
+static bool tile_responds(UI tile) {
+	char str_id[4];
+	sprintf(str_id, "%d", tile);
+	string traffic_filename = string("config/traffic/tile-") + string(str_id);
+	ifstream instream;
+	instream.open(traffic_filename.c_str());
+	bool responds = true;
+	while(instream.is_open() && !instream.eof()) {
+		string field;
+		instream >> field;
+		if(field == "ROLE") {
+			string value; instream >> value;
+			responds = (value == "RESPONDER" || value == "BOTH");
+		}
+	}
+	instream.close();
+	return responds;
+}
+
+////////////////////////////////////////////////
+/// Constructor
+////////////////////////////////////////////////
+ReqReply::ReqReply(sc_module_name ReqReply): ipcore(ReqReply) {
+	requester = true;
+	responder = true;
+	max_outstanding = 4;
+	think_time = 0.0;
+	req_flits = 1;
+	service_time = 1;
+	reply_flits = 5;
+	flit_interval = 1;
+	next_tag = 0;
+	server_free = 0;
+}
+
+////////////////////////////////////////////////
+/// Method to read configuration of tile
+////////////////////////////////////////////////
+void ReqReply::init_app() {
+	// open traffic config file
+	char str_id[4];
+	sprintf(str_id, "%d", tileID);
+	string traffic_filename = string("config/traffic/tile-") + string(str_id);
+	ifstream instream;
+	instream.open(traffic_filename.c_str());
+
+	while(!instream.eof()) {
+		string field;
+		instream >> field;
+		if(field == "ROLE") {
+			string value; instream >> value;
+			requester = (value == "REQUESTER" || value == "BOTH");
+			responder = (value == "RESPONDER" || value == "BOTH");
+		}
+		else if(field == "MAX_OUTSTANDING") {
+			UI value; instream >> value; max_outstanding = value;
+		}
+		else if(field == "THINK_TIME") {
+			double value; instream >> value; think_time = value;
+		}
+		else if(field == "REQ_FLITS") {
+			int value; instream >> value; req_flits = value;
+		}
+		else if(field == "SERVERS") {	// number of tiles followed by tile ids
+			UI n; instream >> n;
+			servers.clear();
+			for(UI i = 0; i < n; i++) {
+				UI value; instream >> value;
+				if(value < num_tiles && value != tileID)
+					servers.push_back(value);
+			}
+		}
+		else if(field == "SERVICE_TIME") {
+			ULL value; instream >> value; service_time = value;
+		}
+		else if(field == "REPLY_FLITS") {
+			int value; instream >> value; reply_flits = value;
+		}
+		else if(field == "FLIT_INTERVAL") {	// read inter-flit interval
+			int value; instream >> value; flit_interval = value;
+		}
+	}
+	instream.close();
+	
+	// default servers: other tiles of this library that serve requests,
+	// a request to any other tile would never be answered
+	if(requester && servers.empty()) {
+		for(UI i = 0; i < num_tiles; i++)
+			if(i != tileID && app_libname[i] == app_libname[tileID] && tile_responds(i))
+				servers.push_back(i);
+		if(servers.empty()) {
+			cout<<traffic_filename<<": no SERVERS and no other tile is a responder, tile issues no requests"<<endl;
+			requester = false;
+		}
+	}
+	if(num_tiles < 2)
+		requester = false;
+	for(UI i = 0; requester && i < max_outstanding; i++)
+		free_slots.push(sim_count);
+	
+	if(LOG >= 1)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" request/reply"
+		        <<(requester ? " requester" : "")<<(responder ? " responder" : "")<<" outstanding "<<max_outstanding;
+}
+
+////////////////////////////////////////////////
+/// Method to issue request
+/// - takes a free slot, picks server and records issue cycle under new tag
+////////////////////////////////////////////////
+void ReqReply::issue_request() {
+	free_slots.pop();
+	UI dst = servers[ran_var->uniform((int)servers.size())];
+	int tag = next_tag++;
+	outstanding[tag] = sim_count;
+	enqueue_packet(dst, req_flits, RR_REQUEST, tag);
+	if(LOG >= 3)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" request "<<tag<<" to "<<dst;
+}
+
+////////////////////////////////////////////////
+/// Thread sensitive to clock
+/// - inherited from ipcore
+/// - issue requests while slots are free (until TG_NUM)
+/// - send replies of served requests
+/// - inject one flit per flit_interval from injection queue
+/// - core reports itself finished while it has nothing in flight, it is
+///   never left since other tiles may still send requests
+////////////////////////////////////////////////
+void ReqReply::send_app() {
+	wait(WARMUP);	// wait for WARMUP period
+	init_app();
+	ULL next_inject = sim_count;
+	
+	while(true) {
+		// requests, bounded by free slots
+		while(requester && sim_count <= TG_NUM && !free_slots.empty() && free_slots.top() <= sim_count && !inj_queue_full())
+			issue_request();
+		
+		// replies of served requests
+		while(!pending.empty() && pending.front().ready <= sim_count) {
+			enqueue_packet(pending.front().requester, reply_flits, RR_REPLY, pending.front().tag);
+			pending.pop_front();
+		}
+		
+		// inject front flit of queue, flits of one packet are flit_interval apart
+		inject_step(next_inject, flit_interval);
+		
+		send_finished = (sim_count > TG_NUM || !requester) && outstanding.empty() && pending.empty() && inj_queue.empty();
+		wait();
+	}
+}
+
+////////////////////////////////////////////////
+/// Thread sensitive to clock and inport event
+/// - inherited from ipcore
+/// - requests are queued for service when their last flit arrives
+/// - replies complete transaction of their tag and free its slot
+////////////////////////////////////////////////
+void ReqReply::recv_app() {
+	wait();	// wait until inport event
+	if(!flit_inport.event())
+		return;
+	flit flit_recd = flit_inport.read();	// read incoming flit
+	flit_type type = flit_recd.pkthdr.nochdr.flittype;
+	if(type != TAIL && type != HDT)
+		return;
+	int cmd, tag;
+	get_payload(flit_recd, cmd, tag);
+	
+	if(cmd == RR_REQUEST && responder) {
+		rr_pending req;
+		req.requester = flit_recd.src;
+		req.tag = tag;
+		server_free = ((server_free > sim_count) ? server_free : sim_count) + service_time;
+		req.ready = server_free;
+		pending.push_back(req);
+		send_finished = false;
+	}
+	else if(cmd == RR_REQUEST) {	// requester waits for reply until end of simulation
+		cout<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" Warning: tile is not a responder, request "
+		    <<tag<<" from tile "<<flit_recd.src<<" dropped"<<endl;
+	}
+	else if(cmd == RR_REPLY) {
+		map<int, ULL>::iterator it = outstanding.find(tag);
+		if(it == outstanding.end())
+			return;
+		ULL issued = it->second;
+		outstanding.erase(it);
+		record_transaction(issued);
+		ULL think = (think_time > 0.0) ? (ULL)(ran_var->exponential(think_time) + 0.5) : 0;
+		free_slots.push(sim_count + think);
+		if(LOG >= 3)
+			eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" reply "<<tag<<" round trip "
+			        <<sim_count - issued;
+	}
+}
+
+// for dynamic linking
+extern "C" {
+ipcore *maker() {
+	return new ReqReply("ReqReply");
+}
+}
@@ -0,0 +1,100 @@
+
+/*
+ * ReqReply.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * Author: Lavina Jain
+ *
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file ReqReply.h
+/// \brief Defines closed-loop request/reply application
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ReqReply_H_
+#define _ReqReply_H_
+
+#include "../../core/ipcore.h"
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <queue>
+
+/// required for stl
+using namespace std;
+
+/// command field of request/reply packets
+enum reqreply_cmd {
+	RR_REQUEST = 1,		///< request, data field holds tag of requester
+	RR_REPLY = 2		///< reply, data field holds tag of request
+};
+
+///////////////////////////////////////////
+/// \brief request waiting for service at responder
+///////////////////////////////////////////
+struct rr_pending {
+	UI  requester;	///< tile to reply to
+	int tag;		///< tag of request
+	ULL ready;		///< cycle service completes
+};
+
+//////////////////////////////////////////////////////////////
+/// \brief Module to define closed-loop request/reply application
+///
+/// - Module derived from ipcore
+/// - requester keeps at most MAX_OUTSTANDING requests in flight, a slot
+///   is reused THINK_TIME cycles (mean, exponential) after its reply arrives
+/// - responder serves requests in order, SERVICE_TIME cycles each, and
+///   replies with REPLY_FLITS flits
+/// - replies are matched to requests by tag carried in cmd/data fields
+/// - configuration in config/traffic/tile-N:
+///   ROLE REQUESTER|RESPONDER|BOTH, MAX_OUTSTANDING, THINK_TIME, REQ_FLITS,
+///   SERVERS n id1 .. idn (default: other ReqReply tiles with role RESPONDER or BOTH),
+///   SERVICE_TIME, REPLY_FLITS, FLIT_INTERVAL
+/////////////////////////////////////////////////////////////
+struct ReqReply : public ipcore {
+	
+	/// Constructor
+	SC_CTOR(ReqReply);
+	
+	// PROCESSES /////////////////////////////////////////////////////
+	void send_app();			///< issue requests and replies
+	void recv_app();			///< recieve requests and replies
+	void init_app();			///< read configuration
+	void issue_request();		///< send request to a server
+	// PROCESSES END /////////////////////////////////////////////////////
+	
+	// VARIABLES /////////////////////////////////////////////////////
+	bool requester;				///< tile issues requests
+	bool responder;				///< tile serves requests
+	UI max_outstanding;			///< largest number of requests in flight
+	double think_time;			///< mean cycles between reply and reuse of its slot
+	int req_flits;				///< request size (in flits)
+	vector<UI> servers;			///< tiles requests are sent to
+	ULL service_time;			///< cycles to serve one request
+	int reply_flits;			///< reply size (in flits)
+	int flit_interval;			///< inter-flit interval (in clock cycles)
+	int next_tag;				///< tag of next request
+	map<int, ULL> outstanding;	///< issue cycle of requests in flight, by tag
+	priority_queue<ULL, vector<ULL>, greater<ULL> > free_slots;	///< cycles at which request slots become free
+	deque<rr_pending> pending;	///< requests waiting for service
+	ULL server_free;			///< cycle responder finishes its present request
+	// VARIABLES END /////////////////////////////////////////////////////
+};
+
+#endif
@@ -0,0 +1,197 @@
+/*
+ * SelfSimilar.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file SelfSimilar.cpp
+/// \brief Implements self-similar traffic generator (aggregate of Pareto on/off sources)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SelfSimilar.h"
+#include "../../config/extern.h"
+
+////////////////////////////////////////////////
+/// Constructor
+////////////////////////////////////////////////
+SelfSimilarTraffic::SelfSimilarTraffic(sc_module_name SelfSimilarTraffic) : TrafficGenerator(SelfSimilarTraffic), var_on(0.0, 1.5), var_off(0.0, 1.5) {
+	rate = 0.1;
+	pkt_flits = 5;
+	hurst = 0.8;
+	num_sources = 16;
+	avg_on = 100.0;
+	avg_off = 100.0;
+	emit_gap = 1.0;
+	cur = 0.0;
+	idle = false;
+	dst_type = "RANDOM";
+}
+
+////////////////////////////////////////////////
+/// Method to prepare self-similar traffic source
+/// - read traffic configuration file
+/// - compute peak rate of single source from aggregate rate
+/// - start sources in random phase
+////////////////////////////////////////////////
+void SelfSimilarTraffic::init_source() {
+	// open traffic config file
+	char str_id[4];
+	sprintf(str_id, "%d", tileID);
+	string traffic_filename = string("config/traffic/tile-") + string(str_id);
+	ifstream instream;
+	instream.open(traffic_filename.c_str());
+
+	while(!instream.eof()) {
+		string field;
+		instream >> field;
+		if(field == "RATE") {	// flits per cycle
+			double value; instream >> value; rate = value;
+		}
+		else if(field == "PKT_FLITS") {
+			int value; instream >> value; pkt_flits = value;
+		}
+		else if(field == "HURST") {
+			double value; instream >> value; hurst = value;
+		}
+		else if(field == "NUM_SOURCES") {
+			UI value; instream >> value; num_sources = value;
+		}
+		else if(field == "AVG_ON") {
+			double value; instream >> value; avg_on = value;
+		}
+		else if(field == "AVG_OFF") {
+			double value; instream >> value; avg_off = value;
+		}
+		else if(field == "DESTINATION") {
+			instream >> dst_type;	// read destination type
+			if(dst_type == "FIXED") {	// if fixed destination, read destination tileID or route code
+				int value; instream >> value; route_info = value;
+			}
+		}
+		else if(field == "FLIT_INTERVAL") {	// read inter-flit interval
+			int value; instream >> value; flit_interval = value;
+		}
+	}
+	instream.close();
+	
+	if(pkt_flits < 1)
+		pkt_flits = 1;
+	if(num_sources < 1)
+		num_sources = 1;
+	if(avg_on < 1.0)
+		avg_on = 1.0;
+	if(avg_off < 1.0)
+		avg_off = 1.0;
+	// Pareto shape must stay in (1, 2) for finite mean and infinite variance
+	if(hurst < 0.55 || hurst > 0.95) {
+		cout<<"tile "<<tileID<<": HURST "<<hurst<<" out of range 0.55..0.95, clipped"<<endl;
+		hurst = (hurst < 0.55) ? 0.55 : 0.95;
+	}
+	double shape = 3.0 - 2.0 * hurst;
+	var_on.setavg(avg_on);
+	var_on.setshape(shape);
+	var_off.setavg(avg_off);
+	var_off.setshape(shape);
+	num_flits = pkt_flits;
+	
+	// aggregate packet rate = num_sources * fraction of time on / emit_gap
+	double pkt_rate = rate / pkt_flits;
+	double on_fraction = avg_on / (avg_on + avg_off);
+	idle = pkt_rate <= 0.0 || num_tiles < 2;
+	emit_gap = idle ? 1.0 : num_sources * on_fraction / pkt_rate;
+	
+	on.assign(num_sources, false);
+	period_end.assign(num_sources, 0.0);
+	next_emit.assign(num_sources, 0.0);
+	for(UI i = 0; i < num_sources; i++) {
+		on[i] = ran_var->uniform() < on_fraction;
+		period_end[i] = (on[i] ? var_on.value() : var_off.value()) * ran_var->uniform();
+		next_emit[i] = ran_var->uniform(emit_gap);
+	}
+	
+	if(LOG >= 1)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" self-similar rate "<<rate
+		        <<" hurst "<<hurst<<" sources "<<num_sources<<" emit gap "<<emit_gap<<(idle ? " idle" : "");
+	
+	// export of generated pattern (optional)
+	open_export();
+	
+	// first packet at first emission of aggregate
+	if(!idle) {
+		cur = next_event();
+		sched_time += (ULL)cur;
+	}
+}
+
+////////////////////////////////////////////////
+/// Method to find next packet of aggregate
+/// \return time of packet (relative to start of generation)
+/// - sources are moved through their on/off periods up to their next packet
+////////////////////////////////////////////////
+double SelfSimilarTraffic::next_event() {
+	UI first = 0;
+	for(UI i = 0; i < num_sources; i++) {
+		while(!on[i] || next_emit[i] >= period_end[i]) {
+			if(on[i])
+				period_end[i] += var_off.value();
+			else {
+				next_emit[i] = period_end[i];
+				period_end[i] += var_on.value();
+			}
+			on[i] = !on[i];
+		}
+		if(next_emit[i] < next_emit[first])
+			first = i;
+	}
+	double t = next_emit[first];
+	next_emit[first] += emit_gap;
+	return t;
+}
+
+////////////////////////////////////////////////
+/// Method to generate next packet
+/// \return false if tile does not generate traffic
+////////////////////////////////////////////////
+bool SelfSimilarTraffic::next_packet() {
+	if(idle)
+		return false;
+	next_pkt_time = (int)next_interval();
+	if(dst_type == "RANDOM")
+		route_info = get_random_dest();		// get random destination
+	export_packet();
+	return true;
+}
+
+////////////////////////////////////////////////
+/// Method to return inter-packet interval
+/// - interval from present packet to next packet of aggregate
+////////////////////////////////////////////////
+double SelfSimilarTraffic::next_interval() {
+	double next = next_event();
+	double t = (double)((ULL)next - (ULL)cur);
+	cur = next;
+	return t;
+}
+
+// for dynamic linking
+extern "C" {
+	ipcore *maker() {
+		return new SelfSimilarTraffic("SelfSimilar");
+	}
+}
@@ -0,0 +1,78 @@
+/*
+ * SelfSimilar.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file SelfSimilar.h
+/// \brief Defines self-similar traffic generator (aggregate of Pareto on/off sources)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SELF_SIMILAR_
+#define _SELF_SIMILAR_
+
+#include "TG.h"
+#include "../../core/ranvar.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////
+/// \brief Module to define self-similar traffic generator
+///
+/// - derived from TrafficGenerator
+/// - traffic of tile is superposition of NUM_SOURCES on/off sources,
+///   on and off periods are Pareto with shape 3 - 2 * HURST, so the
+///   aggregate is long-range dependent with given Hurst parameter
+/// - a source in on period emits packets at constant peak rate
+/// - configuration in config/traffic/tile-N:
+///   RATE (flits/cycle), PKT_FLITS, HURST (0.5..1), NUM_SOURCES,
+///   AVG_ON, AVG_OFF (mean period lengths in cycles), DESTINATION, FLIT_INTERVAL
+//////////////////////////////////////////////////////////////////////
+struct SelfSimilarTraffic : public TrafficGenerator {
+
+	/// Constructor
+	SC_CTOR(SelfSimilarTraffic);
+	
+	// PROCESSES /////////////////////////////////////////////////////////
+	void init_source();		///< read traffic configuration
+	bool next_packet();		///< generate next packet
+	double next_interval();	///< returns inter-packet interval
+	double next_event();	///< returns time of next packet of aggregate
+	// PROCESSES END /////////////////////////////////////////////////////
+	
+	// VARIABLES /////////////////////////////////////////////////////////
+	double rate;			///< offered load of tile (flits/cycle)
+	int pkt_flits;			///< packet size (in flits)
+	double hurst;			///< Hurst parameter of aggregate
+	UI num_sources;			///< number of aggregated on/off sources
+	double avg_on;			///< mean on period (in cycles)
+	double avg_off;			///< mean off period (in cycles)
+	double emit_gap;		///< interval between packets of a source in on period (in cycles)
+	vector<bool> on;		///< source is in on period
+	vector<double> period_end;	///< end of present period of source
+	vector<double> next_emit;	///< time of next packet of source
+	double cur;				///< time of present packet (fractional part is kept)
+	bool idle;				///< tile does not generate traffic
+	string dst_type;		///< string to determine wether destination is fixed or random
+	
+	ParetoRandomVariable var_on;	///< Pareto distributed on period
+	ParetoRandomVariable var_off;	///< Pareto distributed off period
+	// VARIABLES END /////////////////////////////////////////////////////
+};
+
+#endif
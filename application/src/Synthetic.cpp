@@ -0,0 +1,153 @@
+/*
+ * Synthetic.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file Synthetic.cpp
+/// \brief Implements synthetic traffic generator (standard NoC traffic patterns)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Synthetic.h"
+#include "../../config/extern.h"
+
+////////////////////////////////////////////////
+/// Constructor
+////////////////////////////////////////////////
+SyntheticTraffic::SyntheticTraffic(sc_module_name SyntheticTraffic) : TrafficGenerator(SyntheticTraffic) {
+	pattern = PAT_UNIFORM;
+	rate = 0.1;
+	pkt_rate = 0.0;
+	pkt_flits = 5;
+	pkt_flits_long = 5;
+	long_fraction = 0.0;
+	hotspot_fraction = 0.0;
+	fixed_dest = 0;
+	idle = false;
+}
+
+////////////////////////////////////////////////
+/// Method to prepare synthetic traffic source
+/// - read traffic configuration file
+/// - compute destination of permutation patterns
+/// - delay first packet by random inter-arrival time
+////////////////////////////////////////////////
+void SyntheticTraffic::init_source() {
+	// open traffic config file
+	char str_id[4];
+	sprintf(str_id, "%d", tileID);
+	string traffic_filename = string("config/traffic/tile-") + string(str_id);
+	ifstream instream;
+	instream.open(traffic_filename.c_str());
+
+	while(!instream.eof()) {
+		string field;
+		instream >> field;
+		if(field == "PATTERN") {
+			string value; instream >> value;
+			if(!parse_pattern(value, pattern)) {
+				cout<<"tile "<<tileID<<": unknown PATTERN "<<value<<", using UNIFORM"<<endl;
+				pattern = PAT_UNIFORM;
+			}
+		}
+		else if(field == "HOTSPOT_TILES") {	// number of tiles followed by tile ids
+			UI n; instream >> n;
+			hotspots.clear();
+			for(UI i = 0; i < n; i++) {
+				UI value; instream >> value;
+				if(value < num_tiles)
+					hotspots.push_back(value);
+			}
+		}
+		else if(field == "HOTSPOT_FRACTION") {
+			double value; instream >> value; hotspot_fraction = value;
+		}
+		else if(field == "INJECTION") {
+			string value; instream >> value;
+			injection = (value == "POISSON") ? INJ_POISSON : INJ_BERNOULLI;
+		}
+		else if(field == "RATE") {	// flits per node per cycle
+			double value; instream >> value; rate = value;
+		}
+		else if(field == "PKT_FLITS") {
+			int value; instream >> value; pkt_flits = value;
+		}
+		else if(field == "PKT_FLITS_LONG") {
+			int value; instream >> value; pkt_flits_long = value;
+		}
+		else if(field == "LONG_FRACTION") {
+			double value; instream >> value; long_fraction = value;
+		}
+		else if(field == "FLIT_INTERVAL") {	// read inter-flit interval
+			int value; instream >> value; flit_interval = value;
+		}
+	}
+	instream.close();
+	
+	if(pkt_flits < 1)
+		pkt_flits = 1;
+	if(pkt_flits_long < 1)
+		pkt_flits_long = pkt_flits;
+	double mean_flits = (1.0 - long_fraction) * pkt_flits + long_fraction * pkt_flits_long;
+	pkt_rate = rate / mean_flits;
+	
+	// destination of permutation patterns is fixed
+	fixed_dest = permutation_dest(pattern);
+	bool permutation = (pattern != PAT_UNIFORM && pattern != PAT_HOTSPOT);
+	idle = (permutation && fixed_dest == tileID) || pkt_rate <= 0.0 || num_tiles < 2;
+	
+	if(LOG >= 1)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" synthetic pattern "<<pattern
+		        <<" rate "<<rate<<" dest "<<(permutation ? (int)fixed_dest : -1)<<(idle ? " idle" : "");
+	
+	// export of generated pattern (optional)
+	open_export();
+	
+	// first packet after random inter-arrival time
+	if(!idle)
+		sched_time += (ULL)next_interval();
+}
+
+////////////////////////////////////////////////
+/// Method to generate next packet
+/// \return false if tile does not generate traffic
+////////////////////////////////////////////////
+bool SyntheticTraffic::next_packet() {
+	if(idle)
+		return false;
+	num_flits = (long_fraction > 0.0 && ran_var->uniform() < long_fraction) ? pkt_flits_long : pkt_flits;
+	route_info = (pattern == PAT_UNIFORM || pattern == PAT_HOTSPOT) ? pattern_dest(pattern, hotspots, hotspot_fraction) : fixed_dest;
+	next_pkt_time = (int)next_interval();
+	export_packet();
+	return true;
+}
+
+////////////////////////////////////////////////
+/// Method to return inter-packet interval
+////////////////////////////////////////////////
+double SyntheticTraffic::next_interval() {
+	return random_interval(pkt_rate);
+}
+
+// for dynamic linking
+extern "C" {
+	ipcore *maker() {
+		return new SyntheticTraffic("Synthetic");
+	}
+}
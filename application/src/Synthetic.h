@@ -0,0 +1,66 @@
+/*
+ * Synthetic.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file Synthetic.h
+/// \brief Defines synthetic traffic generator (standard NoC traffic patterns)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SYNTHETIC_
+#define _SYNTHETIC_
+
+#include "TG.h"
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////
+/// \brief Module to define synthetic traffic generator
+///
+/// - derived from TrafficGenerator
+/// - packets are generated on the fly as per config/traffic/tile-N:
+///   PATTERN, HOTSPOT_TILES, HOTSPOT_FRACTION, INJECTION, RATE (flits/node/cycle),
+///   PKT_FLITS, PKT_FLITS_LONG, LONG_FRACTION (bimodal sizes), FLIT_INTERVAL
+//////////////////////////////////////////////////////////////////////
+struct SyntheticTraffic : public TrafficGenerator {
+
+	/// Constructor
+	SC_CTOR(SyntheticTraffic);
+	
+	// PROCESSES /////////////////////////////////////////////////////////
+	void init_source();		///< read traffic configuration
+	bool next_packet();		///< generate next packet
+	double next_interval();	///< return next packet interval
+	// PROCESSES END /////////////////////////////////////////////////////
+	
+	// VARIABLES /////////////////////////////////////////////////////
+	traffic_pattern pattern;	///< traffic pattern
+	double rate;				///< offered load (flits per node per cycle)
+	double pkt_rate;			///< packets per cycle derived from rate and mean packet size
+	int pkt_flits;				///< packet size (in flits)
+	int pkt_flits_long;			///< size of long packets (in flits), bimodal if LONG_FRACTION > 0
+	double long_fraction;		///< fraction of long packets
+	vector<UI> hotspots;		///< hotspot tiles
+	double hotspot_fraction;	///< fraction of packets sent to hotspot tiles
+	UI fixed_dest;				///< destination of permutation patterns
+	bool idle;					///< permutation maps tile to itself, no traffic
+	// VARIABLES END /////////////////////////////////////////////////////
+};
+
+#endif
@@ -39,106 +39,257 @@ TrafficGenerator::TrafficGenerator(sc_module_name TrafficGenerator): ipcore(Traf
     next_pkt_time = 0;
     num_flits = 0;
     route_info = 0;
+    injection = INJ_BERNOULLI;
+    arrival = 0.0;
+    sched_carry = 0.0;
 }
 
 ////////////////////////////////////////////////
 /// Thread sensitive to clock
 /// - inherited from ipcore
-/// - send flits as per traffic configuration
+/// - generate packets as per traffic configuration
+/// - packets are put into source injection queue at their scheduled time
+///   and injected from it while core buffer has space
 ////////////////////////////////////////////////
 void TrafficGenerator::send_app() {
 	num_pkts_gen = 0;	// initialize number of packets generated to zero
 	wait(WARMUP);		// wait for WARMUP period
 	
-	string field;
-	
-	// open traffic log file
-	char str_id[3];
-	sprintf(str_id, "%d", tileID);
-	string traffic_filename = string("log/traffic/tile-") + string(str_id);
-	ifstream trafstream;
-	trafstream.open(traffic_filename.c_str());
-
-	// read inter-flit interval
-	trafstream >> field >> flit_interval;
+    // packets are generated on schedule, source falls behind it only when injection queue is full
+    sched_active = true;
+    sched_start = sim_count;
+    sched_time = sim_count;
+    burst.start(sim_count);
     
-    int num_flits_gen_int = 0;
+	init_source();	// may move sched_time to delay first packet
+    bool generating = true;
+    ULL next_inject = sim_count;
 	
-    // generate traffic until TG_NUM
-    while(sim_count <= TG_NUM && !trafstream.eof()) {
-
-        // read inter-pkt interval
-        trafstream >> field >> next_pkt_time;
-        // read no. of flits in packet
-        trafstream >> field >> num_flits;
-        // read destination or route code
-        trafstream >> field >> route_info;
+    while(generating || !inj_queue.empty()) {
         
-        flit flit_out;
-        
-        if (!accept_destinations[route_info]) {
-            if(LOG >= 3)
-                eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" Not accepted destination "<<route_info;
-            continue;
-        }            
-        
-        // create hdt/head flit
-        if(num_flits == 1)
-            flit_out = *create_hdt_flit(num_pkts_gen, 0, route_info);
-        else
-            flit_out = *create_head_flit(num_pkts_gen, 0, route_info);
+        // generate traffic until TG_NUM
+        while(generating && sched_time <= sim_count) {
+            if(sim_count > TG_NUM) {
+                generating = false;
+                break;
+            }
+            if(inj_queue_full()) {
+                src_stall_cycles++;
+                break;
+            }
             
-        // wait while buffer has space
-        while(!credit_in[0].read().freeBuf) {
-            //cout<<"Time: "<<sc_time_stamp()<<" ipcore: "<<tileID<<" No space in core buffer"<<endl;
-            wait();
-            next_pkt_time--;
-        }
-        
-        // write flit to output port
-        flit_outport.write(flit_out);
-        if(LOG >= 1)
-            eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" Sending flit from core "<<flit_out;
-        
-        num_flits_gen_int = 1;
-        num_flits_gen++;
-        // generate subsequent flits in packet
-        while(num_flits_gen_int < num_flits) {
-            wait(flit_interval);
-            next_pkt_time -= flit_interval;
+            if(!next_packet()) {
+                generating = false;
+                break;
+            }
             
-            // create flit
-            if(num_flits_gen_int == num_flits-1)
-                flit_out = *create_tail_flit(num_pkts_gen, num_flits_gen_int);
+            // scenario phase scales interval, may silence tile (also by RATE_SCALE 0) or redirect packet
+            const traffic_phase *phase = scenario.phase_at(sched_time);
+            ULL pkt_time = sched_time;
+            if(phase != NULL && phase->active(tileID) && phase->rate_scale > 0.0 && phase->rate_scale != 1.0 && next_pkt_time >= 0) {
+                double step = next_pkt_time / phase->rate_scale + sched_carry;
+                sched_time += (ULL)step;
+                sched_carry = step - (ULL)step;
+            }
             else
-                flit_out = *create_data_flit(num_pkts_gen, num_flits_gen_int);
-            
-            num_flits_gen++;
-            num_flits_gen_int++;
-
-            // wait until space in buffer
-            while(!credit_in[0].read().freeBuf) {
-                //cout<<"Time: "<<sc_time_stamp()<<" ipcore: "<<tileID<<" No space in core buffer"<<endl;
-                wait();
-                next_pkt_time--;
+                sched_time += (next_pkt_time >= 0) ? next_pkt_time : 1;	// 0 - next packet in same cycle
+            if(phase != NULL) {
+                if(!phase->active(tileID))
+                    continue;
+                if(phase->set_pattern) {
+                    route_info = pattern_dest(phase->pattern, phase->hotspots, phase->hotspot_fraction);
+                    if((UI)route_info == tileID)	// permutation maps tile to itself
+                        continue;
+                }
+            }
+            if (!accept_destinations[route_info]) {
+                if(LOG >= 3)
+                    eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" Not accepted destination "<<route_info;
+                continue;
             }
+            burst.record(pkt_time, num_flits);
             
-            // send flit
-            flit_outport.write(flit_out);
-            if(LOG >= 1)
-                eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" Sending flit from core "<<flit_out;
+            // create all flits of packet, they are timestamped now
+            if(num_flits == 1)
+                enqueue_flit(create_hdt_flit(num_pkts_gen, 0, route_info));
+            else {
+                enqueue_flit(create_head_flit(num_pkts_gen, 0, route_info));
+                for(int i = 1; i < num_flits - 1; i++)
+                    enqueue_flit(create_data_flit(num_pkts_gen, i));
+                enqueue_flit(create_tail_flit(num_pkts_gen, num_flits - 1));
+            }
+            num_flits_gen += num_flits;
+            num_pkts_gen++;
+            sched_flits += num_flits;
         }
-
-        num_pkts_gen++;
-        if(next_pkt_time > 0)
-            wait(next_pkt_time);
-        else wait(1);
+        if(!generating)
+            burst.finish(sim_count);	// no-op after first call
+        
+        // inject front flit of queue, flits of one packet are flit_interval apart
+        inject_step(next_inject, flit_interval);
+        
+        wait();
     }
     #ifdef DEBUG_NOC
         cout<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" packets: "<<num_pkts_gen<<" flits: "<<num_flits_gen<<endl;
     #endif
     
-    trafstream.close();	// close traffic config file
+    trafstream.close();	    // close traffic log file
+    exportstream.close();	// close exported traffic log
+}
+
+////////////////////////////////////////////////
+/// Method to prepare packet source
+/// - default source replays traffic log written by previous simulation
+/// - read inter-flit interval
+////////////////////////////////////////////////
+void TrafficGenerator::init_source() {
+	string field;
+	
+	// open traffic log file
+	char str_id[4];
+	sprintf(str_id, "%d", tileID);
+	string traffic_filename = string("log/traffic/tile-") + string(str_id);
+	trafstream.open(traffic_filename.c_str());
+
+	// read inter-flit interval
+	trafstream >> field >> flit_interval;
+}
+
+////////////////////////////////////////////////
+/// Method to fetch next packet from traffic log
+/// \return false if traffic log is over
+////////////////////////////////////////////////
+bool TrafficGenerator::next_packet() {
+	string field;
+	
+	// read inter-pkt interval
+	trafstream >> field >> next_pkt_time;
+	// read no. of flits in packet
+	trafstream >> field >> num_flits;
+	// read destination or route code
+	trafstream >> field >> route_info;
+	
+	return !trafstream.fail();
+}
+
+////////////////////////////////////////////////
+/// Method to open traffic log for export of generated pattern
+/// - pattern is written only if TRAFFIC_EXPORT is set
+/// - written log can be replayed by Trace_traffic application
+////////////////////////////////////////////////
+void TrafficGenerator::open_export() {
+	if(!TRAFFIC_EXPORT)
+		return;
+	
+	char str_id[4];
+	sprintf(str_id, "%d", tileID);
+	string traffic_filename = string("log/traffic/tile-") + string(str_id);
+	exportstream.open(traffic_filename.c_str());
+	if(!exportstream.is_open()) {
+		cout<<"Cannot open "<<traffic_filename<<endl;
+		return;
+	}
+	// write inter-flit interval
+	exportstream<<"FLIT_INTERVAL: "<<flit_interval<<endl;
+}
+
+////////////////////////////////////////////////
+/// Method to write current packet to exported traffic log
+////////////////////////////////////////////////
+void TrafficGenerator::export_packet() {
+	if(!exportstream.is_open())
+		return;
+	exportstream<<"NEXT_PKT_INTERVAL: "<<next_pkt_time<<endl;	// write next packet interval
+	exportstream<<"NUM_FLITS: "<<num_flits<<endl;	            // write number of flits
+	exportstream<<"DESTINATION: "<<route_info<<endl;	        // write destination ID or route code
+}
+
+////////////////////////////////////////////////
+/// Method to return random inter-packet interval
+/// \param pkt_rate average number of packets per cycle
+/// - Bernoulli: geometric number of cycles until next packet (at least 1)
+/// - Poisson: exponential inter-arrival time, several packets may share a cycle
+////////////////////////////////////////////////
+double TrafficGenerator::random_interval(double pkt_rate) {
+	if(injection == INJ_POISSON) {
+		ULL now = (ULL)arrival;
+		arrival += ran_var->exponential(1.0 / pkt_rate);
+		return (double)((ULL)arrival - now);
+	}
+	if(pkt_rate >= 1.0)
+		return 1.0;
+	double u = 1.0 - ran_var->uniform();	// (0, 1]
+	double t = ceil(log(u) / log(1.0 - pkt_rate));
+	return (t < 1.0) ? 1.0 : t;
+}
+
+////////////////////////////////////////////////
+/// Method to return destination of tile under permutation pattern
+/// \param pattern traffic pattern
+/// \return destination (tileID itself for non-permutation patterns)
+////////////////////////////////////////////////
+UI TrafficGenerator::permutation_dest(traffic_pattern pattern) {
+	UI bits = 0;
+	while((1U << bits) < num_tiles)
+		bits++;
+	UI mask = (1U << bits) - 1;
+	UI row = tileID / num_cols;
+	UI col = tileID % num_cols;
+	UI dest = tileID;
+	switch(pattern) {
+		case PAT_TRANSPOSE:
+			dest = (col % num_rows) * num_cols + (row % num_cols);
+			break;
+		case PAT_BIT_COMPLEMENT:
+			dest = ~tileID & mask;
+			break;
+		case PAT_BIT_REVERSE: {
+			UI d = 0;
+			for(UI i = 0; i < bits; i++)
+				if(tileID & (1U << i))
+					d |= 1U << (bits - 1 - i);
+			dest = d;
+			break;
+		}
+		case PAT_SHUFFLE:
+			dest = (bits == 0) ? 0 : (((tileID << 1) | (tileID >> (bits - 1))) & mask);
+			break;
+		case PAT_TORNADO:
+			dest = ((row + (num_rows + 1) / 2 - 1) % num_rows) * num_cols + (col + (num_cols + 1) / 2 - 1) % num_cols;
+			break;
+		case PAT_NEIGHBOR:
+			dest = ((row + 1) % num_rows) * num_cols + (col + 1) % num_cols;
+			break;
+		default:
+			break;
+	}
+	// bit permutations on non power of two networks may point outside
+	if(dest >= num_tiles)
+		dest = dest % num_tiles;
+	return dest;
+}
+
+////////////////////////////////////////////////
+/// Method to return destination of next packet as per pattern
+/// \param pattern traffic pattern
+/// \param hotspots hotspot tiles (PAT_HOTSPOT)
+/// \param hotspot_fraction fraction of packets sent to hotspot tiles (PAT_HOTSPOT)
+////////////////////////////////////////////////
+UI TrafficGenerator::pattern_dest(traffic_pattern pattern, const vector<UI> &hotspots, double hotspot_fraction) {
+	switch(pattern) {
+		case PAT_UNIFORM:
+			return get_random_dest();
+		case PAT_HOTSPOT:
+			if(!hotspots.empty() && ran_var->uniform() < hotspot_fraction) {
+				UI dest = hotspots[ran_var->uniform((int)hotspots.size())];
+				if(dest != tileID && dest < num_tiles)
+					return dest;
+			}
+			return get_random_dest();
+		default:
+			return permutation_dest(pattern);
+	}
 }
 
 ////////////////////////////////////////////////
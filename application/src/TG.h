@@ -31,12 +31,19 @@
 #define __TrafficGen__
 
 #include "../../core/ipcore.h"
+#include "../../core/scenario.h"
 #include <fstream>
 #include <string>
 #include <math.h>
 
 using namespace std;
 
+/// packet injection processes of random traffic generators
+enum injection_type {
+	INJ_BERNOULLI,		///< packet in each cycle with fixed probability
+	INJ_POISSON			///< exponentially distributed packet inter-arrival times
+};
+
 //////////////////////////////////////////////////////////////
 /// \brief Module to define traffic generator
 ///
@@ -51,7 +58,15 @@ struct TrafficGenerator : public ipcore {
 
 	// PROCESSES /////////////////////////////////////////////////////
 	virtual double next_interval() = 0;	///< returns inter packet interval, defined in derived module
-	void send_app();			///< generate traffic according to traffic config file
+	virtual void init_source();	///< prepare packet source (default: open traffic log of previous simulation)
+	virtual bool next_packet();	///< fetch next packet into next_pkt_time, num_flits and route_info, false if no more packets
+	void open_export();			///< open traffic log to export generated pattern (if TRAFFIC_EXPORT is set)
+	void export_packet();		///< write current packet to exported traffic log
+	double random_interval(double pkt_rate);	///< returns random inter-packet interval as per injection process
+	UI permutation_dest(traffic_pattern pattern);	///< returns destination of tile under permutation pattern
+	/// returns destination of next packet as per pattern
+	UI pattern_dest(traffic_pattern pattern, const vector<UI> &hotspots, double hotspot_fraction);
+	void send_app();			///< generate traffic according to traffic source
 	void recv_app();			///< recieve flits
 	sc_time_unit strToTime(string);	///< convert time unit from string representation to systemC representation
 	// PROCESSES END ////////////////////////////////////////////////
@@ -62,6 +77,11 @@ struct TrafficGenerator : public ipcore {
 	int route_info;		///< destination address or routing code (for source routing)
 	int next_pkt_time;	///< inter packet interval (in clock cycles)
 	int cycles_per_flit;	///< number of cycles required for processing one flit
+	ifstream trafstream;	///< traffic log read by default packet source
+	ofstream exportstream;	///< traffic log to which generated pattern is exported
+	injection_type injection;	///< injection process used by random_interval()
+	double arrival;			///< time of next arrival (Poisson), fractional part is kept
+	double sched_carry;		///< fraction of cycle left over from scaling intervals by scenario phase
 	// VARIABLES END ///////////////////////////////////////////
 
 };
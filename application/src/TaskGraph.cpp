@@ -0,0 +1,378 @@
+
+/*
+ * TaskGraph.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * Author: Lavina Jain
+ *
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file TaskGraph.cpp
+/// \brief Implements task-graph application model
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "TaskGraph.h"
+#include "../../config/extern.h"
+
+/////////////////////////////////////////
+/// \brief task of task graph
+/////////////////////////////////////////
+struct tg_task {
+	bool defined;				///< task appears in file
+	UI   tile;					///< tile task is mapped to
+	ULL  compute;				///< computation time (in cycles)
+	vector<UI> in_edges;		///< edges task waits for
+	vector<UI> out_edges;		///< edges task sends when finished
+	UI   inputs_left;			///< input edges not yet arrived
+	bool done;					///< task has finished
+	ULL  ready;					///< cycle all inputs arrived
+	ULL  start;					///< cycle task started
+	ULL  finish;				///< cycle task finished
+};
+
+/////////////////////////////////////////
+/// \brief edge (message) of task graph
+/////////////////////////////////////////
+struct tg_edge {
+	UI  src;					///< producing task
+	UI  dst;					///< consuming task
+	UI  flits;					///< message size (in flits)
+	UI  packets_left;			///< packets not yet arrived
+	ULL sent;					///< cycle message was sent
+	ULL arrived;				///< cycle last packet arrived
+};
+
+/////////////////////////////////////////
+/// \brief task graph shared by all tiles
+/////////////////////////////////////////
+struct task_graph {
+	bool loaded;				///< file has been read
+	bool reported;				///< results have been written
+	UI   packet_flits;			///< largest packet size (in flits)
+	int  flit_interval;			///< inter-flit interval
+	ULL  start;					///< cycle tasks without inputs became ready
+	vector<tg_task> tasks;		///< tasks by id
+	vector<tg_edge> edges;		///< edges by id
+};
+
+static task_graph graph;
+
+////////////////////////////////////////////////
+/// Function to read task graph file
+/// - file is read once, by first tile that starts
+/// - task ids need not be contiguous, missing ids are never run
+////////////////////////////////////////////////
+static void load_graph() {
+	if(graph.loaded)
+		return;
+	graph.loaded = true;
+	graph.reported = false;
+	graph.packet_flits = 8;
+	graph.flit_interval = 1;
+
+	ifstream instream;
+	instream.open(TASK_GRAPH.c_str());
+	if(!instream.is_open()) {
+		cout<<"Cannot open "<<TASK_GRAPH<<", task graph is empty"<<endl;
+		return;
+	}
+
+	string field;
+	while(instream >> field) {
+		if(field[0] == '#') {	// comment up to end of line
+			getline(instream, field);
+		}
+		else if(field == "PACKET_FLITS") {
+			UI value; instream >> value; graph.packet_flits = (value < 1) ? 1 : value;
+		}
+		else if(field == "FLIT_INTERVAL") {
+			int value; instream >> value; graph.flit_interval = value;
+		}
+		else if(field == "TASK") {
+			UI id, tile; ULL compute;
+			instream >> id >> tile >> compute;
+			if(id >= graph.tasks.size()) {
+				tg_task empty;
+				empty.defined = false;
+				empty.tile = 0;
+				empty.compute = 0;
+				graph.tasks.resize(id + 1, empty);
+			}
+			if(tile >= num_tiles) {
+				cout<<TASK_GRAPH<<": task "<<id<<" mapped to tile "<<tile<<" outside network"<<endl;
+				continue;
+			}
+			graph.tasks[id].defined = true;
+			graph.tasks[id].tile = tile;
+			graph.tasks[id].compute = compute;
+		}
+		else if(field == "EDGE") {
+			tg_edge e;
+			instream >> e.src >> e.dst >> e.flits;
+			if(e.flits < 1)
+				e.flits = 1;
+			e.packets_left = 0;
+			e.sent = 0;
+			e.arrived = 0;
+			graph.edges.push_back(e);
+		}
+		else
+			cout<<TASK_GRAPH<<": unknown field "<<field<<endl;
+	}
+	instream.close();
+
+	for(UI e = 0; e < graph.edges.size(); e++) {
+		tg_edge &edge = graph.edges[e];
+		if(edge.src >= graph.tasks.size() || edge.dst >= graph.tasks.size()
+		   || !graph.tasks[edge.src].defined || !graph.tasks[edge.dst].defined) {
+			cout<<TASK_GRAPH<<": edge "<<edge.src<<" -> "<<edge.dst<<" joins undefined task"<<endl;
+			continue;
+		}
+		graph.tasks[edge.src].out_edges.push_back(e);
+		graph.tasks[edge.dst].in_edges.push_back(e);
+	}
+	for(UI t = 0; t < graph.tasks.size(); t++) {
+		graph.tasks[t].inputs_left = graph.tasks[t].in_edges.size();
+		graph.tasks[t].done = false;
+		graph.tasks[t].ready = 0;
+		graph.tasks[t].start = 0;
+		graph.tasks[t].finish = 0;
+	}
+}
+
+////////////////////////////////////////////////
+/// Constructor
+////////////////////////////////////////////////
+TaskGraph::TaskGraph(sc_module_name TaskGraph): ipcore(TaskGraph) {
+	busy = false;
+	running = 0;
+	busy_until = 0;
+	tasks_left = 0;
+}
+
+////////////////////////////////////////////////
+/// Method to read task graph and queue tasks of this tile that have no inputs
+////////////////////////////////////////////////
+void TaskGraph::init_app() {
+	load_graph();
+	graph.start = sim_count;
+	for(UI t = 0; t < graph.tasks.size(); t++) {
+		if(!graph.tasks[t].defined || graph.tasks[t].tile != tileID)
+			continue;
+		tasks_left++;
+		if(graph.tasks[t].inputs_left == 0) {
+			graph.tasks[t].ready = sim_count;
+			ready.push_back(t);
+		}
+	}
+	
+	if(LOG >= 1)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" task graph, "<<tasks_left<<" tasks mapped";
+}
+
+////////////////////////////////////////////////
+/// Thread sensitive to clock
+/// - inherited from ipcore
+/// - finish running task when its computation time has passed
+/// - start next ready task if core is free
+/// - inject one flit per flit_interval from injection queue
+////////////////////////////////////////////////
+void TaskGraph::send_app() {
+	wait(WARMUP);	// wait for WARMUP period
+	init_app();
+	ULL next_inject = sim_count;
+	
+	while(true) {
+		if(busy && sim_count >= busy_until) {
+			busy = false;
+			finish_task(running);
+		}
+		while(!busy && !ready.empty()) {
+			running = ready.front();
+			ready.pop_front();
+			graph.tasks[running].start = sim_count;
+			busy_until = sim_count + graph.tasks[running].compute;
+			busy = true;
+			if(graph.tasks[running].compute == 0) {
+				busy = false;
+				finish_task(running);
+			}
+		}
+		
+		// inject front flit of queue, flits of one packet are flit_interval apart
+		inject_step(next_inject, graph.flit_interval);
+		
+		send_finished = (tasks_left == 0) && inj_queue.empty();
+		wait();
+	}
+}
+
+////////////////////////////////////////////////
+/// Thread sensitive to clock and inport event
+/// - inherited from ipcore
+/// - edge is complete when last flit of its last packet arrives
+////////////////////////////////////////////////
+void TaskGraph::recv_app() {
+	wait();	// wait until inport event
+	if(!flit_inport.event())
+		return;
+	flit flit_recd = flit_inport.read();	// read incoming flit
+	flit_type type = flit_recd.pkthdr.nochdr.flittype;
+	if(type != TAIL && type != HDT)
+		return;
+	int cmd, edge;
+	get_payload(flit_recd, cmd, edge);
+	if(cmd != TASK_MSG || edge < 0 || (UI)edge >= graph.edges.size())
+		return;
+	if(graph.edges[edge].packets_left > 0 && --graph.edges[edge].packets_left == 0) {
+		graph.edges[edge].arrived = sim_count;
+		deliver(edge);
+	}
+}
+
+////////////////////////////////////////////////
+/// Method to process complete input edge
+/// \param edge edge id
+/// - consuming task becomes ready with its last input
+////////////////////////////////////////////////
+void TaskGraph::deliver(UI edge) {
+	tg_task &task = graph.tasks[graph.edges[edge].dst];
+	if(task.inputs_left > 0 && --task.inputs_left == 0) {
+		task.ready = sim_count;
+		ready.push_back(graph.edges[edge].dst);
+	}
+}
+
+////////////////////////////////////////////////
+/// Method to finish task
+/// \param task task id
+/// - message of each output edge is sent, packets of PACKET_FLITS flits
+///   (last one smaller), edges to tasks of this tile are delivered at once
+////////////////////////////////////////////////
+void TaskGraph::finish_task(UI task) {
+	graph.tasks[task].finish = sim_count;
+	graph.tasks[task].done = true;
+	tasks_left--;
+	if(LOG >= 3)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" task "<<task<<" finished";
+	
+	for(UI i = 0; i < graph.tasks[task].out_edges.size(); i++) {
+		UI e = graph.tasks[task].out_edges[i];
+		tg_edge &edge = graph.edges[e];
+		edge.sent = sim_count;
+		UI dst_tile = graph.tasks[edge.dst].tile;
+		if(dst_tile == tileID) {
+			edge.arrived = sim_count;
+			deliver(e);
+			continue;
+		}
+		edge.packets_left = (edge.flits + graph.packet_flits - 1) / graph.packet_flits;
+		for(UI left = edge.flits; left > 0; ) {
+			UI size = (left < graph.packet_flits) ? left : graph.packet_flits;
+			enqueue_packet(dst_tile, size, TASK_MSG, e);
+			left -= size;
+		}
+	}
+}
+
+////////////////////////////////////////////////
+/// Method to write makespan and critical path
+/// \param out results file
+/// - written once for all tiles
+/// - critical path is followed back from last finished task through
+///   latest arriving input edges, its parts add up to makespan
+////////////////////////////////////////////////
+void TaskGraph::report(ofstream &out) {
+	if(graph.reported || graph.tasks.empty())
+		return;
+	graph.reported = true;
+	
+	UI defined = 0, done = 0;
+	int last = -1;
+	for(UI t = 0; t < graph.tasks.size(); t++) {
+		if(!graph.tasks[t].defined)
+			continue;
+		defined++;
+		if(!graph.tasks[t].done)
+			continue;
+		done++;
+		if(last < 0 || graph.tasks[t].finish > graph.tasks[last].finish)
+			last = t;
+	}
+	out<<"\nTask graph tasks finished                                      = "<<done<<" of "<<defined<<endl;
+	if(last < 0)
+		return;
+	if(done < defined)
+		out<<"  (tasks left are mapped to tiles not running TaskGraph, wait for each other or did not finish before SIM_NUM)"<<endl;
+	
+	ULL compute = 0, wait_core = 0, comm = 0;
+	vector<bool> critical(graph.tasks.size(), false);
+	string path;
+	char buf[16];
+	for(int t = last; t >= 0; ) {
+		tg_task &task = graph.tasks[t];
+		critical[t] = true;
+		sprintf(buf, "%d", t);
+		path = string(buf) + ((path == "") ? string("") : string(" -> ")) + path;
+		compute += task.finish - task.start;
+		wait_core += task.start - task.ready;
+		int pred = -1;
+		ULL latest = 0;
+		for(UI i = 0; i < task.in_edges.size(); i++) {
+			tg_edge &edge = graph.edges[task.in_edges[i]];
+			if(pred < 0 || edge.arrived > latest) {
+				pred = task.in_edges[i];
+				latest = edge.arrived;
+			}
+		}
+		if(pred < 0)
+			break;
+		comm += graph.edges[pred].arrived - graph.edges[pred].sent;
+		t = graph.edges[pred].src;
+	}
+	
+	ULL makespan = graph.tasks[last].finish - graph.start;
+	double total = (makespan == 0) ? 1.0 : (double)makespan;
+	out<<"Makespan                          (in clock cycles)            = "<<makespan<<endl;
+	out<<"Critical path                                                  : "<<path<<endl;
+	out<<"  computation = "<<compute<<" ("<<100.0 * compute / total<<"%), communication = "<<comm<<" ("<<100.0 * comm / total
+	   <<"%), waiting for core = "<<wait_core<<" ("<<100.0 * wait_core / total<<"%)"<<endl;
+	
+	string tasks_file = DIRNAME + string("/stats/tasks.csv");
+	ofstream tasks_log;
+	tasks_log.open(tasks_file.c_str());
+	if(!tasks_log.is_open()) {
+		cout<<"Cannot open "<<tasks_file<<endl;
+		return;
+	}
+	out<<"(task times in stats/tasks.csv)"<<endl;
+	tasks_log<<"task,tile,compute,ready,start,finish,critical"<<endl;
+	for(UI t = 0; t < graph.tasks.size(); t++) {
+		tg_task &task = graph.tasks[t];
+		if(!task.defined)
+			continue;
+		tasks_log<<t<<","<<task.tile<<","<<task.compute<<","<<task.ready<<","<<task.start<<","<<task.finish
+		         <<","<<(critical[t] ? 1 : 0)<<endl;
+	}
+	tasks_log.close();
+}
+
+// for dynamic linking
+extern "C" {
+ipcore *maker() {
+	return new TaskGraph("TaskGraph");
+}
+}
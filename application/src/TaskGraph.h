@@ -0,0 +1,81 @@
+
+/*
+ * TaskGraph.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * Author: Lavina Jain
+ *
+ */
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file TaskGraph.h
+/// \brief Defines task-graph application model
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _TaskGraph_H_
+#define _TaskGraph_H_
+
+#include "../../core/ipcore.h"
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+
+/// required for stl
+using namespace std;
+
+/// command field of task-graph packets, data field holds edge id
+#define TASK_MSG	1
+
+//////////////////////////////////////////////////////////////
+/// \brief Module to define task-graph application
+///
+/// - Module derived from ipcore
+/// - task graph is read from TASK_GRAPH (nirgam.config) and shared by all tiles:
+///   TASK id tile compute_cycles, EDGE src_task dst_task flits,
+///   PACKET_FLITS (largest packet), FLIT_INTERVAL
+/// - tile runs tasks mapped to it one at a time, a task is ready when
+///   messages of all its input edges have arrived (tasks without inputs at start)
+/// - finished task sends message of each output edge, split into packets
+///   of at most PACKET_FLITS flits; edges inside a tile need no network
+/// - makespan and critical path split into computation, core wait and
+///   communication are written to results, task times to stats/tasks.csv
+/////////////////////////////////////////////////////////////
+struct TaskGraph : public ipcore {
+	
+	/// Constructor
+	SC_CTOR(TaskGraph);
+	
+	// PROCESSES /////////////////////////////////////////////////////
+	void send_app();			///< run tasks and send their messages
+	void recv_app();			///< recieve messages
+	void init_app();			///< read task graph and queue tasks without inputs
+	void report(ofstream &out);	///< write makespan and critical path
+	// PROCESSES END /////////////////////////////////////////////////////
+	
+	// FUNCTIONS /////////////////////////////////////////////////////
+	void deliver(UI edge);		///< input edge complete, task may become ready
+	void finish_task(UI task);	///< finish task and send messages of its output edges
+	// FUNCTIONS END /////////////////////////////////////////////////////
+	
+	// VARIABLES /////////////////////////////////////////////////////
+	deque<UI> ready;			///< ready tasks of this tile, in order of readiness
+	bool busy;					///< core is running a task
+	UI running;					///< task being run
+	ULL busy_until;				///< cycle running task finishes
+	UI tasks_left;				///< tasks of this tile not yet finished
+	// VARIABLES END /////////////////////////////////////////////////////
+};
+
+#endif
@@ -29,7 +29,54 @@
 
 /// Constructor
 TraceTraffic::TraceTraffic(sc_module_name TraceTraffic) : TrafficGenerator(TraceTraffic) {
+	has_pending = false;
+	trace_start = 0;
+}
+
+////////////////////////////////////////////////
+/// Method to open packet source
+/// - binary trace TRACE_FILE if set (first packet is delayed to its cycle)
+/// - otherwise traffic log of base class
+////////////////////////////////////////////////
+void TraceTraffic::init_source() {
+	if(TRACE_FILE.empty()) {
+		TrafficGenerator::init_source();
+		return;
+	}
+	
+	if(!cursor.open(TRACE_FILE, tileID))
+		return;
+	flit_interval = cursor.flit_interval();
+	trace_start = sched_time;
+	has_pending = cursor.next(pending);
+	if(has_pending)
+		sched_time = trace_start + pending.cycle;
+}
 
+////////////////////////////////////////////////
+/// Method to fetch next packet
+/// - interval to next packet is computed from absolute trace cycles,
+///   so generation does not drift from trace
+/// \return false if there are no more packets
+////////////////////////////////////////////////
+bool TraceTraffic::next_packet() {
+	if(TRACE_FILE.empty())
+		return TrafficGenerator::next_packet();
+	
+	if(!has_pending) {
+		cursor.close();
+		return false;
+	}
+	num_flits = pending.size;
+	route_info = pending.dst;
+	
+	has_pending = cursor.next(pending);
+	next_pkt_time = 1;
+	if(has_pending) {
+		ULL next_time = trace_start + pending.cycle;
+		next_pkt_time = (next_time > sched_time) ? (int)(next_time - sched_time) : 0;
+	}
+	return true;
 }
 
 // do nothing
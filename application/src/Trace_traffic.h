@@ -30,6 +30,7 @@
 
 #include "TG.h"
 #include "../../core/rng.h"
+#include "../../core/trace_bin.h"
 
 //////////////////////////////////////////////////////////////////////
 /// \brief Module to define trace based traffic generator
@@ -37,6 +38,7 @@
 /// - This module is derived from TrafficGenerator.
 /// - The purpose of this module is to allow instantiation of abstract module traffic generator.
 /// - In effect processes in base class generate traffic as per traffic log generated in previous simulation
+/// - If TRACE_FILE is set, packets are replayed from memory-mapped binary trace instead
 //////////////////////////////////////////////////////////////////////
 struct TraceTraffic : public TrafficGenerator {
 
@@ -44,6 +46,15 @@ struct TraceTraffic : public TrafficGenerator {
 	SC_CTOR(TraceTraffic);
 		
 	double next_interval();		///< returns next packet interval
+	void init_source();			///< open binary trace or traffic log
+	bool next_packet();			///< fetch next packet from binary trace or traffic log
+	
+	// VARIABLES /////////////////////////////////////////////////////
+	trace_bin_cursor cursor;	///< position of this tile in binary trace
+	trace_record pending;		///< next packet read from binary trace
+	bool has_pending;			///< pending holds a packet
+	ULL trace_start;			///< cycle corresponding to cycle 0 of trace
+	// VARIABLES END /////////////////////////////////////////////////////
 };
 
 #endif
@@ -148,12 +148,37 @@ enum input_arbitry_type {
 };
 
 /////////////////////////////////////////////////////////////
-/// types of request to controller: NONE, ROUTE, UPDATE
+/// types of request to controller: NONE, ROUTE, UPDATE, MCAST_ROUTE
+/// (MCAST_ROUTE: destination carries mode << 24 | group << 8 | target,
+/// reply carries directions bitmask | next target << 8;
+/// PATH worms are deadlock free, TREE packets hold a VC on every branch and
+/// advance in lock-step, so crossing trees may deadlock under heavy load)
 ////////////////////////////////////////////////////////////
 enum request_type {
 	NONE,
 	ROUTE,
-	UPDATE
+	UPDATE,
+	MCAST_ROUTE
+};
+
+//////////////////////////////////////////////////////////////////////////////////
+/// types of collected histograms: packet latency, flit latency, hops, waits,
+/// source queueing and network parts of flit latency, round trip of transactions,
+/// message latency (send_message to arrival of its last packet), reorder depth
+/// (missing predecessors in flow) and extra latency of in-order delivery
+//////////////////////////////////////////////////////////////////////////////////
+enum hist_type {
+	HIST_LATENCY_PKT,
+	HIST_LATENCY_FLIT,
+	HIST_HOPS,
+	HIST_WAITS,
+	HIST_QUEUE_FLIT,
+	HIST_NETWORK_FLIT,
+	HIST_ROUND_TRIP,
+	HIST_MESSAGE,
+	HIST_REORDER_DEPTH,
+	HIST_REORDER_DELAY,
+	HIST_NUM_TYPES
 };
 
 /////////////////////////////////////////
@@ -182,4 +207,7 @@ enum topology {
 
 #define corner(ID) (cornerNW(ID) || cornerNE(ID) || cornerSW(ID) || cornerSE(ID))   ///< is tile ID at any corner
 
+#define MEASURE_WINDOW_ON   (MEASURE_END > MEASURE_START)                                       ///< is measurement window defined
+#define in_measure_window(T) (!MEASURE_WINDOW_ON || ((T) >= MEASURE_START && (T) < MEASURE_END)) ///< is cycle T inside measurement window
+
 #endif
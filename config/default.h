@@ -60,6 +60,26 @@ ULL WARMUP = 5;		                            ///< warmup period (in clock cycles
 ULL SIM_NUM = 3000;	                            ///< simulation clock cycles
 ULL TG_NUM = 1000;	                            ///< clock cycles until which traffic is generated
 
+ULL STATS_WINDOW = 0;                           ///< length of statistics window (in clock cycles), 0 - no time series
+bool AUTO_STOP = false;                         ///< stop simulation when steady-state mean latency is estimated precisely enough
+double CI_TOLERANCE = 0.05;                     ///< relative half-width of 95% confidence interval of mean latency to stop at
+UI CI_BATCHES = 20;                             ///< number of batches used for batch-means confidence interval
+ULL MEASURE_START = 0;                          ///< first cycle of measurement window (packets generated inside are measured)
+ULL MEASURE_END = 0;                            ///< end cycle of measurement window, MEASURE_END <= MEASURE_START - no window
+bool DRAIN_STOP = true;                         ///< end simulation when all cores finished generation and all flits are received
+ULL DRAIN_TIMEOUT = 0;                          ///< max cycles to wait for drain after generation ends, 0 - wait until SIM_NUM
+ULL WATCHDOG_CYCLES = 2000;                     ///< cycles without progress after which a VC is considered stuck, 0 - watchdog off
+bool WATCHDOG_ABORT = false;                    ///< end simulation when deadlock is detected
+UI LIVELOCK_HOPS = 0;                           ///< hop count after which packet is reported as livelocked, 0 - 4 * (rows + cols)
+bool SAT_STOP = true;                           ///< end simulation when network is detected to be saturated
+UI SAT_WINDOWS = 5;                             ///< number of consecutive statistics windows required to declare saturation
+double SAT_TOLERANCE = 0.1;                     ///< relative shortfall of accepted throughput against offered load to count window as saturated
+UI SRC_QUEUE_SIZE = 0;                          ///< capacity of source injection queue (in flits), 0 - unbounded
+bool TRAFFIC_EXPORT = false;                    ///< write packets of synthetic generators to log/traffic (for replay by Trace_traffic)
+double RECOVERY_TOLERANCE = 0.1;                ///< relative band around steady latency of scenario phase to count as recovered
+ULL REDUCE_COMBINE_CYCLES = 1;                  ///< cycles to combine two packets of a reduction (router or root)
+UI REORDER_BUFFER = 16;                         ///< capacity of reorder buffer of receiving core (in packets), 0 - unlimited
+
 double CLK_FREQ = 1;			                ///< clock frequency (in GHz)
 double CLK_PERIOD = (1/CLK_FREQ);	            ///< clock period (in ns)
 
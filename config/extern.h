@@ -55,6 +55,30 @@ extern bool MATLAB_MAKE_IMAGES;                 ///< not just make matlab figs,
 extern ULL WARMUP;		                        ///< warmup period (in clock cycles) before traffic generation begins
 extern ULL SIM_NUM;		                        ///< total simulation clock cycles
 extern ULL TG_NUM;		                        ///< number of clock cycles until which traffic is generated
+extern ULL STATS_WINDOW;                        ///< length of statistics window (in clock cycles), 0 - no time series
+extern bool AUTO_STOP;                          ///< stop simulation when steady-state mean latency is estimated precisely enough
+extern double CI_TOLERANCE;                     ///< relative half-width of 95% confidence interval of mean latency to stop at
+extern UI CI_BATCHES;                           ///< number of batches used for batch-means confidence interval
+extern ULL MEASURE_START;                       ///< first cycle of measurement window (packets generated inside are measured)
+extern ULL MEASURE_END;                         ///< end cycle of measurement window, MEASURE_END <= MEASURE_START - no window
+extern bool DRAIN_STOP;                         ///< end simulation when all cores finished generation and all flits are received
+extern ULL DRAIN_TIMEOUT;                       ///< max cycles to wait for drain after generation ends, 0 - wait until SIM_NUM
+extern ULL WATCHDOG_CYCLES;                     ///< cycles without progress after which a VC is considered stuck, 0 - watchdog off
+extern bool WATCHDOG_ABORT;                     ///< end simulation when deadlock is detected
+extern UI LIVELOCK_HOPS;                        ///< hop count after which packet is reported as livelocked, 0 - 4 * (rows + cols)
+extern bool SAT_STOP;                           ///< end simulation when network is detected to be saturated
+extern UI SAT_WINDOWS;                          ///< number of consecutive statistics windows required to declare saturation
+extern double SAT_TOLERANCE;                    ///< relative shortfall of accepted throughput against offered load to count window as saturated
+extern UI SRC_QUEUE_SIZE;                       ///< capacity of source injection queue (in flits), 0 - unbounded
+extern bool TRAFFIC_EXPORT;                     ///< write packets of synthetic generators to log/traffic (for replay by Trace_traffic)
+extern std::string TRACE_FILE;                  ///< binary trace replayed by Trace_traffic, empty - replay text logs in log/traffic
+extern std::string TRAFFIC_MATRIX;              ///< rate file shared by all tiles running Matrix_traffic
+extern std::string SCENARIO_FILE;               ///< phased traffic scenario applied to all traffic generators, empty - none
+extern std::string TASK_GRAPH;                  ///< task graph shared by all tiles running TaskGraph
+extern std::string DIRNAME;                     ///< directory of results of present run (results/<name>, set at startup)
+extern double RECOVERY_TOLERANCE;               ///< relative band around steady latency of scenario phase to count as recovered
+extern ULL REDUCE_COMBINE_CYCLES;               ///< cycles to combine two packets of a reduction (router or root)
+extern UI REORDER_BUFFER;                       ///< capacity of reorder buffer of receiving core (in packets), 0 - unlimited
 
 extern UI NUM_BUFS;		                        ///< buffer depth (number of buffers in i/p channel fifo)
 extern UI HALF_NUM_BUFS;                        ///< half of maximum numbers of flits that can be placed in buffers
@@ -34,6 +34,12 @@
 #include "../config/constants.h"
 #include "flit.h"
 #include "credit.h"
+#include "histogram.h"
+#include "flow_stats.h"
+#include "burst_meter.h"
+#include "reorder_buffer.h"
+#include "vc_state.h"
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////
 /// \brief Abstract class to represent network tile.
@@ -75,6 +81,7 @@ struct BaseNWTile : public sc_module {
 	virtual double return_avg_num_waits()             = 0;      ///< returns average number of clocks waited by flit
 	virtual double return_avg_num_sw()                = 0;      ///< returns average number of switch travelled by flit
     virtual double return_bufs_util()                 = 0;      ///< returns buffers utilization by current tile
+    virtual ULL    return_total_bufs_occ()            = 0;      ///< returns accumulated number of occupied buffers (sum over cycles)
     virtual double return_vcs_util()                  = 0;      ///< returns VCs utilization by current tile
     virtual double return_avr_latency_unrouted()      = 0;      ///< returns average latency of unrouted flits
     virtual ULL    return_wc_latency_unrouted()       = 0;      ///< returns worst-case latency of unrouted flits
@@ -83,7 +90,31 @@ struct BaseNWTile : public sc_module {
     virtual ULL    return_send_packets_number()       = 0;		///< returns send packet number by current tile
     virtual ULL    return_send_flits_number()         = 0;		///< returns send flits number by current flit
     virtual ULL    return_recv_packets_number()       = 0;		///< returns received packets number by current flit 
+    virtual ULL    return_injected_flits()            = 0;		///< returns flits accepted by core input channel from core
     virtual ULL    return_recv_flits_number()         = 0;		///< returns received flits number by current flit
+    virtual bool   return_send_finished()             = 0;      ///< returns true if core finished generation (or there is no core)
+    virtual double return_offered_load()              = 0;      ///< returns offered load of core by its schedule (flits per cycle)
+    virtual ULL    return_source_lag()                = 0;      ///< returns number of cycles core generation is behind its schedule
+    virtual ULL    return_total_queue_latency()       = 0;      ///< returns total source queueing latency of received flits
+    virtual ULL    return_total_net_latency()         = 0;      ///< returns total network latency of received flits
+    virtual ULL    return_inj_queue_max()             = 0;      ///< returns largest occupancy of source injection queue (in flits)
+    virtual ULL    return_transactions()              = 0;      ///< returns completed transactions of closed-loop application
+    virtual ULL    return_measured_packets_sent()     = 0;      ///< returns packets generated inside measurement window by current tile
+    virtual ULL    return_measured_packets_recv()     = 0;      ///< returns received measured packets by current tile
+    virtual ULL    return_measured_flits_recv()       = 0;      ///< returns received measured flits by current tile
+    virtual ULL    return_measured_latency()          = 0;      ///< returns total latency of received measured packets
+    virtual ULL    return_measured_latency_flit()     = 0;      ///< returns total latency of received measured flits
+    
+    //core distributions
+    virtual histogram* return_histogram(UI)           = 0;      ///< returns distribution of given hist_type for a core (NULL if no core)
+    virtual histogram* return_flow_histogram(UI)      = 0;      ///< returns packet latency distribution from given source tile (NULL if none)
+    virtual flow_table* return_flows()                = 0;      ///< returns per source statistics of received traffic (NULL if no core)
+    virtual void   report_app(ofstream&)              = 0;      ///< writes application specific results of core
+    virtual burst_meter* return_burstiness()          = 0;      ///< returns burstiness of traffic generated by core (NULL if no core)
+    virtual reorder_buffer* return_reorder()          = 0;      ///< returns reorder buffer of receiving core (NULL if no core)
+    
+    //deadlock watchdog
+    virtual UI     return_vc_states(ULL, vector<vc_state>&) = 0; ///< appends VCs whose front flit did not move for given cycles
       
     //Additional functionality
     virtual UI     getportid(UI)                      = 0;      ///< returns id corresponding to a port direction (N, S, E, W)
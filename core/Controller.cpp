@@ -136,12 +136,25 @@ void Controller<num_nb, num_ip>::allocate_route() {
 				UI dest = destRequest[i].read();
 				UI ip_dir = idToDir(i);
                 routing_fault_info rfi = faultInfoIn[i].read();
-                UI op_dir = rtable->calc_next(ip_dir, src, dest, &rfi);
+                UI op_dir = rt_lookup.lookup(ip_dir, dest);
+                if (op_dir == RT_TABLE_NONE)
+                    op_dir = rtable->calc_next(ip_dir, src, dest, &rfi);
                 
                 faultInfoOut[i].write(rfi);               
 				rtReady[i].write(true);
 				nextRt[i].write(op_dir);
 			}
+			if(rtRequest[i].event() && rtRequest[i].read() == MCAST_ROUTE) { // multicast routing request
+				UI src = sourceAddress[i].read();
+				UI dest = destRequest[i].read();
+				UI ip_dir = idToDir(i);
+				UI target = dest & 0xFF;
+				UI dirs = rtable->calc_multicast(ip_dir, src, dest >> 24, (dest >> 8) & 0xFFFF, &target);
+				
+				faultInfoOut[i].write(faultInfoIn[i].read());
+				rtReady[i].write(true);
+				nextRt[i].write(dirs | (target << 8));
+			}
 			// request from IC to update //////////////////////////
 			if(rtRequest[i].event() && rtRequest[i].read() == UPDATE) {
 				UI src = sourceAddress[i].read();
@@ -217,6 +230,14 @@ void Controller<num_nb, num_ip>::setTileID(UI id, UI port_N, UI port_S, UI port_
         
     //init
     rtable->init_congestion_flags(congestion_flags_arr);
+    
+    // routing table replaces calls of deterministic algorithm (not for source routing, destination is route code)
+    if (RT_ALGO != SOURCE && rtable->is_deterministic()) {
+        rt_lookup.build(rtable, tileID);
+        if (LOG >= 4)
+            eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tileID:"<<tileID<<" routing table of "
+                    <<rt_lookup.next.size()<<" bytes"<<endl;
+    }
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -267,6 +288,7 @@ UI Controller<num_nb, num_ip>::dirToId(UI port_dir) {
 template<UI num_nb, UI num_ip>
 void Controller<num_nb, num_ip>::set_router_fail_dir(UI dir, bool fail) {
     rtable->set_router_fail_dir(dir, fail);
+    rt_lookup.clear();	// fault state may change routes, algorithm is called from now on
 }
 
 ///////////////////////////////////////////////////////////////////
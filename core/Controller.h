@@ -34,6 +34,7 @@
 #include "credit.h"
 #include "../config/constants.h"
 #include "router.h"
+#include "route_table.h"
 #include <string>
 #include <fstream>
 #include <iostream>
@@ -96,6 +97,7 @@ struct Controller : public sc_module {
     bool    congestion_flags_arr[5];    ///< congestion flags from adjancent routers 
 	
 	router  *rtable;	                ///< router (plug-in point for routing algorithm)
+	route_table rt_lookup;	            ///< next hops precomputed from deterministic routing algorithm
 	// VARIABLES END /////////////////////////////////////////////////////////////////////////
 };
 
@@ -28,6 +28,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "InputChannel.h"
+#include "multicast.h"
 #include "../config/extern.h"
 
 //////////////////////////////////
@@ -37,6 +38,7 @@ template<UI num_op>
 InputChannel<num_op>::InputChannel(sc_module_name InputChannel): sc_module(InputChannel), rr_arbiter_route("RR_R"), rr_arbiter_transmit("RR_T") {
 
     sim_count = 0;
+    flits_in = 0;
     
 	// process sensitive to inport event, reads in flit and stores in buffer
 	SC_THREAD(read_flit);
@@ -88,6 +90,14 @@ InputChannel<num_op>::InputChannel(sc_module_name InputChannel): sc_module(Input
 	for(UI i=0; i < NUM_VCS ; i++) {
 		vc[i].vc_route = 5;
 		vc[i].vc_next_id = NUM_VCS + 1;
+		vc[i].mcast_mode = MCAST_NONE;
+		vc[i].mcast_dirs = 0;
+		vc[i].mcast_left = 0;
+		vc[i].mcast_target = MCAST_NO_TARGET;
+		for(UI d = 0; d < ND; d++)
+			vc[i].mcast_next_id[d] = NUM_VCS + 1;
+		vc[i].red_absorb = false;
+		vc[i].red_ready = 0;
 	}
     
     //init timewaits
@@ -97,6 +107,8 @@ InputChannel<num_op>::InputChannel(sc_module_name InputChannel): sc_module(Input
         served_r[i] = false;
         not_empty_r[i] = false;
         not_empty_t[i] = false;
+        head_key[i] = 0;
+        head_since[i] = 0;
     }
 
 	// reset buffer counts to zero
@@ -145,6 +157,7 @@ void InputChannel<num_op> :: read_flit() {
 
 			case NOC:
 				store_flit_VC(&flit_in);	// store flit in buffer
+				flits_in++;
 				break;
 	
 			} // end switch pkt type
@@ -275,7 +288,10 @@ void InputChannel<num_op> :: route_flit() {
 							routing_type rt = flit_out.pkthdr.nochdr.flithdr.header.rtalgo;
 							routing_hdr *rt_hdr = &(flit_out.pkthdr.nochdr.flithdr.header.rthdr);
                             
-							if(rt == SOURCE) {
+							if(mcast_in_network(flit_out.pkthdr.nochdr.flithdr.header.mcast.mode)) {
+								routing_mcast(&flit_out);
+							}
+							else if(rt == SOURCE) {
 								routing_src(&flit_out);
 							}
 							else {
@@ -396,6 +412,18 @@ void InputChannel<num_op> :: transmit_flit() {
 				continue;
 			}
 			
+			if(vc[vc_to_serve].red_absorb) {	// reduction packet combined by this router
+				absorb_flit(vc_to_serve);
+				inc_vcs_num_waits();
+				continue;
+			}
+			
+			if(vc[vc_to_serve].mcast_dirs != 0) {	// packet replicated to several output ports
+				transmit_multicast(vc_to_serve);
+				inc_vcs_num_waits();
+				continue;
+			}
+			
 			// Routing decision has been made, proceed to transmission
 			UI i;
 			switch(TOPO) {
@@ -501,6 +529,8 @@ void InputChannel<num_op> :: transmit_flit() {
 					flit_out.simdata.num_sw++;
 					flit_out.simdata.ctime = sc_time_stamp();
 					outport[i].write(flit_out);
+					if(vc[vc_to_serve].mcast_mode != MCAST_NONE && i != num_op - 1)	// unicast emulation of multicast
+						multicast.add_link_flit(vc[vc_to_serve].mcast_mode);
 					
 					if(LOG >= 2)
 						eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" cntrlID: "<<cntrlID<<" Transmitting flit to output port: "<<i<<" "<<flit_out<<endl;
@@ -519,6 +549,7 @@ void InputChannel<num_op> :: transmit_flit() {
 						credit_out[vc_to_serve].write(t);
 						//if(cntrlID == C)
                         vc[vc_to_serve].vc_route = 5;
+                        vc[vc_to_serve].mcast_mode = MCAST_NONE;
                         //flit served!
                         served_r[vc_to_serve] = false; 
 					}
@@ -622,6 +653,7 @@ void InputChannel<num_op>::routing_src(flit *flit_in) {
 	
 	vc[vc_id].vc_route = nextRt.read();
     vc[vc_id].new_rfi  = faultInfoIn.read();
+	vc[vc_id].mcast_mode = flit_in->pkthdr.nochdr.flithdr.header.mcast.mode;
 	rtRequest.write(NONE);
 }
 
@@ -649,9 +681,211 @@ void InputChannel<num_op>::routing_dst(flit *flit_in) {
 	}
 	vc[vc_id].vc_route = nextRt.read();
     vc[vc_id].new_rfi  = faultInfoIn.read();
+	vc[vc_id].mcast_mode = flit_in->pkthdr.nochdr.flithdr.header.mcast.mode;
 	rtRequest.write(NONE);
 }
 
+///////////////////////////////////////////////////////////////////////////
+/// Method to call controller for multicast packets replicated in routers
+/// \param flit_in HDT/HEAD flit to route
+///
+/// Controller returns set of output directions, flits are then copied to
+/// each of them by transmit_multicast. Reduction packets are registered
+/// at the router: all but the last expected one are consumed, the last one
+/// leaves after combine latency.
+///////////////////////////////////////////////////////////////////////////
+template<UI num_op>
+void InputChannel<num_op>::routing_mcast(flit *flit_in) {
+	UI vc_id = flit_in->vcid;
+	mcast_hdr &hdr = flit_in->pkthdr.nochdr.flithdr.header.mcast;
+	rtRequest.write(MCAST_ROUTE);
+	sourceAddress.write(flit_in->src);
+	destRequest.write((hdr.mode << 24) | ((hdr.group & 0xFFFF) << 8) | (hdr.target & 0xFF));
+    faultInfoOut.write(flit_in->pkthdr.nochdr.flithdr.header.rtfi);
+	if(LOG >= 4)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" IC: multicast rtRequest sent!"<<endl;
+	wait();
+	if(rtReady.event()) {
+		if(LOG >= 4)
+			eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" IC: rtReady event..."<<endl;
+	}
+	else if(switch_cntrl.event()) {
+		if(LOG >= 4)
+			eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" IC: unknown clock event..."<<endl;
+	}
+	UI reply = nextRt.read();
+	UI dirs = reply & ((1 << ND) - 1);
+	if(dirs == 0) {	// error in multicast group, deliver to core rather than block VC
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" Error in multicast routing! No direction for group "<<hdr.group<<endl;
+		dirs = 1 << C;
+	}
+	vc[vc_id].mcast_mode   = hdr.mode;
+	vc[vc_id].mcast_dirs   = dirs;
+	vc[vc_id].mcast_left   = dirs;
+	vc[vc_id].mcast_target = reply >> 8;
+	vc[vc_id].vc_route     = C;	// routed, actual directions in mcast_dirs
+    vc[vc_id].new_rfi      = faultInfoIn.read();
+	vc[vc_id].red_absorb   = false;
+	vc[vc_id].red_ready    = 0;
+	if(hdr.mode == MCAST_REDUCE) {
+		reduce_action act = multicast.reduce_arrive(hdr.seq, hdr.group, hdr.target, tileID);
+		vc[vc_id].red_absorb = (act == REDUCE_ABSORB);
+		if(act == REDUCE_COMBINED)
+			vc[vc_id].red_ready = sim_count + REDUCE_COMBINE_CYCLES;
+		if(LOG >= 4)
+			eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" IC: reduction "<<hdr.seq<<" action "<<act<<endl;
+	}
+	rtRequest.write(NONE);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// Method to return output port for direction
+/// \param dir direction (N, S, E, W, C)
+/// \return port id
+///////////////////////////////////////////////////////////////////////////
+template<UI num_op>
+UI InputChannel<num_op>::dirToPort(UI dir) {
+	if(TOPO == TORUS)
+		return dir;
+	switch(dir) {
+		case N: return portN;
+		case S: return portS;
+		case E: return portE;
+		case W: return portW;
+	}
+	return num_op - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// Method to copy flit at front of fifo to one output port of multicast packet
+/// \param vc_id virtual channel holding multicast packet
+///
+/// - one copy per clock cycle, to first ready direction the flit has not been sent to
+/// - head flit requests a VC on every branch, branches keep it until tail
+/// - flit leaves fifo (and credit is returned) after copies to all branches
+///////////////////////////////////////////////////////////////////////////
+template<UI num_op>
+void InputChannel<num_op>::transmit_multicast(UI vc_id) {
+	VC &v = vc[vc_id];
+	if(v.vcQ.empty)
+		return;
+	
+	UI dir = ND;
+	for(UI d = 0; d < ND; d++)
+		if((v.mcast_left & (1 << d)) && outReady[dirToPort(d)].read()) {
+			dir = d;
+			break;
+		}
+	if(dir == ND) {
+		if(LOG >= 4)
+			eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" IC: no OC of multicast packet can accept flit!"<<endl;
+		return;
+	}
+	UI i = dirToPort(dir);
+	
+	flit flit_out = v.vcQ.flit_read();	// copy of flit, stays in fifo until all branches are served
+	bool head = (flit_out.pkthdr.nochdr.flittype == HEAD || flit_out.pkthdr.nochdr.flittype == HDT);
+	if(head && sim_count < v.red_ready)	// reduction packets still being combined
+		return;
+	if(i != num_op - 1 && v.mcast_next_id[dir] == NUM_VCS + 1) {
+		if(!head) {
+			if(LOG >= 0)
+				eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" IC: multicast flit is not a head and has no VC..Error"<<endl;
+			return;
+		}
+		// VC request for this branch
+		vcRequest.write(true);
+		opRequest.write(i);
+		wait();	// wait for ready event from VC
+		if(vcReady.event()) {
+			if(LOG >= 4)
+				eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" IC: vcReady event..."<<endl;
+		}
+		v.mcast_next_id[dir] = nextVCID.read();
+		vcRequest.write(false);
+		if(v.mcast_next_id[dir] == NUM_VCS + 1) {	// VC not granted, retry next cycle
+			if(LOG >= 4)
+				eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" IC: No free next vc for multicast branch "<<dir<<endl;
+			return;
+		}
+	}
+	
+	if(i != num_op - 1)
+		flit_out.vcid = v.mcast_next_id[dir];
+	if(head) {
+		flit_out.pkthdr.nochdr.flithdr.header.rtfi = v.new_rfi;
+		if(dir != C)	// worm continues to its next destination
+			flit_out.pkthdr.nochdr.flithdr.header.mcast.target = v.mcast_target;
+	}
+	flit_out.simdata.num_sw++;
+	flit_out.simdata.ctime = sc_time_stamp();
+	outport[i].write(flit_out);
+	if(i != num_op - 1)
+		multicast.add_link_flit(v.mcast_mode);
+	v.mcast_left &= ~(1 << dir);
+	
+	if(LOG >= 2)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" cntrlID: "<<cntrlID<<" Replicating flit to output port: "<<i<<" "<<flit_out<<endl;
+	
+	if(v.mcast_left != 0) {
+		multicast.replicated_flits++;	// flit stays for another branch, this one was a copy
+		return;
+	}
+	
+	// all branches served, flit leaves buffer
+	v.vcQ.flit_out();
+	numBufReads++;
+	stress_value--;
+	if(flit_out.pkthdr.nochdr.flittype == TAIL || flit_out.pkthdr.nochdr.flittype == HDT) {
+		creditLine t; t.freeVC = true; t.freeBuf = true;
+		credit_out[vc_id].write(t);
+		v.vc_route = 5;
+		v.mcast_mode = MCAST_NONE;
+		v.mcast_dirs = 0;
+		for(UI d = 0; d < ND; d++)
+			v.mcast_next_id[d] = NUM_VCS + 1;
+		served_r[vc_id] = false;
+	}
+	else {
+		creditLine t; t.freeVC = false; t.freeBuf = true;
+		credit_out[vc_id].write(t);
+		v.mcast_left = v.mcast_dirs;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// Method to consume flit of reduction packet combined into another one
+/// \param vc_id virtual channel holding reduction packet
+///
+/// one flit per clock cycle, credits are returned as if it was forwarded
+///////////////////////////////////////////////////////////////////////////
+template<UI num_op>
+void InputChannel<num_op>::absorb_flit(UI vc_id) {
+	VC &v = vc[vc_id];
+	if(v.vcQ.empty)
+		return;
+	flit flit_out = v.vcQ.flit_out();
+	numBufReads++;
+	stress_value--;
+	multicast.add_absorbed_flit(v.mcast_mode);
+	if(LOG >= 2)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" cntrlID: "<<cntrlID<<" Combining reduction flit: "<<flit_out<<endl;
+	
+	if(flit_out.pkthdr.nochdr.flittype == TAIL || flit_out.pkthdr.nochdr.flittype == HDT) {
+		creditLine t; t.freeVC = true; t.freeBuf = true;
+		credit_out[vc_id].write(t);
+		v.vc_route = 5;
+		v.mcast_mode = MCAST_NONE;
+		v.mcast_dirs = 0;
+		v.red_absorb = false;
+		served_r[vc_id] = false;
+	}
+	else {
+		creditLine t; t.freeVC = false; t.freeBuf = true;
+		credit_out[vc_id].write(t);
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////
 /// Method to track clocks count and update router's stress value
 ///////////////////////////////////////////////////////////////////////////
@@ -659,6 +893,23 @@ template<UI num_op>
 void InputChannel<num_op>::processIntLogic(){
    sim_count++;
    stress_value_int_out.write(stress_value);
+   
+   // track progress of front flits for deadlock watchdog
+   if (WATCHDOG_CYCLES > 0) {
+       for (UI i = 0; i < NUM_VCS; i++) {
+           if (vc[i].vcQ.empty) {
+               head_key[i] = 0;
+               head_since[i] = sim_count;
+               continue;
+           }
+           const flit &front = vc[i].vcQ.regs[0];
+           ULL key = ((ULL)(front.src + 1) << 48) | ((ULL)(front.pkthdr.nochdr.pktid & 0xFFFFFFFF) << 16) | (front.pkthdr.nochdr.flitid & 0xFFFF);
+           if (key != head_key[i]) {
+               head_key[i] = key;
+               head_since[i] = sim_count;
+           }
+       }
+   }
 }
 
 ///////////////////////////////////////////////////////////////////////////
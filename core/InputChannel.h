@@ -53,6 +53,13 @@ struct  VC {
 	UI		            vc_route;	    ///< routing decision (next hop) for the flits stored in this VC
     routing_fault_info  new_rfi;        ///< routing fault info structure (routing_fault_info)
 	fifo			    vcQ;		    ///< buffer (fifo queue)
+	UI                  mcast_mode;     ///< multicast mode of packet in this VC (MCAST_NONE for unicast)
+	UI                  mcast_dirs;     ///< output directions of replicated packet (bit per direction), 0 if not replicated
+	UI                  mcast_left;     ///< directions the front flit has not been copied to yet
+	UI                  mcast_target;   ///< next destination written to forwarded head of path-based worm
+	UI                  mcast_next_id[ND]; ///< virtual channel id on next tile for each direction of replicated packet
+	bool                red_absorb;     ///< reduction packet is combined into another one, its flits are consumed
+	ULL                 red_ready;      ///< cycle combined reduction packet may leave (combine latency)
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -102,7 +109,11 @@ struct InputChannel : public sc_module {
 	void route_flit();		    ///< routes the flit at the front of fifo buffer
 	void routing_src(flit*);	///< routing function for algorithms containing entire path in header (source routing)
 	void routing_dst(flit*);	///< routing function for algorithms containing destination address in header
+	void routing_mcast(flit*);	///< routing function for multicast packets replicated in routers
 	void transmit_flit();		///< transmits flit at the front of fifo to output port
+	void transmit_multicast(UI vc_id); ///< copies flit at the front of fifo to next output port of multicast packet
+	void absorb_flit(UI vc_id);	///< consumes flit at the front of fifo of reduction packet combined by router
+	UI   dirToPort(UI dir);		///< returns output port for direction
 	void setTileID(UI tileID, UI portN, UI portS, UI portE, UI portW); ///< sets tile ID and id corresponding to port directions
 	void resetCounts();		    ///< resets buffer counts to zero
     void processIntLogic();     ///< track clocks count and update router's stress value
@@ -129,6 +140,9 @@ struct InputChannel : public sc_module {
 	UI	    numVCOcc;	            ///< number of occupied virtual channels
 	ULL     sim_count;	            ///< keeps track of number of clock cycles
     UI      stress_value;           ///< stress value of current router
+    ULL     head_key[NUM_VCS];      ///< identity (src, pktid, flitid) of flit at the front of VC, for watchdog
+    ULL     head_since[NUM_VCS];    ///< cycle since which the same flit is at the front of VC
+    ULL     flits_in;               ///< NoC flits read from inport (core channel: flits accepted from core)
 	// VARIABLES END /////////////////////////////////////////////////////////////////////////
     
     // SIGNALS //////////////////////////////////////////////////////////////////////////////
@@ -67,6 +67,8 @@ NWTile<num_nb, num_ic, num_oc>::NWTile(sc_module_name NWTile, UI id): BaseNWTile
     }
     for (UI i = 0; i < NUM_VCS; i++)
         congestion_status_false[i].write(false);
+    core_ready.write(true);     // tile without ipcore never blocks ejection
+    ready_true.write(true);
     
 	for(UI i = 0; i < num_ic; i++) {
 		char name[4];
@@ -247,10 +249,14 @@ NWTile<num_nb, num_ic, num_oc>::NWTile(sc_module_name NWTile, UI id): BaseNWTile
 			Ochannel[i]->inport[j](flit_sig[j][i]);	// data (flit) input from IC
 			Ochannel[i]->inReady[j](rdy[j][i]);	// ready signal to IC
 		}
-		if(i == num_oc - 1)
+		if(i == num_oc - 1) {
 			Ochannel[i]->outport(flit_OC_CR);	// data (flit) output to core
-		else
+			Ochannel[i]->outReady(core_ready);	// ready signal from core
+		}
+		else {
 			Ochannel[i]->outport(op_port[i]);	// data (flit) output to output port (connects to neighbor tile)
+			Ochannel[i]->outReady(ready_true);	// not used, neighbor readiness is given by credit info
+		}
 		// credit info and congestion statuses from IC 
 		for(UI j = 0; j < NUM_VCS; j++) {
 			if(i == num_oc - 1) {
@@ -275,6 +281,9 @@ NWTile<num_nb, num_ic, num_oc>::NWTile(sc_module_name NWTile, UI id): BaseNWTile
 		// data (flit) output to core IC
 		ip->flit_outport(flit_CS_IC);
 	
+		// ready signal to core OC
+		ip->eject_ready(core_ready);
+	
 		// credit info from core IC
 		for(UI i = 0; i < NUM_VCS; i++)
 			ip->credit_in[i](creditIC_CS[i]);
@@ -317,6 +326,7 @@ template <UI num_nb, UI num_ic, UI num_oc>
 void NWTile<num_nb, num_ic, num_oc>::resetCounts() {
     totBufsOcc = 0;
     totVCOcc = 0;
+    numCycles = 0;
     avr_latency_unrouted = 0.0;
     wc_latency_unrouted = 0.0;
     bufUtil = 0.0;
@@ -331,6 +341,7 @@ template <UI num_nb, UI num_ic, UI num_oc>
 void NWTile<num_nb, num_ic, num_oc>::entry() {
 	while(true) {
 		wait();
+		numCycles++;
 
 		//writing out instantaneous buffer utilization
  		ULL totBufReads = 0;
@@ -437,8 +448,10 @@ void NWTile<num_nb, num_ic, num_oc>::closeLogs() {
 		Ochannel[i]->closeLogs();
     if (ip != NULL)
         ip->closeLogs();
-    bufUtil = (double)totBufsOcc/(NUM_VCS * NUM_BUFS * num_ic *(SIM_NUM - WARMUP));
-	vcUtil = (double)totVCOcc/(NUM_VCS * num_ic * (SIM_NUM - WARMUP));
+    // simulation may end before SIM_NUM (automatic stop), so use number of simulated cycles
+    ULL cycles = (numCycles > WARMUP) ? (numCycles - WARMUP) : 1;
+    bufUtil = (double)totBufsOcc/(NUM_VCS * NUM_BUFS * num_ic * cycles);
+	vcUtil = (double)totVCOcc/(NUM_VCS * num_ic * cycles);
     
     ULL unrouter_flits_number = 0;    // walk through the overall NoC and count unrouted flits
     ULL unrouted_wait_time = 0;
@@ -451,7 +464,7 @@ void NWTile<num_nb, num_ic, num_oc>::closeLogs() {
             if (!Ichannel[i]->vc[j].vcQ.empty) {
                 pntr = Ichannel[i]->vc[j].vcQ.pntr;
                 for (UI k = 0; k < pntr; k++) {
-                    unrouted_wait_time = SIM_NUM - Ichannel[i]->vc[j].vcQ.flit_debug_read(k).simdata.gtimestamp;
+                    unrouted_wait_time = numCycles - Ichannel[i]->vc[j].vcQ.flit_debug_read(k).simdata.gtimestamp;
                     unrouted_wait_time_all += unrouted_wait_time;
                     if (unrouted_wait_time > unrouted_wait_time_wc)
                         unrouted_wait_time_wc = unrouted_wait_time;
@@ -462,7 +475,7 @@ void NWTile<num_nb, num_ic, num_oc>::closeLogs() {
     for (UI i = 0; i < num_oc; i++) {         // OChannels registers
         for (UI j = 0; j < num_ic; j++) 
             if (!Ochannel[i]->r_in[j].free) {
-                unrouted_wait_time = SIM_NUM - Ochannel[i]->r_in[j].val.simdata.gtimestamp;
+                unrouted_wait_time = numCycles - Ochannel[i]->r_in[j].val.simdata.gtimestamp;
                 unrouted_wait_time_all += unrouted_wait_time;
                 if (unrouted_wait_time > unrouted_wait_time_wc)
                     unrouted_wait_time_wc = unrouted_wait_time;
@@ -471,7 +484,7 @@ void NWTile<num_nb, num_ic, num_oc>::closeLogs() {
             
         for (UI j = 0; j < NUM_VCS; j++)     // OChannel VCs
             if (!Ochannel[i]->r_vc[j].free) {
-                unrouted_wait_time = SIM_NUM - Ochannel[i]->r_vc[j].val.simdata.gtimestamp;
+                unrouted_wait_time = numCycles - Ochannel[i]->r_vc[j].val.simdata.gtimestamp;
                 unrouted_wait_time_all += unrouted_wait_time;
                 if (unrouted_wait_time > unrouted_wait_time_wc)
                     unrouted_wait_time_wc = unrouted_wait_time;
@@ -671,6 +684,15 @@ ULL NWTile<num_nb, num_ic, num_oc>::return_send_flits_number() {
     return res;
 }
 
+/////////////////////////////////////////////////////////////////
+/// returns flits accepted by core input channel from core
+/// (counted by network, also for applications writing flits directly)
+/////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+ULL NWTile<num_nb, num_ic, num_oc>::return_injected_flits() {
+    return Ichannel[num_ic - 1]->flits_in;
+}
+
 /////////////////////////////////////////////////////////////////
 /// returns received packets number by current flit
 ////////////////////////////////////////////////////////////////
@@ -693,6 +715,216 @@ ULL NWTile<num_nb, num_ic, num_oc>::return_recv_flits_number() {
     return res;
 }
 
+/////////////////////////////////////////////////////////////////
+/// returns distribution of given type (hist_type) for a core
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+histogram* NWTile<num_nb, num_ic, num_oc>::return_histogram(UI type) {
+    histogram *res = NULL;
+    if (ip != NULL && type < HIST_NUM_TYPES)
+        res = &(ip->hist[type]);
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns packet latency distribution from given source tile
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+histogram* NWTile<num_nb, num_ic, num_oc>::return_flow_histogram(UI src) {
+    histogram *res = NULL;
+    if (ip != NULL && src < MAX_NUM_TILES)
+        res = ip->hist_flow[src];
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns per source statistics of received traffic
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+flow_table* NWTile<num_nb, num_ic, num_oc>::return_flows() {
+    flow_table *res = NULL;
+    if (ip != NULL)
+        res = &(ip->flows);
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// writes application specific results of core
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+void NWTile<num_nb, num_ic, num_oc>::report_app(ofstream &out) {
+    if (ip != NULL)
+        ip->report(out);
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns burstiness of traffic generated by core
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+burst_meter* NWTile<num_nb, num_ic, num_oc>::return_burstiness() {
+    burst_meter *res = NULL;
+    if (ip != NULL)
+        res = &(ip->burst);
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns reorder buffer of receiving core
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+reorder_buffer* NWTile<num_nb, num_ic, num_oc>::return_reorder() {
+    reorder_buffer *res = NULL;
+    if (ip != NULL)
+        res = &(ip->rob);
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns accumulated number of occupied buffers (sum over cycles)
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+ULL NWTile<num_nb, num_ic, num_oc>::return_total_bufs_occ() {
+    return totBufsOcc;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns true if core finished generation (or there is no core)
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+bool NWTile<num_nb, num_ic, num_oc>::return_send_finished() {
+    bool res = true;
+    if (ip != NULL)
+        res = ip->send_finished;
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns offered load of core by its schedule (flits per cycle)
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+double NWTile<num_nb, num_ic, num_oc>::return_offered_load() {
+    double res = 0.0;
+    if (ip != NULL && ip->sched_active && ip->sched_time > ip->sched_start)
+        res = (double)ip->sched_flits / (ip->sched_time - ip->sched_start);
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns number of cycles core generation is behind its schedule
+/// (age of oldest flit in injection queue, or delay of generation)
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+ULL NWTile<num_nb, num_ic, num_oc>::return_source_lag() {
+    ULL res = 0;
+    if (ip == NULL || !ip->sched_active || ip->send_finished)
+        return res;
+    ULL oldest = ip->sched_time;
+    if (!ip->inj_queue.empty())
+        oldest = ip->inj_queue.front().simdata.gtimestamp;
+    if (ip->sim_count > oldest)
+        res = ip->sim_count - oldest;
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns total source queueing latency of received flits
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+ULL NWTile<num_nb, num_ic, num_oc>::return_total_queue_latency() {
+    ULL res = 0;
+    if (ip != NULL)
+        res = ip->total_queue_latency;
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns total network latency of received flits
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+ULL NWTile<num_nb, num_ic, num_oc>::return_total_net_latency() {
+    ULL res = 0;
+    if (ip != NULL)
+        res = ip->total_net_latency;
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns largest occupancy of source injection queue (in flits)
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+ULL NWTile<num_nb, num_ic, num_oc>::return_inj_queue_max() {
+    ULL res = 0;
+    if (ip != NULL)
+        res = ip->inj_queue_max;
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns completed transactions of closed-loop application
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+ULL NWTile<num_nb, num_ic, num_oc>::return_transactions() {
+    ULL res = 0;
+    if (ip != NULL)
+        res = ip->transactions;
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns packets generated inside measurement window by current tile
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+ULL NWTile<num_nb, num_ic, num_oc>::return_measured_packets_sent() {
+    ULL res = 0;
+    if (ip != NULL)
+        res = ip->measured_pkts_gen;
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns received measured packets by current tile
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+ULL NWTile<num_nb, num_ic, num_oc>::return_measured_packets_recv() {
+    ULL res = 0;
+    if (ip != NULL)
+        res = ip->measured_pkts_recv;
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns received measured flits by current tile
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+ULL NWTile<num_nb, num_ic, num_oc>::return_measured_flits_recv() {
+    ULL res = 0;
+    if (ip != NULL)
+        res = ip->measured_flits_recv;
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns total latency of received measured packets
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+ULL NWTile<num_nb, num_ic, num_oc>::return_measured_latency() {
+    ULL res = 0;
+    if (ip != NULL)
+        res = ip->measured_latency;
+    return res;
+}
+
+/////////////////////////////////////////////////////////////////
+/// returns total latency of received measured flits
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+ULL NWTile<num_nb, num_ic, num_oc>::return_measured_latency_flit() {
+    ULL res = 0;
+    if (ip != NULL)
+        res = ip->measured_latency_flit;
+    return res;
+}
+
 /////////////////////////////////////////////////////////////////
 /// returns average latency per packet for a core
 ////////////////////////////////////////////////////////////////
@@ -824,6 +1056,43 @@ ULL NWTile<num_nb, num_ic, num_oc>::return_wc_latency_unrouted() {
     return wc_latency_unrouted;
 }
 
+/////////////////////////////////////////////////////////////////
+/// collects state of VCs whose front flit did not move for a long time
+/// \param min_stuck minimum number of cycles front flit must stay in VC
+/// \param states vector to which VC states are appended
+/// \return number of appended VC states
+////////////////////////////////////////////////////////////////
+template <UI num_nb, UI num_ic, UI num_oc>
+UI NWTile<num_nb, num_ic, num_oc>::return_vc_states(ULL min_stuck, vector<vc_state> &states) {
+    UI res = 0;
+    for(UI i = 0; i < num_ic; i++) {
+        for(UI j = 0; j < NUM_VCS; j++) {
+            if(Ichannel[i]->vc[j].vcQ.empty)
+                continue;
+            ULL stuck = Ichannel[i]->sim_count - Ichannel[i]->head_since[j];
+            if(stuck < min_stuck)
+                continue;
+            const flit &front = Ichannel[i]->vc[j].vcQ.regs[0];
+            vc_state st;
+            st.tile         = tileID;
+            st.port_dir     = getportdir(i);
+            st.vc           = j;
+            st.route        = Ichannel[i]->vc[j].vc_route;
+            st.next_vc      = Ichannel[i]->vc[j].vc_next_id;
+            st.num_flits    = Ichannel[i]->vc[j].vcQ.pntr;
+            st.stuck_cycles = stuck;
+            st.src          = front.src;
+            st.pktid        = front.pkthdr.nochdr.pktid;
+            st.flitid       = front.pkthdr.nochdr.flitid;
+            st.hopcount     = front.pkthdr.nochdr.hopcount;
+            st.flittype     = front.pkthdr.nochdr.flittype;
+            states.push_back(st);
+            res++;
+        }
+    }
+    return res;
+}
+
 template struct NWTile<NUM_NB, NUM_IC, NUM_OC>;
 template struct NWTile<NUM_NB_B, NUM_IC_B, NUM_OC_B>;
 template struct NWTile<NUM_NB_C, NUM_IC_C, NUM_OC_C>;
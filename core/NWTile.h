@@ -120,7 +120,32 @@ struct NWTile : public BaseNWTile {
     ULL     return_send_packets_number();   ///< returns send packet number by current tile
     ULL     return_send_flits_number();     ///< returns send flits number by current flit
     ULL     return_recv_packets_number();	///< returns received packets number by current flit
+    ULL     return_injected_flits();        ///< returns flits accepted by core input channel from core
     ULL     return_recv_flits_number();		///< returns received flits number by current flit
+    bool    return_send_finished();         ///< returns true if core finished generation (or there is no core)
+    double  return_offered_load();          ///< returns offered load of core by its schedule (flits per cycle)
+    ULL     return_source_lag();            ///< returns number of cycles core generation is behind its schedule
+    ULL     return_total_queue_latency();   ///< returns total source queueing latency of received flits
+    ULL     return_total_net_latency();     ///< returns total network latency of received flits
+    ULL     return_inj_queue_max();         ///< returns largest occupancy of source injection queue (in flits)
+    ULL     return_transactions();          ///< returns completed transactions of closed-loop application
+    ULL     return_measured_packets_sent(); ///< returns packets generated inside measurement window by current tile
+    ULL     return_measured_packets_recv(); ///< returns received measured packets by current tile
+    ULL     return_measured_flits_recv();   ///< returns received measured flits by current tile
+    ULL     return_measured_latency();      ///< returns total latency of received measured packets
+    ULL     return_measured_latency_flit(); ///< returns total latency of received measured flits
+    
+    //core distributions
+    histogram* return_histogram(UI type);           ///< returns distribution of given hist_type for a core
+    histogram* return_flow_histogram(UI src);       ///< returns packet latency distribution from given source tile
+    flow_table* return_flows();                     ///< returns per source statistics of received traffic
+    void report_app(ofstream &out);                 ///< writes application specific results of core
+    burst_meter* return_burstiness();               ///< returns burstiness of traffic generated by core
+    reorder_buffer* return_reorder();               ///< returns reorder buffer of receiving core
+    ULL     return_total_bufs_occ();                ///< returns accumulated number of occupied buffers
+    
+    //deadlock watchdog
+    UI      return_vc_states(ULL min_stuck, vector<vc_state> &states);  ///< appends VCs whose front flit did not move for min_stuck cycles
     
     void resetCounts();                     ///< reset statistics
 	// PROCESS END /////////////////////////////////////////////////////////////////////////////////////
@@ -140,6 +165,10 @@ struct NWTile : public BaseNWTile {
 	sc_signal<flit>	flit_CS_IC;
 	/// \brief data line from output channel to ipcore
 	sc_signal<flit> flit_OC_CR;
+	/// \brief ready signal from ipcore to output channel (ejection backpressure)
+	sc_signal<bool> core_ready;
+	/// \brief ready signal for output channels to neighbor tiles (always true)
+	sc_signal<bool> ready_true;
 
 	/// \brief ready signals from ICs to OCs of neighboring tiles
 	sc_signal<bool>	rdy[num_ic][num_oc];
@@ -187,6 +216,7 @@ struct NWTile : public BaseNWTile {
     // VARIABLES //////////////////////////////////////////////////
     ULL     totBufsOcc;             ///< total number of buffers occupated
     ULL     totVCOcc;               ///< total number of VCs occupated
+    ULL     numCycles;              ///< number of simulated clock cycles
     double  avr_latency_unrouted;   ///< average latency of unrouted flits
     ULL     wc_latency_unrouted;    ///< worst-case latency of unrouted flits
     double  bufUtil;                ///< buffers utilization
@@ -33,6 +33,7 @@
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /// Constructor to generate topology.
@@ -52,6 +53,23 @@ NoC::NoC(sc_module_name NoC, UI num_rows, UI num_cols, bool isProgBar): sc_modul
 	rows            = num_rows;
 	cols            = num_cols;
     sim_count       = 0;
+    last_flits      = 0;
+    last_latency    = 0;
+    last_bufocc     = 0;
+    warmup_windows  = 0;
+    ci_reached      = false;
+    ci_mean         = 0.0;
+    ci_halfwidth    = 0.0;
+    measure_drained = false;
+    saturated       = false;
+    sat_cycle       = 0;
+    gen_done_cycle  = 0;
+    drained         = false;
+    drain_timed_out = false;
+    deadlock_cycle  = 0;
+    deadlock_abort  = false;
+    max_stuck_vcs   = 0;
+    livelock_pkts   = 0;
     drawProgressBar = isProgBar;
 	
 	for(UI i = 0; i < rows; i++) {
@@ -473,6 +491,50 @@ void NoC::entry() {
 			sim_count++;
             progress_bar_draw((double)SIM_NUM, (double)sim_count, 40);
             
+            if (STATS_WINDOW > 0 && sim_count % STATS_WINDOW == 0) {
+                sample_window();
+                // transient phases of scenario are still to come: keep running
+                bool phases_pending = scenario.pending(sim_count);
+                if (SAT_STOP && !phases_pending && saturation_reached()) {
+                    saturated = true;
+                    sat_cycle = sim_count;
+                    break;
+                }
+                if (AUTO_STOP && !phases_pending && steady_state_reached())
+                    break;
+            }
+            
+            // all packets of measurement window are delivered, nothing left to measure
+            if (MEASURE_WINDOW_ON && sim_count > MEASURE_END && measured_drained()) {
+                measure_drained = true;
+                break;
+            }
+            
+            // stuck VCs forming a cycle: report and optionally abort
+            if (WATCHDOG_CYCLES > 0 && sim_count % ((WATCHDOG_CYCLES > 1) ? WATCHDOG_CYCLES / 2 : 1) == 0) {
+                if (watchdog_check() && WATCHDOG_ABORT) {
+                    deadlock_abort = true;
+                    break;
+                }
+            }
+            
+            // traffic generation is over: stop once network is empty or drain timeout expires
+            if (DRAIN_STOP) {
+                if (gen_done_cycle == 0 && generators_finished())
+                    gen_done_cycle = sim_count;
+                if (gen_done_cycle != 0) {
+                    // last flit written by a core reaches its input channel one cycle later
+                    if (sim_count > gen_done_cycle && all_flits_received()) {
+                        drained = true;
+                        break;
+                    }
+                    if (DRAIN_TIMEOUT > 0 && sim_count - gen_done_cycle >= DRAIN_TIMEOUT) {
+                        drain_timed_out = true;
+                        break;
+                    }
+                }
+            }
+            
             if (sim_count == 1) {  // modeling misfunctional
             /*   set_router_fail_dir(1, W, true, true);
                set_router_fail_dir(0, E, true, true);
@@ -751,3 +813,372 @@ void NoC::progress_bar_draw(double total_to_count, double now_count, UI total_do
     fflush(stdout);
 }
 
+///////////////////////////////////////////////////////////////////
+/// Method to sample statistics of last STATS_WINDOW cycles
+/// 
+/// Appends accepted throughput, average flit latency and average
+/// buffer occupancy of the window to time series.
+///////////////////////////////////////////////////////////////////
+void NoC::sample_window() {
+    ULL flits = 0;
+    ULL latency = 0;
+    ULL bufocc = 0;
+    ULL lag = 0;
+    double offered = 0.0;
+    UI  tiles = 0;
+    for (UI i = 0; i < rows; i++) {
+        for (UI j = 0; j < cols; j++) {
+            if (nwtile[i][j] == NULL)
+                continue;
+            flits += nwtile[i][j]->return_recv_flits_number();
+            latency += nwtile[i][j]->return_total_latency_core();
+            bufocc += nwtile[i][j]->return_total_bufs_occ();
+            if (!nwtile[i][j]->return_send_finished()) {
+                offered += nwtile[i][j]->return_offered_load();
+                lag += nwtile[i][j]->return_source_lag();
+            }
+            tiles++;
+        }
+    }
+    if (tiles == 0)
+        tiles = 1;
+    
+    ULL win_flits = flits - last_flits;
+    ts_cycle.push_back(sim_count);
+    ts_flits.push_back(win_flits);
+    ts_tput.push_back((double)win_flits / (STATS_WINDOW * tiles));
+    ts_latency.push_back((win_flits == 0) ? 0.0 : (double)(latency - last_latency) / win_flits);
+    ts_bufocc.push_back((double)(bufocc - last_bufocc) / (STATS_WINDOW * tiles));
+    ts_offered.push_back(offered / tiles);
+    ts_lag.push_back(lag);
+    
+    last_flits = flits;
+    last_latency = latency;
+    last_bufocc = bufocc;
+}
+
+///////////////////////////////////////////////////////////////////
+/// Method to check if network is saturated
+/// \return true if simulation should be stopped
+///
+/// Last SAT_WINDOWS windows after WARMUP must all have accepted
+/// throughput lower than offered load by more than SAT_TOLERANCE,
+/// while total source lag (backlog of sources against their
+/// schedule) grows from window to window.
+///////////////////////////////////////////////////////////////////
+bool NoC::saturation_reached() {
+    UI n = ts_cycle.size();
+    if (SAT_WINDOWS == 0 || n < SAT_WINDOWS + 1)
+        return false;
+    if (ts_cycle[n - SAT_WINDOWS - 1] <= WARMUP)
+        return false;
+    for (UI k = n - SAT_WINDOWS; k < n; k++) {
+        if (ts_offered[k] <= 0.0)
+            return false;
+        if (ts_tput[k] >= (1.0 - SAT_TOLERANCE) * ts_offered[k])
+            return false;
+        if (ts_lag[k] <= ts_lag[k - 1])
+            return false;
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////
+/// returns 97.5% quantile of Student's t-distribution
+/// \param dof degrees of freedom
+///////////////////////////////////////////////////////////////////
+static double t_quantile_975(UI dof) {
+    static const double table[30] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                     2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                     2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (dof == 0)
+        return table[0];
+    if (dof <= 30)
+        return table[dof - 1];
+    return 1.96;
+}
+
+///////////////////////////////////////////////////////////////////
+/// Method to check if steady-state mean latency is known precisely
+/// \return true if simulation can be stopped
+///
+/// - windows without received flits are skipped
+/// - end of warmup is detected by MSER: truncation point d (at most
+///   half of windows) minimizing variance of remaining windows / (n-d)^2
+/// - remaining windows are grouped into CI_BATCHES batches, batch means
+///   give 95% confidence interval of mean latency
+/// - stop when half-width <= CI_TOLERANCE * mean
+///////////////////////////////////////////////////////////////////
+bool NoC::steady_state_reached() {
+    vector<double> lat;
+    vector<double> weight;
+    vector<UI>     win;
+    for (UI k = 0; k < ts_latency.size(); k++) {
+        if (ts_flits[k] == 0)
+            continue;
+        lat.push_back(ts_latency[k]);
+        weight.push_back((double)ts_flits[k]);
+        win.push_back(k);
+    }
+    UI n = lat.size();
+    if (n < 2 * CI_BATCHES)
+        return false;
+    
+    // MSER truncation point
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    for (UI k = 0; k < n; k++) {
+        sum += lat[k];
+        sum_sq += lat[k] * lat[k];
+    }
+    UI     best_d = 0;
+    double best_mser = -1.0;
+    for (UI d = 0; d <= n / 2; d++) {
+        UI m = n - d;
+        double sse = sum_sq - (sum * sum) / m;
+        double mser = sse / ((double)m * m);
+        if (best_mser < 0 || mser < best_mser) {
+            best_mser = mser;
+            best_d = d;
+        }
+        sum -= lat[d];
+        sum_sq -= lat[d] * lat[d];
+    }
+    warmup_windows = win[best_d];
+    
+    // batch means over windows after truncation
+    UI m = n - best_d;
+    UI batch_size = m / CI_BATCHES;
+    if (batch_size < 2)
+        return false;
+    UI first = n - batch_size * CI_BATCHES;
+    vector<double> means(CI_BATCHES, 0.0);
+    double grand = 0.0;
+    for (UI b = 0; b < CI_BATCHES; b++) {
+        double w = 0.0;
+        double lw = 0.0;
+        for (UI k = first + b * batch_size; k < first + (b + 1) * batch_size; k++) {
+            w += weight[k];
+            lw += lat[k] * weight[k];
+        }
+        means[b] = lw / w;
+        grand += means[b];
+    }
+    grand /= CI_BATCHES;
+    double var = 0.0;
+    for (UI b = 0; b < CI_BATCHES; b++)
+        var += (means[b] - grand) * (means[b] - grand);
+    var /= (CI_BATCHES - 1);
+    
+    ci_mean = grand;
+    ci_halfwidth = t_quantile_975(CI_BATCHES - 1) * sqrt(var / CI_BATCHES);
+    ci_reached = (grand > 0.0) && (ci_halfwidth <= CI_TOLERANCE * grand);
+    return ci_reached;
+}
+
+///////////////////////////////////////////////////////////////////
+/// Method to check delivery of measured packets
+/// \return true if every packet generated inside measurement window
+/// has been received
+///////////////////////////////////////////////////////////////////
+bool NoC::measured_drained() {
+    ULL sent = 0;
+    ULL recv = 0;
+    for (UI i = 0; i < rows; i++) {
+        for (UI j = 0; j < cols; j++) {
+            if (nwtile[i][j] == NULL)
+                continue;
+            sent += nwtile[i][j]->return_measured_packets_sent();
+            recv += nwtile[i][j]->return_measured_packets_recv();
+        }
+    }
+    return (recv >= sent);
+}
+
+///////////////////////////////////////////////////////////////////
+/// Method to check if traffic generation is over
+/// \return true if send_app of every core has returned
+///////////////////////////////////////////////////////////////////
+bool NoC::generators_finished() {
+    for (UI i = 0; i < rows; i++)
+        for (UI j = 0; j < cols; j++)
+            if (nwtile[i][j] != NULL && !nwtile[i][j]->return_send_finished())
+                return false;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////
+/// Method to check if network is drained
+/// \return true if at least one flit was injected and every injected flit has been received by a core
+///
+/// Injected flits are counted by core input channels, so applications
+/// writing flits directly (not counting num_flits_gen) are included.
+///////////////////////////////////////////////////////////////////
+bool NoC::all_flits_received() {
+    ULL sent = 0;
+    ULL recv = 0;
+    for (UI i = 0; i < rows; i++) {
+        for (UI j = 0; j < cols; j++) {
+            if (nwtile[i][j] == NULL)
+                continue;
+            sent += nwtile[i][j]->return_injected_flits();
+            recv += nwtile[i][j]->return_recv_flits_number();
+        }
+    }
+    sent += multicast.replicated_flits;	// copies made by routers are received but never injected
+    recv += multicast.absorbed_flits;	// flits of reduction packets combined by routers never reach a core
+    return (sent > 0 && recv >= sent);
+}
+
+///////////////////////////////////////////////////////////////////
+/// returns key of VC in watchdog wait-for graph
+///////////////////////////////////////////////////////////////////
+static ULL vc_key(UI tile, UI dir, UI vc) {
+    return ((ULL)tile * (ND + 1) + dir) * NUM_VCS + vc;
+}
+
+///////////////////////////////////////////////////////////////////
+/// depth-first search for a cycle in wait-for graph
+/// \param v current node
+/// \param edges adjacency lists
+/// \param color 0 - not visited, 1 - on stack, 2 - done
+/// \param stack current DFS path
+/// \param cycle nodes of found cycle
+/// \return true if cycle is found
+///////////////////////////////////////////////////////////////////
+static bool find_cycle(UI v, const vector< vector<UI> > &edges, vector<UI> &color, vector<UI> &stack, vector<UI> &cycle) {
+    color[v] = 1;
+    stack.push_back(v);
+    for (UI k = 0; k < edges[v].size(); k++) {
+        UI u = edges[v][k];
+        if (color[u] == 1) {
+            UI pos = stack.size();
+            while (stack[pos - 1] != u)
+                pos--;
+            cycle.assign(stack.begin() + pos - 1, stack.end());
+            return true;
+        }
+        if (color[u] == 0 && find_cycle(u, edges, color, stack, cycle))
+            return true;
+    }
+    stack.pop_back();
+    color[v] = 2;
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////
+/// Method to look for deadlocks and livelocks
+/// \return true if deadlock is detected
+///
+/// - VC is stuck if its front flit did not move for WATCHDOG_CYCLES
+/// - stuck VC waits for VC on neighbor tile it was allocated, or for
+///   all VCs of neighbor input channel if they are all stuck too
+/// - cycle of waiting VCs is a deadlock, it is written to eventlog
+///   together with tiles, ports, VCs and packets involved
+/// - packet whose hop count exceeds LIVELOCK_HOPS is reported once
+///   as livelocked
+///////////////////////////////////////////////////////////////////
+bool NoC::watchdog_check() {
+    vector<vc_state> states;
+    for (UI i = 0; i < rows; i++)
+        for (UI j = 0; j < cols; j++)
+            if (nwtile[i][j] != NULL)
+                nwtile[i][j]->return_vc_states(0, states);
+    
+    // livelock: packets wandering around too long
+    UI hop_limit = (LIVELOCK_HOPS > 0) ? LIVELOCK_HOPS : 4 * (rows + cols);
+    for (UI k = 0; k < states.size(); k++) {
+        if (states[k].hopcount <= hop_limit)
+            continue;
+        ULL pkt = ((ULL)states[k].src << 32) | states[k].pktid;
+        if (livelock_seen.count(pkt))
+            continue;
+        livelock_seen.insert(pkt);
+        livelock_pkts++;
+        ostringstream msg;
+        msg<<"Livelock suspected at cycle "<<sim_count<<": packet src: "<<states[k].src<<" pktid: "<<states[k].pktid
+           <<" hopcount: "<<states[k].hopcount<<" at tile: "<<states[k].tile<<" port: "<<states[k].port_dir<<" vc: "<<states[k].vc;
+        watchdog_report += msg.str() + "\n";
+        eventlog<<"\n"<<msg.str();
+    }
+    
+    if (deadlock_cycle != 0)
+        return true;
+    
+    // wait-for graph over stuck VCs
+    map<ULL, UI> node;
+    vector<UI> stuck;
+    for (UI k = 0; k < states.size(); k++) {
+        if (states[k].stuck_cycles < WATCHDOG_CYCLES)
+            continue;
+        node[vc_key(states[k].tile, states[k].port_dir, states[k].vc)] = stuck.size();
+        stuck.push_back(k);
+    }
+    if (stuck.size() > max_stuck_vcs)
+        max_stuck_vcs = stuck.size();
+    if (stuck.empty())
+        return false;
+    
+    vector< vector<UI> > edges(stuck.size());
+    for (UI v = 0; v < stuck.size(); v++) {
+        const vc_state &st = states[stuck[v]];
+        int row = st.tile / cols;
+        int col = st.tile % cols;
+        UI in_dir;
+        switch (st.route) {
+            case N: row--; in_dir = S; break;
+            case S: row++; in_dir = N; break;
+            case E: col++; in_dir = W; break;
+            case W: col--; in_dir = E; break;
+            default: continue;     // waits for core or for routing, not for other VC
+        }
+        if (TOPO == TORUS) {
+            row = (row + rows) % rows;
+            col = (col + cols) % cols;
+        }
+        else if (row < 0 || row >= (int)rows || col < 0 || col >= (int)cols)
+            continue;
+        UI nb = row * cols + col;
+        
+        if (st.next_vc < NUM_VCS) {
+            map<ULL, UI>::iterator it = node.find(vc_key(nb, in_dir, st.next_vc));
+            if (it != node.end())
+                edges[v].push_back(it->second);
+            continue;
+        }
+        vector<UI> all;
+        for (UI k = 0; k < NUM_VCS; k++) {
+            map<ULL, UI>::iterator it = node.find(vc_key(nb, in_dir, k));
+            if (it == node.end())
+                break;
+            all.push_back(it->second);
+        }
+        if (all.size() == NUM_VCS)
+            edges[v] = all;
+    }
+    
+    vector<UI> color(stuck.size(), 0);
+    vector<UI> stack;
+    vector<UI> cycle;
+    for (UI v = 0; v < stuck.size() && cycle.empty(); v++)
+        if (color[v] == 0)
+            find_cycle(v, edges, color, stack, cycle);
+    if (cycle.empty())
+        return false;
+    
+    deadlock_cycle = sim_count;
+    ostringstream msg;
+    msg<<"Deadlock detected at cycle "<<sim_count<<": "<<cycle.size()<<" VCs in cycle, "<<stuck.size()<<" VCs stuck\n";
+    for (UI k = 0; k < cycle.size(); k++) {
+        const vc_state &st = states[stuck[cycle[k]]];
+        msg<<"  tile: "<<st.tile<<" port: "<<st.port_dir<<" vc: "<<st.vc<<" route: "<<st.route;
+        if (st.next_vc < NUM_VCS)
+            msg<<" next vc: "<<st.next_vc;
+        msg<<" flits: "<<st.num_flits<<" stuck: "<<st.stuck_cycles
+           <<" packet src: "<<st.src<<" pktid: "<<st.pktid<<" flitid: "<<st.flitid<<"\n";
+    }
+    watchdog_report += msg.str();
+    eventlog<<"\n"<<msg.str();
+    cout<<"\n"<<msg.str();
+    return true;
+}
@@ -35,7 +35,12 @@
 #define __NOC__
 
 #include <time.h>
+#include <vector>
+#include <map>
+#include <set>
+#include <string>
 #include "NWTile.h"
+#include "scenario.h"
 #include "../config/extern.h"
 
 ///////////////////////////////////////////////
@@ -90,6 +95,36 @@ struct NoC : public sc_module {
     ULL  sim_count;             ///< NoC simulation ticks count
     bool drawProgressBar;       ///< Draw progress bar or not
     
+    // windowed time series (every STATS_WINDOW cycles)
+    vector<ULL>    ts_cycle;    ///< cycle at which window ended
+    vector<ULL>    ts_flits;    ///< number of flits received in window
+    vector<double> ts_tput;     ///< accepted throughput in window (flits per cycle per tile)
+    vector<double> ts_latency;  ///< average flit latency in window (in clock cycles)
+    vector<double> ts_bufocc;   ///< average number of occupied buffers per tile in window
+    vector<double> ts_offered;  ///< offered load of generating cores in window (flits per cycle per tile)
+    vector<ULL>    ts_lag;      ///< total number of cycles sources are behind their schedule at the end of window
+    ULL  last_flits;            ///< received flits at the end of previous window
+    ULL  last_latency;          ///< accumulated latency at the end of previous window
+    ULL  last_bufocc;           ///< accumulated buffer occupancy at the end of previous window
+    UI   warmup_windows;        ///< number of windows detected as warmup (MSER)
+    bool ci_reached;            ///< mean latency confidence interval fell under CI_TOLERANCE
+    double ci_mean;             ///< steady-state mean latency estimated by batch means
+    double ci_halfwidth;        ///< half-width of 95% confidence interval of ci_mean
+    bool measure_drained;       ///< run ended because all measured packets were delivered
+    bool saturated;             ///< run ended because accepted throughput stopped following offered load
+    ULL  sat_cycle;             ///< cycle at which saturation was declared (0 - not saturated)
+    ULL  gen_done_cycle;        ///< cycle when all cores finished generation (0 - not yet)
+    bool drained;               ///< run ended because all generated flits were received
+    bool drain_timed_out;       ///< run ended because DRAIN_TIMEOUT expired
+    
+    // deadlock / livelock watchdog
+    ULL  deadlock_cycle;        ///< cycle at which first deadlock was detected (0 - none)
+    bool deadlock_abort;        ///< run ended because deadlock was detected and WATCHDOG_ABORT is set
+    UI   max_stuck_vcs;         ///< largest number of stuck VCs seen by watchdog
+    UI   livelock_pkts;         ///< number of packets reported as livelocked
+    set<ULL> livelock_seen;     ///< packets (src, pktid) already reported as livelocked
+    string watchdog_report;     ///< description of detected deadlock cycle and livelocked packets
+    
 	void entry();	            ///< Keeps count of number of simulation cycles
     
     bool set_router_fail(UI tileID);                                                    ///< set router to fail
@@ -100,6 +135,13 @@ struct NoC : public sc_module {
     bool turn_off_ipcore_and_links(UI tileID);          ///< turn off certain overall tile and channels to it
     bool is_turn_off_tile(UI x, UI y);                  ///< need to turn off tile (x,y)
     void progress_bar_draw(double total_to_count, double now_count, UI total_dotz); ///< function that draw progress bar
+    void sample_window();                               ///< append current window to time series
+    bool steady_state_reached();                        ///< detect warmup and check batch-means confidence interval
+    bool saturation_reached();                          ///< check if accepted throughput stopped following offered load
+    bool measured_drained();                            ///< check if all packets from measurement window are delivered
+    bool generators_finished();                         ///< check if all cores finished generation
+    bool all_flits_received();                          ///< check if all generated flits are received
+    bool watchdog_check();                              ///< look for deadlock cycles and livelocked packets
 };
 
 #endif
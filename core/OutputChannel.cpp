@@ -188,27 +188,31 @@ void OutputChannel<num_ip>::entry() {
             
            	if(!r_vc[cur_vc].free) {	// flit in register r_vc
             
-				// local channel, send flit from r_vc to outport, no need to check credit info
+				// local channel, send flit from r_vc to outport if ipcore is ready, no need to check credit info
 				if(cntrlID == C) {
-					
-					r_vc[cur_vc].val.simdata.ctime = sc_time_stamp();
+					if(!outReady.read()) {	// ipcore applies backpressure, keep flit in r_vc
+						if(LOG >= 4)
+							eventlog<<"Time: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" cntrlID: "<<cntrlID<<" Core is not ready for VC "<<cur_vc<<endl;
+					}
+					else {
+						r_vc[cur_vc].val.simdata.ctime = sc_time_stamp();
                     
-                    //updates hop counts
-                    r_vc[cur_vc].val.pkthdr.nochdr.hopcount++;
+                        //updates hop counts
+                        r_vc[cur_vc].val.pkthdr.nochdr.hopcount++;
                     
-					outport.write(r_vc[cur_vc].val);
-					r_vc[cur_vc].free = true;
-					
-					if(r_vc[cur_vc].val.pkthdr.nochdr.flittype == TAIL || r_vc[cur_vc].val.pkthdr.nochdr.flittype == HDT) {
-						latency += sim_count - 1 - input_time[cur_vc];
-						num_pkts++;
-						end_cycle = sim_count - 1;
-					}
-					num_flits++;
+						outport.write(r_vc[cur_vc].val);
+						r_vc[cur_vc].free = true;
 					
-					if(LOG >= 2)
-						eventlog<<"Time: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" cntrlID: "<<cntrlID<<" Sending out flit from OC "<<r_vc[cur_vc].val;
+						if(r_vc[cur_vc].val.pkthdr.nochdr.flittype == TAIL || r_vc[cur_vc].val.pkthdr.nochdr.flittype == HDT) {
+							latency += sim_count - 1 - input_time[cur_vc];
+							num_pkts++;
+							end_cycle = sim_count - 1;
+						}
+						num_flits++;
 					
+						if(LOG >= 2)
+							eventlog<<"Time: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" cntrlID: "<<cntrlID<<" Sending out flit from OC "<<r_vc[cur_vc].val;
+					}
 				}
 				else {	// send flit to outport on basis of credit info, if free space in buf at IC of next tile
 					if(credit_in[r_vc[cur_vc].val.vcid].read().freeBuf) {
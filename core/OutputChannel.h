@@ -58,6 +58,7 @@ struct OutputChannel : public sc_module {
     sc_in<bool>         congestion_status_in[NUM_VCS];  ///< congestion status from local ICs
 	sc_out<bool>        inReady[num_ip];		        ///< output port to send ready signal to IC
 	sc_out<flit>        outport;			            ///< output data/flit port	
+	sc_in<bool>         outReady;			            ///< ready signal from ipcore (core channel only), flit is held while false
     // PORTS END ////////////////////////////////////////////////////////////////////////////////////
 	
 	SC_CTOR(OutputChannel); ///< constructor
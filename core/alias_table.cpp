@@ -0,0 +1,86 @@
+/*
+ * alias_table.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file alias_table.cpp
+/// \brief Implements alias table for O(1) sampling from discrete distribution
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "alias_table.h"
+
+////////////////////////////////////////////////////////
+/// Method to build alias table
+/// \param weights weight of each outcome, negative weights are treated as 0
+/// - table is left empty if all weights are 0
+////////////////////////////////////////////////////////
+void alias_table::build(const vector<double> &weights) {
+	prob.clear();
+	alias.clear();
+	UI n = weights.size();
+	double total = 0.0;
+	for(UI i = 0; i < n; i++)
+		if(weights[i] > 0.0)
+			total += weights[i];
+	if(total <= 0.0)
+		return;
+
+	prob.resize(n);
+	alias.resize(n);
+	vector<UI> small, large;
+	for(UI i = 0; i < n; i++) {
+		prob[i] = (weights[i] > 0.0) ? weights[i] * n / total : 0.0;
+		alias[i] = i;
+		if(prob[i] < 1.0)
+			small.push_back(i);
+		else
+			large.push_back(i);
+	}
+	// pair each underfull column with an overfull one
+	while(!small.empty() && !large.empty()) {
+		UI s = small.back(); small.pop_back();
+		UI l = large.back();
+		alias[s] = l;
+		prob[l] -= 1.0 - prob[s];
+		if(prob[l] < 1.0) {
+			large.pop_back();
+			small.push_back(l);
+		}
+	}
+	// remaining columns are full up to rounding error
+	for(UI i = 0; i < large.size(); i++)
+		prob[large[i]] = 1.0;
+	for(UI i = 0; i < small.size(); i++)
+		prob[small[i]] = 1.0;
+}
+
+////////////////////////////////////////////////////////
+/// Method to draw random outcome
+/// \param rng random number generator
+/// \return index of outcome
+////////////////////////////////////////////////////////
+UI alias_table::sample(RNG *rng) const {
+	UI n = prob.size();
+	double u = rng->uniform() * n;
+	UI col = (UI)u;
+	if(col >= n)
+		col = n - 1;
+	return (u - col < prob[col]) ? col : alias[col];
+}
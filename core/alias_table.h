@@ -0,0 +1,56 @@
+/*
+ * alias_table.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file alias_table.h
+/// \brief Defines alias table for O(1) sampling from discrete distribution
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ALIAS_TABLE_
+#define _ALIAS_TABLE_
+
+#include <vector>
+#include "../config/constants.h"
+#include "rng.h"
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////////////////
+/// \brief Alias table (Walker's method, Vose's construction)
+///
+/// Built once in O(n) from non-negative weights. Each sample takes one
+/// uniform number: it picks a column and returns either the column or its
+/// alias, so cost does not depend on number of outcomes.
+//////////////////////////////////////////////////////////////////////////
+struct alias_table {
+	vector<double> prob;	///< probability of keeping column instead of its alias
+	vector<UI>     alias;	///< outcome returned when column is not kept
+
+	// FUNCTIONS /////////////////////////////////////////////////////////////////////////////
+	void build(const vector<double> &weights);	///< build table from weights (need not be normalized)
+	UI   sample(RNG *rng) const;	            ///< returns random outcome
+	bool empty() const {	                    ///< true if table has no outcome with positive weight
+		return prob.empty();
+	};
+	// FUNCTIONS END /////////////////////////////////////////////////////////////////////////
+};
+
+#endif
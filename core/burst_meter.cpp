@@ -0,0 +1,167 @@
+/*
+ * burst_meter.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file burst_meter.cpp
+/// \brief Implements meter of burstiness of generated traffic
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include "burst_meter.h"
+
+////////////////////////////////////////////////////////
+/// Method to remove all samples
+////////////////////////////////////////////////////////
+void burst_meter::reset() {
+	start_cycle = 0;
+	end_cycle = 0;
+	active = false;
+	flits = 0;
+	for(UI k = 0; k < BURST_LEVELS; k++) {
+		cur_block[k] = 0;
+		cur_count[k] = 0;
+		blocks[k] = 0;
+		sum[k] = 0.0;
+		sum_sq[k] = 0.0;
+	}
+}
+
+////////////////////////////////////////////////////////
+/// Method to start measurement
+/// \param cycle first cycle of first block
+////////////////////////////////////////////////////////
+void burst_meter::start(ULL cycle) {
+	reset();
+	start_cycle = cycle;
+	end_cycle = cycle;
+	active = true;
+}
+
+////////////////////////////////////////////////////////
+/// Method to complete blocks of a level
+/// \param level aggregation level
+/// \param block index of block that becomes open block
+/// - open block and empty blocks in between are completed
+////////////////////////////////////////////////////////
+void burst_meter::close_blocks(UI level, ULL block) {
+	if(block <= cur_block[level])
+		return;
+	double c = (double)cur_count[level];
+	sum[level] += c;
+	sum_sq[level] += c * c;
+	blocks[level] += block - cur_block[level];	// open block plus empty ones
+	cur_block[level] = block;
+	cur_count[level] = 0;
+}
+
+////////////////////////////////////////////////////////
+/// Method to add a packet
+/// \param cycle generation cycle of packet
+/// \param num_flits size of packet
+////////////////////////////////////////////////////////
+void burst_meter::record(ULL cycle, UI num_flits) {
+	if(!active || cycle < start_cycle)
+		return;
+	ULL rel = cycle - start_cycle;
+	for(UI k = 0; k < BURST_LEVELS; k++) {
+		close_blocks(k, rel >> k);
+		cur_count[k] += num_flits;
+	}
+	flits += num_flits;
+}
+
+////////////////////////////////////////////////////////
+/// Method to finish measurement
+/// \param cycle first cycle after measurement
+/// - last, incomplete block of each level is dropped
+////////////////////////////////////////////////////////
+void burst_meter::finish(ULL cycle) {
+	if(!active)
+		return;
+	active = false;
+	if(cycle < start_cycle)
+		cycle = start_cycle;
+	end_cycle = cycle;
+	ULL rel = cycle - start_cycle;
+	for(UI k = 0; k < BURST_LEVELS; k++)
+		close_blocks(k, rel >> k);
+}
+
+////////////////////////////////////////////////////////
+/// Method to compute average rate
+/// \return generated flits per cycle
+////////////////////////////////////////////////////////
+double burst_meter::mean_rate() const {
+	if(end_cycle <= start_cycle)
+		return 0.0;
+	return (double)flits / (end_cycle - start_cycle);
+}
+
+////////////////////////////////////////////////////////
+/// Method to compute index of dispersion of counts
+/// \param level aggregation level (blocks of 2^level cycles)
+/// \return variance / mean of flits per block
+////////////////////////////////////////////////////////
+double burst_meter::idc(UI level) const {
+	if(level >= BURST_LEVELS || blocks[level] < BURST_MIN_BLOCKS || sum[level] <= 0.0)
+		return 0.0;
+	double mean = sum[level] / blocks[level];
+	double var = sum_sq[level] / blocks[level] - mean * mean;
+	return (var < 0.0) ? 0.0 : var / mean;
+}
+
+////////////////////////////////////////////////////////
+/// Method to find largest usable level
+/// \return level, -1 if no level has enough blocks
+////////////////////////////////////////////////////////
+int burst_meter::top_level() const {
+	for(int k = BURST_LEVELS - 1; k >= 0; k--)
+		if(blocks[k] >= BURST_MIN_BLOCKS)
+			return k;
+	return -1;
+}
+
+////////////////////////////////////////////////////////
+/// Method to estimate Hurst parameter
+/// \return H from least squares fit of log variance of block rate
+///         against log block size, 0 if fewer than 3 levels are usable
+////////////////////////////////////////////////////////
+double burst_meter::hurst() const {
+	double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+	UI n = 0;
+	for(UI k = BURST_FIT_LEVEL; k < BURST_LEVELS; k++) {
+		if(blocks[k] < BURST_MIN_BLOCKS)
+			break;
+		double m = (double)(1ULL << k);
+		double mean = sum[k] / blocks[k];
+		double var = (sum_sq[k] / blocks[k] - mean * mean) / (m * m);	// variance of flits per cycle
+		if(var <= 0.0)
+			continue;
+		double x = log(m);
+		double y = log(var);
+		sx += x; sy += y; sxx += x * x; sxy += x * y;
+		n++;
+	}
+	if(n < 3)
+		return 0.0;
+	double slope = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+	return 1.0 + slope / 2.0;
+}
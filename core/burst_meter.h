@@ -0,0 +1,82 @@
+/*
+ * burst_meter.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file burst_meter.h
+/// \brief Defines meter of burstiness (index of dispersion, Hurst parameter) of generated traffic
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _BURST_METER_
+#define _BURST_METER_
+
+#include "../config/constants.h"
+
+/// number of aggregation levels, level k counts flits in blocks of 2^k cycles
+#define BURST_LEVELS        16
+/// smallest number of blocks for a level to be used in estimates
+#define BURST_MIN_BLOCKS    8
+/// smallest level used in variance-time fit (shorter blocks are dominated by packet size)
+#define BURST_FIT_LEVEL     2
+
+//////////////////////////////////////////////////////////////////////////
+/// \brief Burstiness meter
+///
+/// Counts flits in consecutive blocks of 1, 2, 4, ... cycles and keeps
+/// sum and sum of squares of block counts at each level, so memory is
+/// fixed and recording costs O(BURST_LEVELS) per packet. Blocks without
+/// packets are accounted for lazily.
+/// - idc(k): index of dispersion of counts, variance / mean of flits per
+///   block at level k; stays flat for Poisson packet arrivals and grows
+///   with k for long-range dependent traffic
+/// - hurst(): variance-time estimate, Var(block rate) ~ m^(2H - 2)
+//////////////////////////////////////////////////////////////////////////
+struct burst_meter {
+	ULL    start_cycle;	                ///< first cycle of measurement
+	ULL    end_cycle;	                ///< cycle measurement was finished at
+	bool   active;	                    ///< measurement started and not finished
+	ULL    flits;	                    ///< total number of recorded flits
+	ULL    cur_block[BURST_LEVELS];	    ///< index of open block at each level
+	ULL    cur_count[BURST_LEVELS];	    ///< flits in open block at each level
+	ULL    blocks[BURST_LEVELS];	    ///< number of completed blocks at each level
+	double sum[BURST_LEVELS];	        ///< sum of flit counts of completed blocks
+	double sum_sq[BURST_LEVELS];	    ///< sum of squared flit counts of completed blocks
+
+	/// burst meter constructor
+	burst_meter() {
+		reset();
+	};
+
+	// FUNCTIONS /////////////////////////////////////////////////////////////////////////////
+	void   reset();	                        ///< remove all samples
+	void   start(ULL cycle);	            ///< start measurement at given cycle
+	void   record(ULL cycle, UI num_flits);	///< add packet generated at given cycle
+	void   finish(ULL cycle);	            ///< close all complete blocks up to given cycle
+	double mean_rate() const;	            ///< returns average generated flits per cycle
+	double idc(UI level) const;	            ///< returns index of dispersion of counts at level (0 if too few blocks)
+	int    top_level() const;	            ///< returns largest level with enough blocks (-1 if none)
+	double hurst() const;	                ///< returns variance-time estimate of Hurst parameter (0 if unknown)
+	// FUNCTIONS END /////////////////////////////////////////////////////////////////////////
+
+private:
+	void   close_blocks(UI level, ULL block);	///< complete blocks of level before given block
+};
+
+#endif
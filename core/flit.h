@@ -75,6 +75,31 @@ union routing_hdr {
 	AntNet_hdr AntNethdr;	///< Ant routing header
 };
 
+////////////////////////////////////////////////
+/// \brief multicast header in head/hdt flit
+///
+/// Destination set is given by group id in multicast table (see multicast.h)
+////////////////////////////////////////////////
+struct mcast_hdr {
+	UI mode;	///< delivery mode (mcast_mode), MCAST_NONE for unicast packets
+	UI group;	///< id of destination group
+	UI target;	///< next destination of path-based worm
+	UI seq;		///< sequence number of multicast operation at source
+};
+
+////////////////////////////////////////////////
+/// \brief message header in head/hdt flit
+///
+/// Packets of a message sent by ipcore::send_message carry its id, so the
+/// receiving core can reassemble it (see message.h)
+////////////////////////////////////////////////
+struct msg_hdr {
+	UI id;		///< message id at source
+	UI cls;		///< message class
+	UI bytes;	///< message size (in bytes)
+	UI pkts;	///< number of packets of message, 0 for packets outside messages
+};
+
 ////////////////////////////////////////////////
 /// \brief payload in head/hdt flit
 ///
@@ -93,6 +118,8 @@ struct flit_head {
 	routing_type	rtalgo;		///< routing algorithm 
 	routing_hdr 	rthdr;		///< routing header
     routing_fault_info rtfi;    ///< routing fault info
+	mcast_hdr	mcast;		    ///< multicast header
+	msg_hdr		msg;		    ///< message header
 	payload_hdr	datahdr;	    ///< payload
 };
 
@@ -131,6 +158,7 @@ public:
 	UI		pktid;		    ///< packet id
 	UI		flitid;		    ///< flit id
 	UI      hopcount;       ///< hop count passed by flit
+	UI      flowseq;        ///< sequence number of packet in its flow (src, dst), set at injection
 	flit_type	flittype;	///< flit type (HDT, HEAD, DATA, TAIL)
 	flit_hdr 	flithdr;	///< flit header (depending on flit type)
 };
@@ -152,9 +180,11 @@ struct sim_hdr {
 	sc_time ctime;		///< instantaneous time (in time units)
 	ULL	gtimestamp;	    ///< flit generation timestamp (in clock cycle)
 	ULL	atimestamp;	    ///< flit arrival timestamp at reciever (in clock cycle)
+	ULL	itimestamp;	    ///< flit injection timestamp, leaving source queue (in clock cycle)
 	ULL	ICtimestamp;	///< input channel time stamp (in clock cycles)
 	ULL	num_waits;	    ///< number of clock cycles spent waiting in buffer
 	ULL	num_sw;		    ///< number of switches traversed
+	bool measured;	    ///< flit belongs to packet generated inside measurement window
 };
 
 ////////////////////////////////////////////////
@@ -211,7 +241,11 @@ operator << ( ostream& os, const flit& temp ) {
 inline ostream&
 operator << ( ostream& os, const sim_hdr& temp ) {
 	os<<"gtimestamp: "<<temp.gtimestamp<<" gtime: "<<temp.gtime;
-	os<<"\natimestamp: "<<temp.atimestamp<<" atime: "<<temp.atime<<endl;
+	os<<" itimestamp: "<<temp.itimestamp;
+	os<<"\natimestamp: "<<temp.atimestamp<<" atime: "<<temp.atime;
+	if(temp.measured)
+		os<<" measured";
+	os<<endl;
 	return os;
 }
 
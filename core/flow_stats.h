@@ -0,0 +1,70 @@
+/*
+ * flow_stats.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file flow_stats.h
+/// \brief Defines statistics of a single source-destination flow
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _FLOW_STATS_
+#define _FLOW_STATS_
+
+#include <map>
+#include "../config/constants.h"
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////
+/// \brief flow statistics data structure
+///
+/// kept by receiving ipcore for every source it got flits from
+///////////////////////////////////////////////////////////////
+struct flow_stats {
+	ULL	packets;	    ///< number of received packets
+	ULL	flits;	        ///< number of received flits
+	ULL	total_latency;	///< sum of packet latencies (head generation to tail arrival)
+	ULL	wc_latency;	    ///< worst-case packet latency
+	ULL	total_hops;	    ///< sum of hops traversed by flits
+
+	/// \brief constructor
+	flow_stats() {
+		packets = 0;
+		flits = 0;
+		total_latency = 0;
+		wc_latency = 0;
+		total_hops = 0;
+	}
+	
+	/// \brief average packet latency
+	double avg_latency() const {
+		return (packets == 0) ? 0.0 : (double)total_latency / packets;
+	}
+	
+	/// \brief average number of hops per flit
+	double avg_hops() const {
+		return (flits == 0) ? 0.0 : (double)total_hops / flits;
+	}
+};
+
+/// sparse flow table of a receiving tile, key is source tile id
+typedef map<UI, flow_stats> flow_table;
+
+#endif
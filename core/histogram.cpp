@@ -0,0 +1,174 @@
+/*
+ * histogram.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file histogram.cpp
+/// \brief Implements log-bucketed histogram
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include "histogram.h"
+
+////////////////////////////////////////////////////////
+/// Method to remove all samples from histogram
+////////////////////////////////////////////////////////
+void histogram::reset() {
+	for(UI i = 0; i < HIST_NUM_BUCKETS; i++)
+		buckets[i] = 0;
+	count = 0;
+	sum = 0;
+	min = 0;
+	max = 0;
+}
+
+////////////////////////////////////////////////////////
+/// Method to find bucket for a value
+/// \param value sample value
+/// \return bucket index
+////////////////////////////////////////////////////////
+UI histogram::bucket_index(ULL value) {
+	if(value < HIST_LINEAR_LIMIT)
+		return (UI)value;
+	UI msb = 63 - __builtin_clzll(value);	// position of highest set bit, >= HIST_SUB_BITS + 1
+	if(msb >= HIST_MAX_EXP)
+		return HIST_NUM_BUCKETS - 1;
+	UI sub = (UI)(value >> (msb - HIST_SUB_BITS)) & ((1 << HIST_SUB_BITS) - 1);
+	return HIST_LINEAR_LIMIT + (msb - HIST_SUB_BITS - 1) * (1 << HIST_SUB_BITS) + sub;
+}
+
+////////////////////////////////////////////////////////
+/// Method to return smallest value of a bucket
+/// \param index bucket index
+/// \return lower bound of bucket
+////////////////////////////////////////////////////////
+ULL histogram::bucket_low(UI index) {
+	if(index < HIST_LINEAR_LIMIT)
+		return index;
+	UI k = index - HIST_LINEAR_LIMIT;
+	UI msb = k / (1 << HIST_SUB_BITS) + HIST_SUB_BITS + 1;
+	UI sub = k % (1 << HIST_SUB_BITS);
+	return ((ULL)((1 << HIST_SUB_BITS) + sub)) << (msb - HIST_SUB_BITS);
+}
+
+////////////////////////////////////////////////////////
+/// Method to return largest value of a bucket
+/// \param index bucket index
+/// \return upper bound of bucket
+////////////////////////////////////////////////////////
+ULL histogram::bucket_high(UI index) {
+	if(index < HIST_LINEAR_LIMIT)
+		return index;
+	if(index == HIST_NUM_BUCKETS - 1)
+		return ~0ULL;
+	return bucket_low(index + 1) - 1;
+}
+
+////////////////////////////////////////////////////////
+/// Method to add a sample
+/// \param value sample value
+////////////////////////////////////////////////////////
+void histogram::record(ULL value) {
+	buckets[bucket_index(value)]++;
+	if(count == 0 || value < min)
+		min = value;
+	if(value > max)
+		max = value;
+	sum += value;
+	count++;
+}
+
+////////////////////////////////////////////////////////
+/// Method to add all samples of other histogram
+/// \param other histogram to merge
+////////////////////////////////////////////////////////
+void histogram::merge(const histogram &other) {
+	if(other.count == 0)
+		return;
+	for(UI i = 0; i < HIST_NUM_BUCKETS; i++)
+		buckets[i] += other.buckets[i];
+	if(count == 0 || other.min < min)
+		min = other.min;
+	if(other.max > max)
+		max = other.max;
+	sum += other.sum;
+	count += other.count;
+}
+
+////////////////////////////////////////////////////////
+/// Method to compute average of samples
+/// \return mean value
+////////////////////////////////////////////////////////
+double histogram::mean() const {
+	if(count == 0)
+		return 0.0;
+	return (double)sum / count;
+}
+
+////////////////////////////////////////////////////////
+/// Method to compute percentile
+/// \param p percent (0..100)
+/// \return upper bound of bucket holding p-th percentile (clipped to max sample)
+////////////////////////////////////////////////////////
+ULL histogram::percentile(double p) const {
+	if(count == 0)
+		return 0;
+	ULL rank = (ULL)ceil(p / 100.0 * count);
+	if(rank < 1)
+		rank = 1;
+	if(rank > count)
+		rank = count;
+	ULL seen = 0;
+	for(UI i = 0; i < HIST_NUM_BUCKETS; i++) {
+		seen += buckets[i];
+		if(seen >= rank) {
+			ULL res = bucket_high(i);
+			if(res > max)
+				res = max;
+			if(res < min)
+				res = min;
+			return res;
+		}
+	}
+	return max;
+}
+
+////////////////////////////////////////////////////////
+/// Method to write summary of histogram
+/// \param out output stream
+/// \param name name of histogram
+////////////////////////////////////////////////////////
+void histogram::print(ofstream &out, string name) const {
+	out<<name<<"\t"<<count<<"\t"<<min<<"\t"<<mean()<<"\t"<<percentile(50)<<"\t"<<percentile(90)
+	   <<"\t"<<percentile(99)<<"\t"<<percentile(99.9)<<"\t"<<max<<endl;
+}
+
+////////////////////////////////////////////////////////
+/// Method to write non-empty buckets of histogram
+/// \param out output stream
+/// \param name name of histogram
+////////////////////////////////////////////////////////
+void histogram::dump(ofstream &out, string name) const {
+	for(UI i = 0; i < HIST_NUM_BUCKETS; i++) {
+		if(buckets[i] == 0)
+			continue;
+		out<<name<<"\t"<<bucket_low(i)<<"\t"<<bucket_high(i)<<"\t"<<buckets[i]<<endl;
+	}
+}
@@ -0,0 +1,82 @@
+/*
+ * histogram.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file histogram.h
+/// \brief Defines log-bucketed histogram used for latency, hop and wait statistics
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _HISTOGRAM_
+#define _HISTOGRAM_
+
+#include <fstream>
+#include <string>
+#include "../config/constants.h"
+
+using namespace std;
+
+/// number of sub-buckets per power of two is 2^HIST_SUB_BITS (relative error <= 1/8)
+#define HIST_SUB_BITS       3
+/// values below this bound are counted exactly, one bucket per value
+#define HIST_LINEAR_LIMIT   (1 << (HIST_SUB_BITS + 1))
+/// largest power of two tracked, bigger values fall into the last bucket
+#define HIST_MAX_EXP        40
+/// total number of buckets
+#define HIST_NUM_BUCKETS    (HIST_LINEAR_LIMIT + (HIST_MAX_EXP - HIST_SUB_BITS - 1) * (1 << HIST_SUB_BITS))
+
+//////////////////////////////////////////////////////////////////////////
+/// \brief Log-bucketed histogram
+///
+/// Values below HIST_LINEAR_LIMIT get their own bucket, bigger values are
+/// split into 2^HIST_SUB_BITS buckets per power of two. Recording is O(1)
+/// and memory is fixed, so histograms can be kept per tile (and per flow)
+/// and merged to get network-wide percentiles.
+//////////////////////////////////////////////////////////////////////////
+struct histogram {
+	ULL buckets[HIST_NUM_BUCKETS];	///< number of samples in each bucket
+	ULL count;	                    ///< total number of samples
+	ULL sum;	                    ///< sum of all samples
+	ULL min;	                    ///< smallest sample
+	ULL max;	                    ///< largest sample
+
+	/// histogram constructor
+	histogram() {
+		reset();
+	};
+
+	// FUNCTIONS /////////////////////////////////////////////////////////////////////////////
+	void   reset();	                        ///< remove all samples
+	void   record(ULL value);	            ///< add a sample
+	void   merge(const histogram &other);	///< add all samples of other histogram
+	double mean() const;	                ///< returns average of samples
+	ULL    percentile(double p) const;	    ///< returns value below which p percents of samples lie
+	/// write one line with count, min, mean, percentiles and max
+	void   print(ofstream &out, string name) const;
+	/// write non-empty buckets (lower bound, upper bound, count)
+	void   dump(ofstream &out, string name) const;
+
+	static UI  bucket_index(ULL value);	    ///< returns bucket for a value
+	static ULL bucket_low(UI index);	    ///< returns smallest value of a bucket
+	static ULL bucket_high(UI index);	    ///< returns largest value of a bucket
+	// FUNCTIONS END /////////////////////////////////////////////////////////////////////////
+};
+
+#endif
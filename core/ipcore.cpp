@@ -51,11 +51,40 @@ ipcore::ipcore(sc_module_name ipcore): sc_module(ipcore) {
 	num_sw = 0;
 	avg_num_waits = 0.0;
 	avg_num_sw = 0.0;
+	pkt_measured = false;
+	send_finished = false;
+	sched_active = false;
+	inj_queue_max = 0;
+	src_stall_cycles = 0;
+	total_queue_latency = 0;
+	total_net_latency = 0;
+	sched_start = 0;
+	sched_time = 0;
+	sched_flits = 0;
+	transactions = 0;
+	measured_pkts_gen = 0;
+	measured_pkts_recv = 0;
+	measured_flits_recv = 0;
+	measured_latency = 0;
+	measured_latency_flit = 0;
+	inj_flits_in = 0;
+	inj_flits_out = 0;
+	msg_packet_flits = MSG_PACKET_FLITS;
+	msg_next_id = 0;
+	messages_sent = 0;
+	messages_recv = 0;
+	msg_inbox_on = false;
+	inj_flowseq = FLOW_SEQ_NONE;
+	rob.size = REORDER_BUFFER;
     
 	ran_var = new RNG((RNG::RNGSources)2,1);
+	eject_ready.initialize(true);	// cores accept flits unless application applies backpressure
     
-    for (UI i = 0; i < MAX_NUM_TILES; i++)
+    for (UI i = 0; i < MAX_NUM_TILES; i++) {
         accept_destinations[i] = true;
+        hist_flow[i] = NULL;
+        flow_seq[i] = 0;
+    }
 
 	// process sensitive to clock, sends out flit
 	SC_CTHREAD(send, clock.pos());
@@ -80,9 +109,11 @@ void ipcore::setID(UI id) {
 ///////////////////////////////////////////////////////////////////////////
 /// Method to send flit 
 /// - call send_app
+/// - mark core as finished when send_app returns
 ///////////////////////////////////////////////////////////////////////////
 void ipcore::send(){
 	send_app();
+	send_finished = true;	// no more flits from this core, used for drain detection
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -113,6 +144,131 @@ void ipcore::recv(){
 				wc_latency = temp;
 			if ((flit_recd.pkthdr.nochdr.flittype == TAIL) || (flit_recd.pkthdr.nochdr.flittype == HDT))
 				total_packets_recived++;
+			
+			// packet latency is counted from head generation to tail arrival
+			ULL pkt_key = ((ULL)flit_recd.src << 32) | (UI)flit_recd.pkthdr.nochdr.pktid;
+			ULL pkt_gtimestamp = flit_recd.simdata.gtimestamp;
+			bool pkt_done = false;
+			switch (flit_recd.pkthdr.nochdr.flittype) {
+				case HEAD: head_gtimestamp[pkt_key] = flit_recd.simdata.gtimestamp; break;
+				case HDT:  pkt_done = true; break;
+				case TAIL: {
+					map<ULL, ULL>::iterator it = head_gtimestamp.find(pkt_key);
+					if (it != head_gtimestamp.end()) {
+						pkt_gtimestamp = it->second;
+						head_gtimestamp.erase(it);
+					}
+					pkt_done = true;
+					break;
+				}
+				default: break;
+			}
+			
+			// packet of multicast operation reached one of its destinations
+			if (flit_recd.pkthdr.nochdr.flittype == HEAD || flit_recd.pkthdr.nochdr.flittype == HDT) {
+				mcast_hdr &mh = flit_recd.pkthdr.nochdr.flithdr.header.mcast;
+				if (mh.mode != MCAST_NONE) {
+					ULL op_key = mcast_op_key(flit_recd.src, mh.mode, mh.group, mh.target, mh.seq);
+					if (flit_recd.pkthdr.nochdr.flittype == HDT)
+						multicast.deliver(op_key, flit_recd.simdata.atimestamp - 1);
+					else
+						mcast_head[pkt_key] = op_key;
+				}
+			}
+			else if (flit_recd.pkthdr.nochdr.flittype == TAIL && !mcast_head.empty()) {
+				map<ULL, ULL>::iterator it = mcast_head.find(pkt_key);
+				if (it != mcast_head.end()) {
+					multicast.deliver(it->second, flit_recd.simdata.atimestamp - 1);
+					mcast_head.erase(it);
+				}
+			}
+			
+			// packet of message: message is complete when all its packets arrived (in any order)
+			if (flit_recd.pkthdr.nochdr.flittype == HEAD) {
+				if (flit_recd.pkthdr.nochdr.flithdr.header.msg.pkts > 0)
+					msg_head[pkt_key] = flit_recd.pkthdr.nochdr.flithdr.header.msg;
+			}
+			else if (pkt_done) {
+				msg_hdr mh = flit_recd.pkthdr.nochdr.flithdr.header.msg;
+				bool is_msg = (flit_recd.pkthdr.nochdr.flittype == HDT && mh.pkts > 0);
+				if (flit_recd.pkthdr.nochdr.flittype == TAIL && !msg_head.empty()) {
+					map<ULL, msg_hdr>::iterator it = msg_head.find(pkt_key);
+					if (it != msg_head.end()) {
+						mh = it->second;
+						is_msg = true;
+						msg_head.erase(it);
+					}
+				}
+				if (is_msg) {
+					ULL key = msg_key(flit_recd.src, mh.id);
+					UI parts = ++msg_parts[key];
+					if (parts >= mh.pkts) {
+						msg_parts.erase(key);
+						message msg;
+						msg.src = flit_recd.src;
+						msg.dst = tileID;
+						msg.id = mh.id;
+						msg.cls = mh.cls;
+						msg.bytes = mh.bytes;
+						msg.pkts = mh.pkts;
+						msg.issue = pkt_gtimestamp;	// all packets are generated by one send_message call
+						msg.arrival = flit_recd.simdata.atimestamp - 1;
+						messages_recv++;
+						bool measured = in_measure_window(msg.issue);
+						if (measured)
+							hist[HIST_MESSAGE].record(msg.arrival - msg.issue);
+						msg_table.deliver(msg, measured);
+						if (msg_inbox_on)
+							msg_inbox.push_back(msg);
+						if(LOG >= 3)
+							eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" message "<<msg.id
+							        <<" from "<<msg.src<<" reassembled, latency "<<msg.arrival - msg.issue;
+					}
+				}
+			}
+			
+			// in-order delivery of flows: packet ahead of its predecessors waits in reorder buffer
+			if (pkt_done && flit_recd.pkthdr.nochdr.flowseq != FLOW_SEQ_NONE)
+				rob.arrive(flit_recd.src, flit_recd.pkthdr.nochdr.flowseq, flit_recd.simdata.atimestamp - 1,
+				           flit_recd.simdata.measured, hist[HIST_REORDER_DEPTH], hist[HIST_REORDER_DELAY]);
+			
+			ULL flit_latency = flit_recd.simdata.atimestamp - 1 - flit_recd.simdata.gtimestamp;
+			ULL pkt_latency = flit_recd.simdata.atimestamp - 1 - pkt_gtimestamp;
+			
+			// latency = source queueing (generation to injection) + network (injection to arrival)
+			ULL queue_latency = flit_recd.simdata.itimestamp - flit_recd.simdata.gtimestamp;
+			ULL net_latency = flit_latency - queue_latency;
+			total_queue_latency += queue_latency;
+			total_net_latency += net_latency;
+			
+			// distributions and flow statistics (only packets from measurement window, if defined)
+			if (flit_recd.simdata.measured) {
+				hist[HIST_LATENCY_FLIT].record(flit_latency);
+				hist[HIST_HOPS].record(flit_recd.simdata.num_sw);
+				hist[HIST_WAITS].record(flit_recd.simdata.num_waits);
+				hist[HIST_QUEUE_FLIT].record(queue_latency);
+				hist[HIST_NETWORK_FLIT].record(net_latency);
+				flow_stats &flow = flows[flit_recd.src];
+				flow.flits++;
+				flow.total_hops += flit_recd.simdata.num_sw;
+				measured_flits_recv++;
+				measured_latency_flit += flit_latency;
+				if (pkt_done) {
+					hist[HIST_LATENCY_PKT].record(pkt_latency);
+					flow.packets++;
+					flow.total_latency += pkt_latency;
+					if (pkt_latency > flow.wc_latency)
+						flow.wc_latency = pkt_latency;
+					if (flit_recd.src < MAX_NUM_TILES) {
+						if (hist_flow[flit_recd.src] == NULL)
+							hist_flow[flit_recd.src] = new histogram;
+						hist_flow[flit_recd.src]->record(pkt_latency);
+					}
+					measured_pkts_recv++;
+					measured_latency += pkt_latency;
+				}
+			}
+			
 			if (time_first_flit_in == 0)
 				time_first_flit_in = sim_count;
 			time_last_flit_in = sim_count;
@@ -182,12 +338,21 @@ flit* ipcore::create_hdt_flit(int pkt_id, int flit_id, UI route_info) {
 	flit_out->pkthdr.nochdr.pktid = pkt_id;
 	flit_out->pkthdr.nochdr.flitid = flit_id;
 	flit_out->pkthdr.nochdr.hopcount = 0;
+	flit_out->pkthdr.nochdr.flowseq = FLOW_SEQ_NONE;
 	flit_out->pkthdr.nochdr.flithdr.header.rtalgo = RT_ALGO;
     flit_out->pkthdr.nochdr.flithdr.header.rtfi.fail = false;
     flit_out->pkthdr.nochdr.flithdr.header.rtfi.last_back_adap = false;
     flit_out->pkthdr.nochdr.flithdr.header.rtfi.last_back = false;
     flit_out->pkthdr.nochdr.flithdr.header.rtfi.last_dir = ND;
     flit_out->pkthdr.nochdr.flithdr.header.rtfi.history = 0;
+	flit_out->pkthdr.nochdr.flithdr.header.mcast.mode = MCAST_NONE;
+	flit_out->pkthdr.nochdr.flithdr.header.mcast.group = 0;
+	flit_out->pkthdr.nochdr.flithdr.header.mcast.target = MCAST_NO_TARGET;
+	flit_out->pkthdr.nochdr.flithdr.header.mcast.seq = 0;
+	flit_out->pkthdr.nochdr.flithdr.header.msg.id = 0;
+	flit_out->pkthdr.nochdr.flithdr.header.msg.cls = 0;
+	flit_out->pkthdr.nochdr.flithdr.header.msg.bytes = 0;
+	flit_out->pkthdr.nochdr.flithdr.header.msg.pkts = 0;
 	if(RT_ALGO == SOURCE)
 		flit_out->pkthdr.nochdr.flithdr.header.rthdr.sourcehdr.route = route_info;
 	else
@@ -200,6 +365,13 @@ flit* ipcore::create_hdt_flit(int pkt_id, int flit_id, UI route_info) {
 	flit_out->simdata.num_waits = 0;
 	flit_out->simdata.num_sw = 0;
 	flit_out->simdata.gtimestamp = sim_count;
+	flit_out->simdata.itimestamp = sim_count;
+	
+	// packet is measured if its head is generated inside measurement window
+	pkt_measured = in_measure_window(sim_count);
+	flit_out->simdata.measured = pkt_measured;
+	if(pkt_measured && MEASURE_WINDOW_ON)
+		measured_pkts_gen++;
 	
 	return flit_out;
 }
@@ -221,12 +393,21 @@ flit* ipcore::create_head_flit(int pkt_id, int flit_id, UI route_info) {
 	flit_out->pkthdr.nochdr.pktid = pkt_id;
 	flit_out->pkthdr.nochdr.flitid = flit_id;
 	flit_out->pkthdr.nochdr.hopcount = 0;
+	flit_out->pkthdr.nochdr.flowseq = FLOW_SEQ_NONE;
 	flit_out->pkthdr.nochdr.flithdr.header.rtalgo = RT_ALGO;
     flit_out->pkthdr.nochdr.flithdr.header.rtfi.fail = false;
     flit_out->pkthdr.nochdr.flithdr.header.rtfi.last_back = false;
     flit_out->pkthdr.nochdr.flithdr.header.rtfi.last_back_adap = false;
     flit_out->pkthdr.nochdr.flithdr.header.rtfi.last_dir = ND;
     flit_out->pkthdr.nochdr.flithdr.header.rtfi.history = 0;
+	flit_out->pkthdr.nochdr.flithdr.header.mcast.mode = MCAST_NONE;
+	flit_out->pkthdr.nochdr.flithdr.header.mcast.group = 0;
+	flit_out->pkthdr.nochdr.flithdr.header.mcast.target = MCAST_NO_TARGET;
+	flit_out->pkthdr.nochdr.flithdr.header.mcast.seq = 0;
+	flit_out->pkthdr.nochdr.flithdr.header.msg.id = 0;
+	flit_out->pkthdr.nochdr.flithdr.header.msg.cls = 0;
+	flit_out->pkthdr.nochdr.flithdr.header.msg.bytes = 0;
+	flit_out->pkthdr.nochdr.flithdr.header.msg.pkts = 0;
 	if(RT_ALGO == SOURCE)
 		flit_out->pkthdr.nochdr.flithdr.header.rthdr.sourcehdr.route = route_info;
 	else
@@ -240,6 +421,13 @@ flit* ipcore::create_head_flit(int pkt_id, int flit_id, UI route_info) {
 	flit_out->simdata.num_waits = 0;
 	flit_out->simdata.num_sw = 0;
 	flit_out->simdata.gtimestamp = sim_count;
+	flit_out->simdata.itimestamp = sim_count;
+	
+	// packet is measured if its head is generated inside measurement window
+	pkt_measured = in_measure_window(sim_count);
+	flit_out->simdata.measured = pkt_measured;
+	if(pkt_measured && MEASURE_WINDOW_ON)
+		measured_pkts_gen++;
 	
 	return flit_out;
 }
@@ -260,6 +448,7 @@ flit* ipcore::create_data_flit(int pkt_id, int flit_id) {
 	flit_out->pkthdr.nochdr.pktid = pkt_id;
 	flit_out->pkthdr.nochdr.flitid = flit_id;
 	flit_out->pkthdr.nochdr.hopcount = 0;
+	flit_out->pkthdr.nochdr.flowseq = FLOW_SEQ_NONE;
 	
 	flit_out->simdata.gtime = sc_time_stamp();
 	flit_out->simdata.ctime = sc_time_stamp();
@@ -268,6 +457,8 @@ flit* ipcore::create_data_flit(int pkt_id, int flit_id) {
 	flit_out->simdata.num_waits = 0;
 	flit_out->simdata.num_sw = 0;
 	flit_out->simdata.gtimestamp = sim_count;
+	flit_out->simdata.itimestamp = sim_count;
+	flit_out->simdata.measured = pkt_measured;
 	
 	return flit_out;
 }
@@ -288,6 +479,7 @@ flit* ipcore::create_tail_flit(int pkt_id, int flit_id) {
 	flit_out->pkthdr.nochdr.pktid = pkt_id;
 	flit_out->pkthdr.nochdr.flitid = flit_id;
 	flit_out->pkthdr.nochdr.hopcount = 0;
+	flit_out->pkthdr.nochdr.flowseq = FLOW_SEQ_NONE;
 	
 	flit_out->simdata.gtime = sc_time_stamp();
 	flit_out->simdata.ctime = sc_time_stamp();
@@ -296,10 +488,312 @@ flit* ipcore::create_tail_flit(int pkt_id, int flit_id) {
 	flit_out->simdata.num_waits = 0;
 	flit_out->simdata.num_sw = 0;
 	flit_out->simdata.gtimestamp = sim_count;
+	flit_out->simdata.itimestamp = sim_count;
+	flit_out->simdata.measured = pkt_measured;
 	
 	return flit_out;
 }
 
+///////////////////////////////////////////////////////////////////////////
+/// Method to append flit to source injection queue
+/// \param flit_in pointer to flit created by create_*_flit (deleted here)
+///////////////////////////////////////////////////////////////////////////
+void ipcore::enqueue_flit(flit *flit_in) {
+	inj_queue.push_back(*flit_in);
+	delete flit_in;
+	inj_flits_in++;
+	if(inj_queue.size() > inj_queue_max)
+		inj_queue_max = inj_queue.size();
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// Method to inject front flit of source injection queue into network
+/// \return true if flit was sent, false if queue is empty or core buffer is full
+///////////////////////////////////////////////////////////////////////////
+bool ipcore::inject_flit() {
+	if(inj_queue.empty() || !credit_in[0].read().freeBuf)
+		return false;
+	
+	flit flit_out = inj_queue.front();
+	inj_queue.pop_front();
+	inj_flits_out++;
+	// number packets of unicast flows in injection order, flits of a packet share its number
+	flit_type type = flit_out.pkthdr.nochdr.flittype;
+	if(type == HEAD || type == HDT) {
+		flit_head &hdr = flit_out.pkthdr.nochdr.flithdr.header;
+		UI dst = hdr.rthdr.dsthdr.dst;
+		bool tracked = (RT_ALGO != SOURCE && hdr.mcast.mode == MCAST_NONE && dst < MAX_NUM_TILES);
+		inj_flowseq = tracked ? flow_seq[dst]++ : FLOW_SEQ_NONE;
+	}
+	flit_out.pkthdr.nochdr.flowseq = inj_flowseq;
+	// messages whose last flit left the queue are sent (ids and flit counts grow together)
+	while(!msg_queued.empty() && msg_queued.begin()->second <= inj_flits_out)
+		msg_queued.erase(msg_queued.begin());
+	flit_out.simdata.itimestamp = sim_count;
+	flit_outport.write(flit_out);
+	if(LOG >= 1)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" Sending flit from core "<<flit_out;
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// Method to inject front flit of source injection queue at application pace
+/// \param next_inject earliest cycle of next injection, updated when flit is sent
+/// \param flit_interval cycles between flits of one packet (next packet may follow after 1 cycle)
+/// \return true if flit was sent
+/// - call once per clock cycle from send_app, flits of all packets enqueued
+///   by enqueue_packet, send_message etc. are sent without further bookkeeping
+///////////////////////////////////////////////////////////////////////////
+bool ipcore::inject_step(ULL &next_inject, int flit_interval) {
+	if(sim_count < next_inject || inj_queue.empty())
+		return false;
+	flit_type type = inj_queue.front().pkthdr.nochdr.flittype;
+	if(!inject_flit())
+		return false;
+	next_inject = sim_count + ((type == HEAD || type == DATA) ? flit_interval : 1);
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// Method to check if source injection queue is full
+/// \return true if SRC_QUEUE_SIZE is set and reached
+///////////////////////////////////////////////////////////////////////////
+bool ipcore::inj_queue_full() {
+	return (SRC_QUEUE_SIZE > 0 && inj_queue.size() >= SRC_QUEUE_SIZE);
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// Method to create a packet and append it to source injection queue
+/// \param route_info destination or route code
+/// \param num_flits packet size (1 - hdt flit)
+/// \param cmd_value command field of every flit
+/// \param data_int_value integer data field of every flit
+/// \return packet id
+/// - command and data are set in every flit, so receiver can read them from tail
+///////////////////////////////////////////////////////////////////////////
+UI ipcore::enqueue_packet(UI route_info, int num_flits, int cmd_value, int data_int_value) {
+	UI pkt_id = num_pkts_gen;
+	flit *flit_out;
+	if(num_flits <= 1) {
+		flit_out = create_hdt_flit(pkt_id, 0, route_info);
+		set_payload(flit_out, cmd_value, data_int_value);
+		enqueue_flit(flit_out);
+		num_flits = 1;
+	}
+	else {
+		flit_out = create_head_flit(pkt_id, 0, route_info);
+		set_payload(flit_out, cmd_value, data_int_value);
+		enqueue_flit(flit_out);
+		for(int i = 1; i < num_flits - 1; i++) {
+			flit_out = create_data_flit(pkt_id, i);
+			set_payload(flit_out, cmd_value, data_int_value);
+			enqueue_flit(flit_out);
+		}
+		flit_out = create_tail_flit(pkt_id, num_flits - 1);
+		set_payload(flit_out, cmd_value, data_int_value);
+		enqueue_flit(flit_out);
+	}
+	num_pkts_gen++;
+	num_flits_gen += num_flits;
+	return pkt_id;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// Method to send one packet to a set of destinations
+/// \param dsts destination tiles (own tile is ignored)
+/// \param num_flits packet size (1 - hdt flit)
+/// \param cmd_value command field of every flit
+/// \param data_int_value integer data field of every flit
+/// \param mode MCAST_TREE - one packet replicated along XY tree,
+///             MCAST_PATH_UP - dual-path worms (up and down the snake path),
+///             MCAST_UNICAST (or MCAST_NONE) - one packet per destination
+/// \return number of destinations
+/// - every destination receives a packet with its own packet id, so packet and
+///   flit counts of drain detection include all copies
+///////////////////////////////////////////////////////////////////////////
+UI ipcore::enqueue_multicast(const tile_set &dsts, int num_flits, int cmd_value, int data_int_value, UI mode) {
+	tile_set set = dsts;
+	set.reset(tileID);
+	UI count = set.count();
+	if(count == 0)
+		return 0;
+	if(mode == MCAST_NONE || mode == MCAST_PATH_DOWN)
+		mode = (mode == MCAST_NONE) ? MCAST_UNICAST : MCAST_PATH_UP;
+	UI flits = (num_flits < 1) ? 1 : num_flits;
+	
+	mcast_hdr hdr;
+	hdr.group = multicast.add_group(set);
+	hdr.seq = multicast.start(tileID, hdr.group, flits, mode, sim_count);
+	hdr.target = MCAST_NO_TARGET;
+	
+	// packets to send: (mode, number of destinations served, first target)
+	vector<UI> modes, served, targets;
+	if(mode == MCAST_TREE) {
+		modes.push_back(MCAST_TREE); served.push_back(count); targets.push_back(MCAST_NO_TARGET);
+	}
+	else if(mode == MCAST_PATH_UP) {
+		UI lab = multicast_table::label(tileID);
+		UI up = 0;
+		for(UI d = 0; d < num_tiles; d++)
+			if(set.test(d) && multicast_table::label(d) > lab)
+				up++;
+		if(up > 0) {
+			modes.push_back(MCAST_PATH_UP); served.push_back(up); targets.push_back(multicast.path_next(hdr.group, tileID, true));
+		}
+		if(up < count) {
+			modes.push_back(MCAST_PATH_DOWN); served.push_back(count - up); targets.push_back(multicast.path_next(hdr.group, tileID, false));
+		}
+	}
+	else {
+		for(UI d = 0; d < num_tiles; d++)
+			if(set.test(d)) {
+				modes.push_back(MCAST_UNICAST); served.push_back(1); targets.push_back(d);
+			}
+	}
+	
+	for(UI k = 0; k < modes.size(); k++) {
+		// unicast copies are routed to their destination, replicated packets by multicast header
+		enqueue_packet((modes[k] == MCAST_UNICAST) ? targets[k] : tileID, flits, cmd_value, data_int_value);
+		hdr.mode = modes[k];
+		hdr.target = targets[k];
+		inj_queue[inj_queue.size() - flits].pkthdr.nochdr.flithdr.header.mcast = hdr;
+		multicast.add_injected(modes[k], flits);
+		// account one packet per destination reached by replication
+		num_pkts_gen += served[k] - 1;
+		num_flits_gen += (ULL)flits * (served[k] - 1);
+		if(pkt_measured && MEASURE_WINDOW_ON)
+			measured_pkts_gen += served[k] - 1;
+	}
+	return count;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// Method to send contribution of this tile to a reduction
+/// \param root tile receiving reduced data
+/// \param members contributing tiles (root is ignored), same set at all members
+/// \param num_flits packet size (1 - hdt flit)
+/// \param cmd_value command field of every flit
+/// \param data_int_value integer data field of every flit
+/// \param rid reduction id, same at all members and unique for each reduced packet
+/// \param mode MCAST_REDUCE - routers on XY tree to root combine packets,
+///             MCAST_REDUCE_END (or other) - root receives packet of every member
+/// \return false if this tile is root (its data needs no network) or not a member
+/// - with MCAST_REDUCE root receives one packet per reduction id
+///////////////////////////////////////////////////////////////////////////
+bool ipcore::enqueue_reduction(UI root, const tile_set &members, int num_flits, int cmd_value, int data_int_value, UI rid, UI mode) {
+	if(tileID == root)
+		return false;
+	tile_set set = members;
+	set.reset(root);
+	if(!set.test(tileID)) {	// every member must use the same set, including itself
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" Error: tile is not member of its reduction "<<rid<<endl;
+		return false;
+	}
+	if(mode != MCAST_REDUCE)
+		mode = MCAST_REDUCE_END;
+	UI flits = (num_flits < 1) ? 1 : num_flits;
+	
+	mcast_hdr hdr;
+	hdr.mode = mode;
+	hdr.group = multicast.add_group(set);
+	hdr.target = root;
+	hdr.seq = rid;
+	multicast.start_reduction(tileID, hdr.group, root, rid, flits, mode, sim_count);
+	
+	enqueue_packet(root, flits, cmd_value, data_int_value);
+	inj_queue[inj_queue.size() - flits].pkthdr.nochdr.flithdr.header.mcast = hdr;
+	multicast.add_injected(mode, flits);
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// Method to send a message
+/// \param dst destination tile
+/// \param bytes message size (in bytes)
+/// \param cls message class (statistics are kept per class)
+/// \return handle (message id) for message_status, MSG_NO_HANDLE if dst is invalid
+/// - message is split into packets of at most msg_packet_flits flits, a packet
+///   of n flits carries HEAD_PAYLOAD + (n - 1) * DATA_PAYLOAD bytes, only the
+///   last packet is shorter (empty message is one hdt flit)
+/// - every flit carries class in command and handle in integer data field
+/// - flits are appended to injection queue at once, application injects them
+///   with inject_step and checks completion with message_status
+///////////////////////////////////////////////////////////////////////////
+UI ipcore::send_message(UI dst, UI bytes, int cls) {
+	if(dst >= num_tiles || dst == tileID) {
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" Error: invalid message destination "<<dst<<endl;
+		return MSG_NO_HANDLE;
+	}
+	UI max_flits = (msg_packet_flits < 1) ? 1 : msg_packet_flits;
+	UI max_bytes = HEAD_PAYLOAD + (max_flits - 1) * DATA_PAYLOAD;	// payload of largest packet
+	if(max_bytes == 0)
+		max_bytes = 1;
+	
+	msg_hdr hdr;
+	hdr.id = msg_next_id++;
+	hdr.cls = cls;
+	hdr.bytes = bytes;
+	hdr.pkts = (bytes == 0) ? 1 : (bytes + max_bytes - 1) / max_bytes;
+	
+	UI left = bytes;
+	for(UI k = 0; k < hdr.pkts; k++) {
+		UI pkt_bytes = (left > max_bytes) ? max_bytes : left;
+		left -= pkt_bytes;
+		UI flits = 1;
+		if(pkt_bytes > HEAD_PAYLOAD)
+			flits += (DATA_PAYLOAD > 0) ? (pkt_bytes - HEAD_PAYLOAD + DATA_PAYLOAD - 1) / DATA_PAYLOAD : max_flits - 1;
+		enqueue_packet(dst, flits, cls, hdr.id);
+		inj_queue[inj_queue.size() - flits].pkthdr.nochdr.flithdr.header.msg = hdr;
+	}
+	msg_queued[hdr.id] = inj_flits_in;
+	messages_sent++;
+	msg_table.send(tileID, hdr.id, cls, bytes, hdr.pkts);
+	if(LOG >= 3)
+		eventlog<<"\ntime: "<<sc_time_stamp()<<" name: "<<this->name()<<" tile: "<<tileID<<" message "<<hdr.id<<" to "<<dst
+		        <<" bytes "<<bytes<<" packets "<<hdr.pkts;
+	return hdr.id;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// Method to return status of a sent message
+/// \param handle value returned by send_message
+/// \return MSG_QUEUED, MSG_SENT, MSG_DELIVERED (MSG_UNKNOWN for invalid handle)
+///////////////////////////////////////////////////////////////////////////
+msg_status ipcore::message_status(UI handle) {
+	if(handle >= msg_next_id)
+		return MSG_UNKNOWN;
+	if(msg_queued.find(handle) != msg_queued.end())
+		return MSG_QUEUED;
+	if(msg_table.pending(tileID, handle))
+		return MSG_SENT;
+	return MSG_DELIVERED;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// Method to read a reassembled message
+/// \param msg message removed from inbox
+/// \return false if inbox is empty
+/// - inbox is filled only while msg_inbox_on is set
+///////////////////////////////////////////////////////////////////////////
+bool ipcore::recv_message(message &msg) {
+	if(msg_inbox.empty())
+		return false;
+	msg = msg_inbox.front();
+	msg_inbox.pop_front();
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+/// Method to count completed transaction
+/// \param issue_cycle cycle request was issued at
+/// - round trip is recorded for transactions issued inside measurement window
+///////////////////////////////////////////////////////////////////////////
+void ipcore::record_transaction(ULL issue_cycle) {
+	transactions++;
+	if(in_measure_window(issue_cycle))
+		hist[HIST_ROUND_TRIP].record(sim_count - issue_cycle);
+}
+
 ///////////////////////////////////////////////////////////////////////////
 /// Method to assign value to command field of a flit
 /// \param inflit pointer to flit
@@ -452,6 +946,14 @@ void ipcore::get_payload(flit inflit, int &cmd_value, string &data_string_value)
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////
+/// Method to write application specific results
+/// \param out results file
+/// - called for every core after network statistics, redefine at app. level
+///////////////////////////////////////////////////////////////////////////
+void ipcore::report(ofstream &) {
+}
+
 ///////////////////////////////////////////////////////////////////////////
 /// Method to finalize statistics and close log
 ///////////////////////////////////////////////////////////////////////////
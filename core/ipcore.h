@@ -36,11 +36,19 @@
 #include "flit.h"
 #include "credit.h"
 #include "rng.h"
+#include "histogram.h"
+#include "flow_stats.h"
+#include "burst_meter.h"
+#include "multicast.h"
+#include "message.h"
+#include "reorder_buffer.h"
 
 #include <fstream>
 #include <string>
 #include <math.h>
 #include <dlfcn.h>
+#include <map>
+#include <deque>
 
 using namespace std;
 
@@ -56,6 +64,7 @@ struct ipcore : public sc_module {
 	sc_in<flit>             flit_inport;		            ///< input data/flit port
 	sc_out<flit>            flit_outport;		            ///< ouput data/flit port
 	sc_inout<creditLine>    credit_in[NUM_VCS];	            ///< input ports to recieve credit info (buffer status)
+	sc_out<bool>            eject_ready;		            ///< output port to signal that core accepts flits (false holds them in router)
 	// PORTS END //////////////////////////////////////////////////////////////////////////////
 	
 	// Constructor
@@ -78,6 +87,29 @@ struct ipcore : public sc_module {
 	/// create a tail flit with given packet id and flit id
 	flit* create_tail_flit(int pkt_id, int flit_id);	
 	
+	/// append flit to source injection queue (flit is deleted)
+	void enqueue_flit(flit *flit_in);
+	/// send front flit of source injection queue if core buffer has space, returns true if sent
+	bool inject_flit();
+	/// inject front flit of queue if next_inject is reached, flits of one packet leave flit_interval cycles apart
+	bool inject_step(ULL &next_inject, int flit_interval);
+	/// returns true if source injection queue has reached SRC_QUEUE_SIZE
+	bool inj_queue_full();
+	/// create packet of given size and append its flits to injection queue, returns packet id
+	UI   enqueue_packet(UI route_info, int num_flits, int cmd_value, int data_int_value);
+	/// send packet to set of destinations in given mode (mcast_mode), returns number of destinations
+	UI   enqueue_multicast(const tile_set &dsts, int num_flits, int cmd_value, int data_int_value, UI mode);
+	/// send contribution of this tile to reduction rid of members at root (MCAST_REDUCE or MCAST_REDUCE_END)
+	bool enqueue_reduction(UI root, const tile_set &members, int num_flits, int cmd_value, int data_int_value, UI rid, UI mode);
+	/// send message of given size (in bytes) and class to dst split into packets, returns its handle
+	UI   send_message(UI dst, UI bytes, int cls);
+	/// returns status of message with given handle, never blocks
+	msg_status message_status(UI handle);
+	/// move oldest reassembled message of inbox to msg, returns false if inbox is empty
+	bool recv_message(message &msg);
+	/// count completed transaction (request/reply) issued at given cycle
+	void record_transaction(ULL issue_cycle);
+	
 	/// sets command field of flit equal to given value
 	void set_cmd(flit*, int cmd_value);
 	/// sets integer data field of flit equal to given value
@@ -105,6 +137,7 @@ struct ipcore : public sc_module {
     bool set_creating_flits_state(UI toTileID, bool grant); ///< change ip core state of generating flit
     
     void closeLogs(); ///< log functions
+    virtual void report(ofstream &out); ///< write application specific results (default: nothing)
     
 	// FUNCTIONS END /////////////////////////////////////////////////////////////////////////
 	
@@ -130,6 +163,43 @@ struct ipcore : public sc_module {
 	double  avg_latency_flit;		                ///< average latency (in clock cycles) per flit
 	double  avg_throughput;		                    ///< average throughput (in Gbps)
     bool    accept_destinations[MAX_NUM_TILES];     ///< destination to which flits can be generated
+	bool    send_finished;                          ///< send_app has returned (traffic generation is over)
+	bool    sched_active;                           ///< core generates packets on schedule (traffic generators)
+	deque<flit> inj_queue;                          ///< source injection queue of network interface (flits waiting for core buffer)
+	ULL     inj_queue_max;                          ///< largest occupancy of injection queue (in flits)
+	ULL     src_stall_cycles;                       ///< cycles generation was stalled by full injection queue
+	ULL     total_queue_latency;                    ///< total source queueing latency of received flits (generation to injection)
+	ULL     total_net_latency;                      ///< total network latency of received flits (injection to arrival)
+	ULL     sched_start;                            ///< cycle at which generation schedule starts
+	ULL     sched_time;                             ///< scheduled generation time of next packet
+	ULL     sched_flits;                            ///< number of flits in packets scheduled before sched_time
+	ULL     transactions;                           ///< completed transactions (closed-loop applications)
+	burst_meter burst;                              ///< burstiness of generated packet stream (by scheduled time)
+	bool    pkt_measured;                           ///< last generated packet is inside measurement window
+	ULL     measured_pkts_gen;                      ///< number of generated packets inside measurement window
+	ULL     measured_pkts_recv;                     ///< number of received packets generated inside measurement window
+	ULL     measured_flits_recv;                    ///< number of received flits generated inside measurement window
+	ULL     measured_latency;                       ///< total packet latency of measured packets
+	ULL     measured_latency_flit;                  ///< total flit latency of measured flits
+	histogram hist[HIST_NUM_TYPES];                 ///< distributions of received packets/flits latency, hops and waits
+	histogram *hist_flow[MAX_NUM_TILES];            ///< packet latency distribution per source tile (created on first packet)
+	flow_table flows;                               ///< per source statistics of received traffic (sparse)
+	map<ULL, ULL> head_gtimestamp;                  ///< generation time of head flits of packets in flight, key is (src, pktid)
+	map<ULL, ULL> mcast_head;                       ///< multicast operation of packets in flight, key is (src, pktid)
+	ULL     inj_flits_in;                           ///< flits appended to injection queue
+	ULL     inj_flits_out;                          ///< flits injected from injection queue
+	UI      msg_packet_flits;                       ///< largest packet of a message (in flits)
+	UI      msg_next_id;                            ///< id (handle) of next sent message
+	ULL     messages_sent;                          ///< number of sent messages
+	ULL     messages_recv;                          ///< number of reassembled messages
+	map<UI, ULL> msg_queued;                        ///< messages with flits in injection queue, value is inj_flits_in after last flit
+	map<ULL, msg_hdr> msg_head;                     ///< message header of multi-flit packets in flight, key is (src, pktid)
+	map<ULL, UI> msg_parts;                         ///< arrived packets of messages being reassembled, key is msg_key
+	bool    msg_inbox_on;                           ///< keep reassembled messages for recv_message (set by application)
+	deque<message> msg_inbox;                       ///< reassembled messages not read by application
+	UI      flow_seq[MAX_NUM_TILES];                ///< sequence number of next packet of each flow from this tile, by destination
+	UI      inj_flowseq;                            ///< sequence number of packet being injected
+	reorder_buffer rob;                             ///< reorder buffer restoring order of received flows
 	RNG     *ran_var;	                            ///< random variable generator
 	// VARIABLES END /////////////////////////////////////////////////////////////////////////
 };
@@ -51,6 +51,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <time.h>
+#include <iomanip>
 #include "NoC.h"
 #include "../config/default.h"
 
@@ -60,6 +61,11 @@ ofstream results_log;
 sc_clock *nw_clock;
 string app_libname[MAX_NUM_TILES];
 string DIRS_NAMES[6];
+string TRACE_FILE;
+string TRAFFIC_MATRIX("config/traffic.matrix");
+string SCENARIO_FILE;
+string TASK_GRAPH("config/task.graph");
+string DIRNAME("sim1");
 
 int sc_main(int argc, char *argv[]) {
 
@@ -69,7 +75,6 @@ int sc_main(int argc, char *argv[]) {
     cout<<"  Portion of changes by Alexander Rumyanthev (darkstreamray@gmail.com)\n";
     cout<<"  NIRGAM v 2.0 Build "<< __DATE__<<" "<<__TIME__<<"\n";
 	cout<<"-------------------------------------------------------------------------------"<<endl;
-	string DIRNAME = string("sim1");
 
 	// open event log file	
 	string event_filename = string("log/nirgam/event.log");
@@ -117,6 +122,75 @@ int sc_main(int argc, char *argv[]) {
 			else if(name=="TG_NUM"){
 				ULL value; fil1 >> value; TG_NUM = value;
 			}
+			else if(name=="STATS_WINDOW"){
+				ULL value; fil1 >> value; STATS_WINDOW = value;
+			}
+			else if(name=="AUTO_STOP"){
+				UI value; fil1 >> value; AUTO_STOP = ((value == 0) ? false : true);
+			}
+			else if(name=="CI_TOLERANCE"){
+				double value; fil1 >> value; CI_TOLERANCE = value;
+			}
+			else if(name=="CI_BATCHES"){
+				UI value; fil1 >> value; CI_BATCHES = ((value < 2) ? 2 : value);
+			}
+			else if(name=="MEASURE_START"){
+				ULL value; fil1 >> value; MEASURE_START = value;
+			}
+			else if(name=="MEASURE_END"){
+				ULL value; fil1 >> value; MEASURE_END = value;
+			}
+			else if(name=="DRAIN_STOP"){
+				UI value; fil1 >> value; DRAIN_STOP = ((value == 0) ? false : true);
+			}
+			else if(name=="DRAIN_TIMEOUT"){
+				ULL value; fil1 >> value; DRAIN_TIMEOUT = value;
+			}
+			else if(name=="WATCHDOG_CYCLES"){
+				ULL value; fil1 >> value; WATCHDOG_CYCLES = value;
+			}
+			else if(name=="WATCHDOG_ABORT"){
+				UI value; fil1 >> value; WATCHDOG_ABORT = ((value == 0) ? false : true);
+			}
+			else if(name=="LIVELOCK_HOPS"){
+				UI value; fil1 >> value; LIVELOCK_HOPS = value;
+			}
+			else if(name=="SAT_STOP"){
+				UI value; fil1 >> value; SAT_STOP = ((value == 0) ? false : true);
+			}
+			else if(name=="SAT_WINDOWS"){
+				UI value; fil1 >> value; SAT_WINDOWS = value;
+			}
+			else if(name=="SAT_TOLERANCE"){
+				double value; fil1 >> value; SAT_TOLERANCE = value;
+			}
+			else if(name=="SRC_QUEUE_SIZE"){
+				UI value; fil1 >> value; SRC_QUEUE_SIZE = value;
+			}
+			else if(name=="TRAFFIC_EXPORT"){
+				UI value; fil1 >> value; TRAFFIC_EXPORT = ((value == 0) ? false : true);
+			}
+			else if(name=="TRACE_FILE"){
+				string value; fil1 >> value; TRACE_FILE = ((value == "NONE") ? string("") : value);
+			}
+			else if(name=="TRAFFIC_MATRIX"){
+				string value; fil1 >> value; TRAFFIC_MATRIX = value;
+			}
+			else if(name=="SCENARIO_FILE"){
+				string value; fil1 >> value; SCENARIO_FILE = ((value == "NONE") ? string("") : value);
+			}
+			else if(name=="TASK_GRAPH"){
+				string value; fil1 >> value; TASK_GRAPH = value;
+			}
+			else if(name=="RECOVERY_TOLERANCE"){
+				double value; fil1 >> value; RECOVERY_TOLERANCE = value;
+			}
+			else if(name=="REDUCE_COMBINE_CYCLES"){
+				ULL value; fil1 >> value; REDUCE_COMBINE_CYCLES = value;
+			}
+			else if(name=="REORDER_BUFFER"){
+				UI value; fil1 >> value; REORDER_BUFFER = value;
+			}
 			else if(name=="RT_ALGO"){
 				fil1 >> name;
 				if(name == "XY")
@@ -221,6 +295,8 @@ int sc_main(int argc, char *argv[]) {
 	fil1.close();
 
 	num_tiles = num_rows * num_cols;	// compute number of tiles
+	if(SCENARIO_FILE != "")
+		scenario.load(SCENARIO_FILE);	// phases applied to all traffic generators
 	nw_clock = new sc_clock("NW_CLOCK",CLK_PERIOD,SC_NS);	// create global clock
 	
 	// open log and result files
@@ -607,6 +683,10 @@ int sc_main(int argc, char *argv[]) {
     ULL noc_total_flits_recv = 0;
     ULL noc_total_packets_recv = 0;
     ULL noc_unrouted_wc_latency = 0;
+    ULL noc_total_queue_latency = 0;
+    ULL noc_total_net_latency = 0;
+    ULL noc_inj_queue_max = 0;
+    ULL noc_transactions = 0;
 	double noc_wc_latency_core = 0.0;
     double noc_bufs_util = 0.0;
     double noc_vcs_util = 0.0;
@@ -628,13 +708,25 @@ int sc_main(int argc, char *argv[]) {
             noc_bufs_util += (noc.nwtile[i][j])->return_bufs_util();
             noc_vcs_util += (noc.nwtile[i][j])->return_vcs_util();
             noc_unrouted_avg_latency += (noc.nwtile[i][j])->return_avr_latency_unrouted();
+            noc_total_queue_latency += (noc.nwtile[i][j])->return_total_queue_latency();
+            noc_total_net_latency += (noc.nwtile[i][j])->return_total_net_latency();
+            if ((noc.nwtile[i][j])->return_inj_queue_max() > noc_inj_queue_max)
+                noc_inj_queue_max = (noc.nwtile[i][j])->return_inj_queue_max();
+            noc_transactions += (noc.nwtile[i][j])->return_transactions();
             if ((noc.nwtile[i][j])->return_wc_latency_unrouted() > noc_unrouted_wc_latency)
                 noc_unrouted_wc_latency = (noc.nwtile[i][j])->return_wc_latency_unrouted();
 		}
 	}
 	
 	double noc_latency = (double)noc_total_latency / noc_total_flits;
-    double noc_latency_core = (double)noc_total_latency_core / noc_total_flits_recv;
+    double noc_latency_core = 0.0;
+    double noc_latency_queue = 0.0;
+    double noc_latency_net = 0.0;
+    if (noc_total_flits_recv > 0) {
+        noc_latency_core = (double)noc_total_latency_core / noc_total_flits_recv;
+        noc_latency_queue = (double)noc_total_queue_latency / noc_total_flits_recv;
+        noc_latency_net = (double)noc_total_net_latency / noc_total_flits_recv;
+    }
     double noc_latency_packet = (double)noc_total_latency / noc_total_packets;
     double noc_latency_core_packet = (double)noc_total_latency_core / noc_total_packets_recv;
 	noc_wc_latency_core = noc_wc_latency_core / tiles_count;
@@ -656,6 +748,54 @@ int sc_main(int argc, char *argv[]) {
     cout<<"\nSend packets      = "<<noc_total_packets_send<<"  and flits = "<<noc_total_flits_send<<endl;
     cout<<"Recieved packets  = "<<noc_total_packets_recv<<"  and flits = "<<noc_total_flits_recv<<endl;
     cout<<"Travelled packets = "<<noc_total_packets<<" and flits = "<<noc_total_flits<<endl;
+
+    string end_reason;
+    if (noc.deadlock_abort)
+        end_reason = string("deadlock detected");
+    else if (noc.saturated)
+        end_reason = string("network saturated");
+    else if (noc.drained)
+        end_reason = string("drained, all generated flits received");
+    else if (noc.drain_timed_out)
+        end_reason = string("drain timed out, generated flits still in network");
+    else if (noc.measure_drained)
+        end_reason = string("all measured packets delivered");
+    else if (noc.ci_reached)
+        end_reason = string("steady-state confidence interval reached");
+    else
+        end_reason = string("SIM_NUM reached");
+    results_log<<"Simulation ended at cycle "<<noc.sim_count<<" ("<<end_reason<<")";
+    cout<<"Simulation ended at cycle "<<noc.sim_count<<" ("<<end_reason<<")";
+    if (noc.gen_done_cycle != 0) {
+        results_log<<" , generation finished at cycle "<<noc.gen_done_cycle;
+        cout<<" , generation finished at cycle "<<noc.gen_done_cycle;
+    }
+    results_log<<endl;
+    cout<<endl;
+    
+    if (noc.saturated) {
+        UI k = noc.ts_cycle.size() - 1;
+        results_log<<"SATURATED: accepted throughput = "<<noc.ts_tput[k]<<" , offered load = "<<noc.ts_offered[k]
+                   <<" (flits per cycle per tile), source lag = "<<noc.ts_lag[k]<<" cycles; latency results are not meaningful"<<endl;
+        cout<<"SATURATED: accepted throughput = "<<noc.ts_tput[k]<<" , offered load = "<<noc.ts_offered[k]
+            <<" (flits per cycle per tile), source lag = "<<noc.ts_lag[k]<<" cycles; latency results are not meaningful"<<endl;
+    }
+    
+    if (WATCHDOG_CYCLES > 0) {
+        results_log<<"Watchdog: ";
+        cout<<"Watchdog: ";
+        if (noc.deadlock_cycle != 0) {
+            results_log<<"deadlock at cycle "<<noc.deadlock_cycle;
+            cout<<"deadlock at cycle "<<noc.deadlock_cycle;
+        }
+        else {
+            results_log<<"no deadlock";
+            cout<<"no deadlock";
+        }
+        results_log<<" , max stuck VCs = "<<noc.max_stuck_vcs<<" , livelocked packets = "<<noc.livelock_pkts<<endl;
+        cout<<" , max stuck VCs = "<<noc.max_stuck_vcs<<" , livelocked packets = "<<noc.livelock_pkts<<endl;
+        results_log<<noc.watchdog_report;
+    }
     
     if (ADDITIONAL_INFO) {
         results_log<<"RT_ALGO = ";
@@ -706,11 +846,95 @@ int sc_main(int argc, char *argv[]) {
     }
     
     results_log<<"Overall average NoC latency       (in clock cycles per flit)   = "<<noc_latency_core<<endl;
+    results_log<<" - source queueing latency        (in clock cycles per flit)   = "<<noc_latency_queue<<endl;
+    results_log<<" - network latency                (in clock cycles per flit)   = "<<noc_latency_net<<endl;
     results_log<<"Overall average NoC latency       (in clock cycles per packet) = "<<noc_latency_core_packet<<endl;
 	results_log<<"Worst-case NoC latency            (in clock cycles per flit)   = "<<noc_wc_latency_core<<endl;
+    results_log<<"Largest source injection queue    (in flits)                   = "<<noc_inj_queue_max<<endl;
 	results_log<<"Overall average router latency    (in clock cycles per flit)   = "<<noc_latency<<endl;
     results_log<<"Overall average router latency    (in clock cycles per packet) = "<<noc_latency_packet<<endl;
     
+    // reordering of flows at receivers (cost of out-of-order delivery by adaptive routing)
+    ULL rob_packets = 0, rob_ooo = 0, rob_overflows = 0, rob_max = 0, rob_delay = 0, rob_held = 0;
+    for(UI i = 0; i < num_rows; i++)
+        for(UI j = 0; j < num_cols; j++) {
+            reorder_buffer *rob = (noc.nwtile[i][j] == NULL) ? NULL : (noc.nwtile[i][j])->return_reorder();
+            if (rob == NULL)
+                continue;
+            rob_packets += rob->packets;
+            rob_ooo += rob->ooo_packets;
+            rob_overflows += rob->overflows;
+            rob_delay += rob->total_delay;
+            rob_held += rob->held.size();
+            if (rob->max_occupancy > rob_max)
+                rob_max = rob->max_occupancy;
+        }
+    if (rob_packets > 0) {
+        double rob_avg_delay = (double)rob_delay / rob_packets;
+        results_log<<"\nReorder buffer per core (REORDER_BUFFER = "<<REORDER_BUFFER<<" packets, 0 - unlimited)"<<endl;
+        results_log<<"Packets out of order at arrival   (in percent)                 = "<<100.0 * rob_ooo / rob_packets
+                   <<" ("<<rob_ooo<<" of "<<rob_packets<<")"<<endl;
+        results_log<<"Average extra delivery latency    (in clock cycles per packet) = "<<rob_avg_delay<<endl;
+        results_log<<"Average NoC latency with in-order delivery (per packet)        = "<<noc_latency_core_packet + rob_avg_delay<<endl;
+        results_log<<"Largest reorder buffer occupancy  (in packets)                 = "<<rob_max<<endl;
+        results_log<<"Reorder buffer overflow events                                 = "<<rob_overflows<<endl;
+        if (rob_held > 0)
+            results_log<<"Packets still waiting for predecessors at end of simulation    = "<<rob_held<<endl;
+    }
+    
+    // closed-loop applications: round trip from request issue to reply arrival
+    if (noc_transactions > 0) {
+        histogram rtt;
+        for(UI i = 0; i < num_rows; i++)
+            for(UI j = 0; j < num_cols; j++)
+                if (noc.nwtile[i][j] != NULL && (noc.nwtile[i][j])->return_histogram(HIST_ROUND_TRIP) != NULL)
+                    rtt.merge(*(noc.nwtile[i][j])->return_histogram(HIST_ROUND_TRIP));
+        ULL active_cycles = (noc.sim_count > WARMUP) ? noc.sim_count - WARMUP : 1;
+        results_log<<"\nCompleted transactions                                         = "<<noc_transactions<<endl;
+        results_log<<"Transaction throughput            (per clock cycle)            = "<<(double)noc_transactions / active_cycles<<endl;
+        results_log<<"Average round-trip latency        (in clock cycles)            = "<<rtt.mean()
+                   <<" , p99 = "<<rtt.percentile(99)<<" , max = "<<rtt.max<<endl;
+    }
+    
+    // results of applications (e.g. protocol statistics)
+    for(UI i = 0; i < num_rows; i++)
+        for(UI j = 0; j < num_cols; j++)
+            if (noc.nwtile[i][j] != NULL)
+                (noc.nwtile[i][j])->report_app(results_log);
+    
+    // multicast operations and their saving against unicast emulation
+    multicast.print(results_log);
+    
+    // messages of send_message API, latency per class
+    msg_table.print(results_log);
+
+    // statistics of packets generated inside measurement window only
+    if (MEASURE_WINDOW_ON) {
+        ULL measured_sent = 0;
+        ULL measured_recv = 0;
+        ULL measured_flits = 0;
+        ULL measured_latency = 0;
+        ULL measured_latency_flit = 0;
+        for(UI i = 0; i < num_rows; i++) {
+            for(UI j = 0; j < num_cols; j++) {
+                if (noc.nwtile[i][j] == NULL)
+                    continue;
+                measured_sent += (noc.nwtile[i][j])->return_measured_packets_sent();
+                measured_recv += (noc.nwtile[i][j])->return_measured_packets_recv();
+                measured_flits += (noc.nwtile[i][j])->return_measured_flits_recv();
+                measured_latency += (noc.nwtile[i][j])->return_measured_latency();
+                measured_latency_flit += (noc.nwtile[i][j])->return_measured_latency_flit();
+            }
+        }
+        results_log<<"\nMeasurement window [ "<<MEASURE_START<<" , "<<MEASURE_END<<" ) : packets generated = "<<measured_sent
+                   <<" , delivered = "<<measured_recv<<((measured_recv >= measured_sent) ? " (all delivered)" : " (NOT all delivered)")<<endl;
+        results_log<<"Measured average NoC latency      (in clock cycles per flit)   = "
+                   <<((measured_flits == 0) ? 0.0 : (double)measured_latency_flit / measured_flits)<<endl;
+        results_log<<"Measured average NoC latency      (in clock cycles per packet) = "
+                   <<((measured_recv == 0) ? 0.0 : (double)measured_latency / measured_recv)<<endl;
+        results_log<<"(distributions and flow statistics below include measured packets only)"<<endl;
+    }
+    
     // compute overall avg throughput
     double noc_total_tput_N = 0;
     double noc_total_tput_S = 0;
@@ -777,7 +1001,245 @@ int sc_main(int argc, char *argv[]) {
     results_log<<"Overall average NoC number of waits (in clock cycles per flit) = "<<noc_avg_num_waits<<endl;
     results_log<<"Worst-case NoC number of hops       (number)                   = "<<noc_wc_num_sw<<endl;
     results_log<<"Overall average NoC number of hops  (number)                   = "<<noc_avg_num_sw<<endl;
-	
+
+	// merge per-tile distributions and report tail percentiles
+	string hist_names[HIST_NUM_TYPES];
+	hist_names[HIST_LATENCY_PKT]  = string("latency_pkt");
+	hist_names[HIST_LATENCY_FLIT] = string("latency_flit");
+	hist_names[HIST_HOPS]         = string("hops");
+	hist_names[HIST_WAITS]        = string("waits");
+	hist_names[HIST_QUEUE_FLIT]   = string("queue_flit");
+	hist_names[HIST_NETWORK_FLIT] = string("network_flit");
+	hist_names[HIST_ROUND_TRIP]   = string("round_trip");
+	hist_names[HIST_MESSAGE]      = string("message");
+	hist_names[HIST_REORDER_DEPTH] = string("reorder_depth");
+	hist_names[HIST_REORDER_DELAY] = string("reorder_delay");
+
+	string percentiles_file = DIRNAME + string("/stats/percentiles");
+	ofstream percentiles_log;
+	percentiles_log.open(percentiles_file.c_str());
+	if(!percentiles_log.is_open())
+		cout<<"Cannot open "<<percentiles_file<<endl;
+	percentiles_log<<"#name\tcount\tmin\tmean\tp50\tp90\tp99\tp99.9\tmax"<<endl;
+
+	string histograms_file = DIRNAME + string("/stats/histograms");
+	ofstream histograms_log;
+	histograms_log.open(histograms_file.c_str());
+	if(!histograms_log.is_open())
+		cout<<"Cannot open "<<histograms_file<<endl;
+	histograms_log<<"#name\tlow\thigh\tcount"<<endl;
+
+	histogram noc_hist[HIST_NUM_TYPES];
+	for(UI i = 0; i < num_rows; i++) {
+		for(UI j = 0; j < num_cols; j++) {
+			if (noc.nwtile[i][j] == NULL)
+				continue;
+
+			UI dst = i * num_cols + j;
+			char str_dst[4];
+			sprintf(str_dst, "%d", dst);
+			for(UI k = 0; k < HIST_NUM_TYPES; k++) {
+				histogram *h = (noc.nwtile[i][j])->return_histogram(k);
+				if (h == NULL)
+					continue;
+				noc_hist[k].merge(*h);
+				h->print(percentiles_log, string("tile-") + string(str_dst) + string(".") + hist_names[k]);
+			}
+			for(UI src = 0; src < num_tiles; src++) {
+				histogram *h = (noc.nwtile[i][j])->return_flow_histogram(src);
+				if (h == NULL)
+					continue;
+				char str_src[4];
+				sprintf(str_src, "%d", src);
+				h->print(percentiles_log, string("flow-") + string(str_src) + string("-") + string(str_dst) + string(".latency_pkt"));
+			}
+		}
+	}
+	for(UI k = 0; k < HIST_NUM_TYPES; k++) {
+		noc_hist[k].print(percentiles_log, string("noc.") + hist_names[k]);
+		noc_hist[k].dump(histograms_log, string("noc.") + hist_names[k]);
+	}
+	percentiles_log.close();
+	histograms_log.close();
+
+	results_log<<"\nNoC distributions              count     p50       p90       p99       p99.9     max"<<endl;
+	for(UI k = 0; k < HIST_NUM_TYPES; k++) {
+		results_log<<"  "<<setw(28)<<left<<hist_names[k]<<" "<<setw(9)<<noc_hist[k].count<<" "<<setw(9)<<noc_hist[k].percentile(50)
+		           <<" "<<setw(9)<<noc_hist[k].percentile(90)<<" "<<setw(9)<<noc_hist[k].percentile(99)
+		           <<" "<<setw(9)<<noc_hist[k].percentile(99.9)<<" "<<noc_hist[k].max<<right<<endl;
+	}
+	results_log<<"(latencies in clock cycles, percentiles are bucket upper bounds with <= 1/8 relative error; see stats/percentiles)"<<endl;
+
+	// source-destination flow matrix and fairness
+	string flows_file = DIRNAME + string("/stats/flows.csv");
+	ofstream flows_log;
+	flows_log.open(flows_file.c_str());
+	if(!flows_log.is_open())
+		cout<<"Cannot open "<<flows_file<<endl;
+	flows_log<<"src,dst,packets,flits,avg_latency,wc_latency,avg_hops"<<endl;
+
+	double src_recv_flits[MAX_NUM_TILES];
+	double src_total_latency[MAX_NUM_TILES];
+	ULL    src_recv_packets[MAX_NUM_TILES];
+	for(UI k = 0; k < MAX_NUM_TILES; k++) {
+		src_recv_flits[k] = 0.0;
+		src_total_latency[k] = 0.0;
+		src_recv_packets[k] = 0;
+	}
+	double flow_sum = 0.0;
+	double flow_sum_sq = 0.0;
+	ULL    flow_count = 0;
+	for(UI i = 0; i < num_rows; i++) {
+		for(UI j = 0; j < num_cols; j++) {
+			if (noc.nwtile[i][j] == NULL)
+				continue;
+			flow_table *flows = (noc.nwtile[i][j])->return_flows();
+			if (flows == NULL)
+				continue;
+			UI dst = i * num_cols + j;
+			for(flow_table::iterator it = flows->begin(); it != flows->end(); it++) {
+				flows_log<<it->first<<","<<dst<<","<<it->second.packets<<","<<it->second.flits<<","<<it->second.avg_latency()
+				         <<","<<it->second.wc_latency<<","<<it->second.avg_hops()<<endl;
+				if (it->first < MAX_NUM_TILES) {
+					src_recv_flits[it->first] += it->second.flits;
+					src_total_latency[it->first] += it->second.total_latency;
+					src_recv_packets[it->first] += it->second.packets;
+				}
+				flow_sum += it->second.flits;
+				flow_sum_sq += (double)it->second.flits * it->second.flits;
+				flow_count++;
+			}
+		}
+	}
+	flows_log.close();
+
+	// accepted throughput per source (flits per cycle), only sources which generated traffic are counted
+	string sources_file = DIRNAME + string("/stats/sources.csv");
+	ofstream sources_log;
+	sources_log.open(sources_file.c_str());
+	if(!sources_log.is_open())
+		cout<<"Cannot open "<<sources_file<<endl;
+	sources_log<<"src,sent_flits,recv_flits,accepted_rate,avg_latency"<<endl;
+	double src_sum = 0.0;
+	double src_sum_sq = 0.0;
+	ULL    src_count = 0;
+	for(UI src = 0; src < num_tiles; src++) {
+		BaseNWTile *tile = noc.nwtile[src / num_cols][src % num_cols];
+		ULL sent = (tile == NULL) ? 0 : tile->return_send_flits_number();
+		if (sent == 0 && src_recv_flits[src] == 0.0)
+			continue;
+		double rate = (noc.sim_count == 0) ? 0.0 : src_recv_flits[src] / noc.sim_count;
+		double lat = (src_recv_packets[src] == 0) ? 0.0 : src_total_latency[src] / src_recv_packets[src];
+		sources_log<<src<<","<<sent<<","<<src_recv_flits[src]<<","<<rate<<","<<lat<<endl;
+		src_sum += rate;
+		src_sum_sq += rate * rate;
+		src_count++;
+	}
+	sources_log.close();
+
+	// Jain's fairness index: (sum x)^2 / (n * sum x^2), 1 means perfectly fair
+	double jain_src  = (src_sum_sq == 0.0) ? 1.0 : (src_sum * src_sum) / (src_count * src_sum_sq);
+	double jain_flow = (flow_sum_sq == 0.0) ? 1.0 : (flow_sum * flow_sum) / (flow_count * flow_sum_sq);
+	results_log<<"\nActive flows (src,dst)                                         = "<<flow_count<<endl;
+	results_log<<"Jain's fairness index of accepted throughput per source        = "<<jain_src<<endl;
+	results_log<<"Jain's fairness index of accepted throughput per flow          = "<<jain_flow<<endl;
+	results_log<<"(flow matrix in stats/flows.csv, per source rates in stats/sources.csv)"<<endl;
+
+	// burstiness of generated traffic per source
+	string burst_file = DIRNAME + string("/stats/burstiness.csv");
+	ofstream burst_log;
+	burst_log.open(burst_file.c_str());
+	if(!burst_log.is_open())
+		cout<<"Cannot open "<<burst_file<<endl;
+	burst_log<<"src,flits,rate,idc_1,top_block,idc_top,hurst"<<endl;
+	double hurst_sum = 0.0;
+	UI     hurst_count = 0;
+	double idc_top_max = 0.0;
+	for(UI src = 0; src < num_tiles; src++) {
+		BaseNWTile *tile = noc.nwtile[src / num_cols][src % num_cols];
+		burst_meter *b = (tile == NULL) ? NULL : tile->return_burstiness();
+		if (b == NULL)
+			continue;
+		b->finish(noc.sim_count);	// generation may still be running
+		if (b->flits == 0)
+			continue;
+		int top = b->top_level();
+		double idc_top = (top < 0) ? 0.0 : b->idc(top);
+		double h = b->hurst();
+		burst_log<<src<<","<<b->flits<<","<<b->mean_rate()<<","<<b->idc(0)<<","<<((top < 0) ? 0ULL : (1ULL << top))
+		         <<","<<idc_top<<","<<h<<endl;
+		if (h > 0.0) {
+			hurst_sum += h;
+			hurst_count++;
+		}
+		if (idc_top > idc_top_max)
+			idc_top_max = idc_top;
+	}
+	burst_log.close();
+	if (hurst_count > 0) {
+		results_log<<"\nAverage Hurst parameter of generated traffic (variance-time)  = "<<hurst_sum / hurst_count<<endl;
+		results_log<<"Largest index of dispersion of generated flits (longest block) = "<<idc_top_max<<endl;
+		results_log<<"(per source burstiness in stats/burstiness.csv)"<<endl;
+	}
+
+	// windowed time series and steady-state estimation
+	if (STATS_WINDOW > 0) {
+		string timeseries_file = DIRNAME + string("/stats/timeseries");
+		ofstream timeseries_log;
+		timeseries_log.open(timeseries_file.c_str());
+		if(!timeseries_log.is_open())
+			cout<<"Cannot open "<<timeseries_file<<endl;
+		timeseries_log<<"#cycle\tflits\tthroughput\tlatency\tbuf_occupancy\toffered\tsource_lag"<<endl;
+		for(UI k = 0; k < noc.ts_cycle.size(); k++)
+			timeseries_log<<noc.ts_cycle[k]<<"\t"<<noc.ts_flits[k]<<"\t"<<noc.ts_tput[k]<<"\t"<<noc.ts_latency[k]<<"\t"<<noc.ts_bufocc[k]
+			              <<"\t"<<noc.ts_offered[k]<<"\t"<<noc.ts_lag[k]<<endl;
+		timeseries_log.close();
+
+		if (!noc.ci_reached)
+			noc.steady_state_reached();	// estimate for report, even if run was not stopped by it
+		results_log<<"\nStatistics window (in clock cycles)                            = "<<STATS_WINDOW<<" , windows = "<<noc.ts_cycle.size()<<endl;
+		if (noc.ci_mean > 0.0) {
+			results_log<<"Warmup detected by MSER (in clock cycles)                      = "<<noc.warmup_windows * STATS_WINDOW<<endl;
+			results_log<<"Steady-state average NoC latency (in clock cycles per flit)    = "<<noc.ci_mean<<" +- "<<noc.ci_halfwidth
+			           <<" (95% CI, "<<CI_BATCHES<<" batches)"<<endl;
+		}
+		else
+			results_log<<"Steady-state average NoC latency                               : not enough windows to estimate"<<endl;
+		if (AUTO_STOP)
+			results_log<<"Automatic stop (CI_TOLERANCE = "<<CI_TOLERANCE<<")                           : "
+			           <<(noc.ci_reached ? "tolerance met" : "tolerance NOT met")<<endl;
+
+		// transient response to each phase of traffic scenario
+		if (!scenario.empty()) {
+			vector<phase_report> reports;
+			scenario.analyse(noc.ts_cycle, noc.ts_flits, noc.ts_latency, noc.sim_count, RECOVERY_TOLERANCE, reports);
+			string phases_file = DIRNAME + string("/stats/phases.csv");
+			ofstream phases_log;
+			phases_log.open(phases_file.c_str());
+			if(!phases_log.is_open())
+				cout<<"Cannot open "<<phases_file<<endl;
+			phases_log<<"phase,start,end,windows,steady_latency,peak_latency,recovered,recovery_cycles"<<endl;
+			results_log<<"\nScenario phases (RECOVERY_TOLERANCE = "<<RECOVERY_TOLERANCE<<")"<<endl;
+			results_log<<"  phase  start       end         steady lat  peak lat    recovery"<<endl;
+			for(UI k = 0; k < reports.size(); k++) {
+				phase_report &r = reports[k];
+				phases_log<<k<<","<<r.start<<","<<r.end<<","<<r.windows<<","<<r.steady_latency<<","<<r.peak_latency
+				          <<","<<(r.recovered ? 1 : 0)<<","<<r.recovery<<endl;
+				results_log<<"  "<<setw(5)<<left<<k<<"  "<<setw(10)<<r.start<<"  "<<setw(10)<<r.end<<"  "<<setw(10)<<r.steady_latency
+				           <<"  "<<setw(10)<<r.peak_latency<<"  "<<right;
+				if (r.windows < 4)
+					results_log<<"too few windows"<<endl;
+				else if (r.recovered)
+					results_log<<r.recovery<<" cycles"<<endl;
+				else
+					results_log<<"not recovered"<<endl;
+			}
+			phases_log.close();
+		}
+	}
+	else if (!scenario.empty())
+		results_log<<"\nScenario phase recovery times need STATS_WINDOW > 0"<<endl;
+
     results_log<<"\nAverage buffers utilization      (in percent) = "<<noc_bufs_util
                <<" and virtual channels utilization (in percent)   = "<<noc_vcs_util<<endl; 
 	results_log<<"\nEfficienty of NoC buffers policy (in percent) = "<<(double)(100 - ((noc_avg_num_waits / noc_latency_core) * 100))
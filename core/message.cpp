@@ -0,0 +1,91 @@
+/*
+ * message.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file message.cpp
+/// \brief Implements message delivery table and statistics
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <iomanip>
+#include "message.h"
+
+message_table msg_table;
+
+////////////////////////////////////////////////////////
+/// Method to register sent message
+/// \param src source tile
+/// \param id message id at source
+/// \param cls message class
+/// \param bytes message size (in bytes)
+/// \param pkts number of packets
+////////////////////////////////////////////////////////
+void message_table::send(UI src, UI id, UI cls, UI bytes, UI pkts) {
+	in_flight[msg_key(src, id)] = cls;
+	msg_class_stats &s = classes[cls];
+	s.sent++;
+	s.bytes += bytes;
+	s.pkts += pkts;
+}
+
+////////////////////////////////////////////////////////
+/// Method to count message reassembled at destination
+/// \param msg reassembled message
+/// \param measured message was issued inside measurement window
+////////////////////////////////////////////////////////
+void message_table::deliver(const message &msg, bool measured) {
+	in_flight.erase(msg_key(msg.src, msg.id));
+	msg_class_stats &s = classes[msg.cls];
+	s.delivered++;
+	if(measured)
+		s.latency.record(msg.arrival - msg.issue);
+}
+
+////////////////////////////////////////////////////////
+/// Method to check if message is in flight
+/// \param src source tile
+/// \param id message id at source
+/// \return true if message was sent and not delivered yet
+////////////////////////////////////////////////////////
+bool message_table::pending(UI src, UI id) const {
+	return in_flight.find(msg_key(src, id)) != in_flight.end();
+}
+
+////////////////////////////////////////////////////////
+/// Method to write message statistics
+/// \param out output stream
+////////////////////////////////////////////////////////
+void message_table::print(ofstream &out) const {
+	if(classes.empty())
+		return;
+
+	out<<"\nMessages (send_message, latency from send to arrival of last packet)"<<endl;
+	out<<"  class       sent        delivered   avg bytes   avg pkts    avg lat     p99 lat     max lat"<<endl;
+	for(map<UI, msg_class_stats>::const_iterator it = classes.begin(); it != classes.end(); it++) {
+		const msg_class_stats &s = it->second;
+		double avg_bytes = (s.sent > 0) ? (double)s.bytes / s.sent : 0.0;
+		double avg_pkts = (s.sent > 0) ? (double)s.pkts / s.sent : 0.0;
+		out<<"  "<<setw(10)<<left<<it->first<<"  "<<setw(10)<<s.sent<<"  "<<setw(10)<<s.delivered<<"  "<<setw(10)<<avg_bytes
+		   <<"  "<<setw(10)<<avg_pkts<<"  "<<setw(10)<<s.latency.mean()<<"  "<<setw(10)<<s.latency.percentile(99)
+		   <<"  "<<s.latency.max<<right<<endl;
+	}
+	if(!in_flight.empty())
+		out<<"Messages not delivered at end of simulation                    = "<<in_flight.size()<<endl;
+}
@@ -0,0 +1,110 @@
+/*
+ * message.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file message.h
+/// \brief Defines messages of send_message API and their delivery table and statistics
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _MESSAGE_
+#define _MESSAGE_
+
+#include <fstream>
+#include <map>
+#include "../config/constants.h"
+#include "histogram.h"
+
+using namespace std;
+
+/// default size of largest packet of a message (in flits)
+#define MSG_PACKET_FLITS 8
+/// handle returned for message that could not be sent
+#define MSG_NO_HANDLE 0xFFFFFFFF
+
+/// status of a message at its source, returned for its handle
+enum msg_status {
+	MSG_UNKNOWN,	///< handle was never returned by send_message
+	MSG_QUEUED,		///< flits of message wait in source injection queue
+	MSG_SENT,		///< all flits injected, message not reassembled at destination yet
+	MSG_DELIVERED	///< all packets arrived at destination core
+};
+
+/////////////////////////////////////////
+/// \brief message reassembled at destination
+/////////////////////////////////////////
+struct message {
+	UI  src;	    ///< source tile
+	UI  dst;	    ///< destination tile
+	UI  id;	        ///< message id at source (handle returned by send_message)
+	UI  cls;	    ///< message class
+	UI  bytes;	    ///< message size (in bytes)
+	UI  pkts;	    ///< number of packets message was split into
+	ULL issue;	    ///< cycle send_message was called
+	ULL arrival;	///< cycle last packet arrived
+};
+
+/////////////////////////////////////////
+/// \brief statistics of one message class
+/////////////////////////////////////////
+struct msg_class_stats {
+	ULL sent;	        ///< messages sent
+	ULL delivered;	    ///< messages reassembled at destination
+	ULL bytes;	        ///< bytes of sent messages
+	ULL pkts;	        ///< packets of sent messages
+	histogram latency;	///< message latency (measured messages only)
+
+	/// statistics constructor
+	msg_class_stats() {
+		sent = delivered = bytes = pkts = 0;
+	};
+};
+
+//////////////////////////////////////////////////////////////////////////
+/// \brief Messages in flight and statistics shared by network interfaces
+///
+/// Destination reassembles a message from the message headers of its packets
+/// alone. The table only tells a source which of its messages were delivered
+/// (a completion notification without modelled acknowledgement traffic) and
+/// collects latency per class.
+//////////////////////////////////////////////////////////////////////////
+struct message_table {
+	map<ULL, UI> in_flight;	                ///< class of messages not delivered yet, key is msg_key
+	map<UI, msg_class_stats> classes;	    ///< statistics per message class
+
+	// FUNCTIONS /////////////////////////////////////////////////////////////////////////////
+	/// registers message sent by a source
+	void send(UI src, UI id, UI cls, UI bytes, UI pkts);
+	/// counts reassembled message, latency is recorded if measured
+	void deliver(const message &msg, bool measured);
+	/// returns true if message was sent and not delivered yet
+	bool pending(UI src, UI id) const;
+	void print(ofstream &out) const;	///< write message statistics (nothing if unused)
+	// FUNCTIONS END /////////////////////////////////////////////////////////////////////////
+};
+
+/// returns key of message
+inline ULL msg_key(UI src, UI id) {
+	return ((ULL)src << 32) | id;
+}
+
+extern message_table msg_table;	///< messages shared by all tiles
+
+#endif
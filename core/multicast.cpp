@@ -0,0 +1,484 @@
+/*
+ * multicast.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file multicast.cpp
+/// \brief Implements multicast groups, tree/path replication and reduction rules and their statistics
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <iomanip>
+#include <stdlib.h>
+#include "systemc.h"
+#include "multicast.h"
+#include "../config/extern.h"
+
+multicast_table multicast;
+
+/// names of delivery modes in results (dual-path operations are counted as PATH)
+static const char *mcast_mode_name[MCAST_NUM_MODES] = {"NONE", "TREE", "PATH", "PATH", "UNICAST", "REDUCE", "REDUCE_END"};
+
+/// both worms of a dual-path operation are counted in statistics of MCAST_PATH_UP
+static UI stats_mode(UI mode) {
+	if(mode == MCAST_PATH_DOWN)
+		return MCAST_PATH_UP;
+	return (mode < MCAST_NUM_MODES) ? (UI)mode : (UI)MCAST_NONE;
+}
+
+////////////////////////////////////////////////////////
+/// Function to convert mode name to mode
+/// \param name NONE, TREE, PATH (dual-path), UNICAST, REDUCE or REDUCE_END
+/// \param mode result
+/// \return false if name is unknown (mode is not changed)
+////////////////////////////////////////////////////////
+bool parse_mcast_mode(const string &name, UI &mode) {
+	if(name == "NONE") mode = MCAST_NONE;
+	else if(name == "TREE") mode = MCAST_TREE;
+	else if(name == "PATH") mode = MCAST_PATH_UP;
+	else if(name == "UNICAST") mode = MCAST_UNICAST;
+	else if(name == "REDUCE") mode = MCAST_REDUCE;
+	else if(name == "REDUCE_END") mode = MCAST_REDUCE_END;
+	else return false;
+	return true;
+}
+
+////////////////////////////////////////////////////////
+/// Method to find or create group
+/// \param dsts destination tiles
+/// \return group id
+////////////////////////////////////////////////////////
+UI multicast_table::add_group(const tile_set &dsts) {
+	for(UI g = 0; g < groups.size(); g++)
+		if(groups[g] == dsts)
+			return g;
+	groups.push_back(dsts);
+	return groups.size() - 1;
+}
+
+////////////////////////////////////////////////////////
+/// Method to build destination set of rectangular region
+/// \param row0 first row
+/// \param col0 first column
+/// \param row1 last row
+/// \param col1 last column
+/// \return tiles inside region (clipped to topology)
+////////////////////////////////////////////////////////
+tile_set multicast_table::region(UI row0, UI col0, UI row1, UI col1) const {
+	tile_set dsts;
+	for(UI r = min(row0, row1); r <= max(row0, row1) && r < num_rows; r++)
+		for(UI c = min(col0, col1); c <= max(col0, col1) && c < num_cols; c++)
+			dsts.set(r * num_cols + c);
+	return dsts;
+}
+
+////////////////////////////////////////////////////////
+/// Method to compute snake label, rows are walked alternately left to right and right to left
+/// \param tile tile ID
+/// \return position of tile on Hamiltonian path
+////////////////////////////////////////////////////////
+UI multicast_table::label(UI tile) {
+	UI r = tile / num_cols;
+	UI c = tile % num_cols;
+	return (r % 2 == 0) ? r * num_cols + c : r * num_cols + num_cols - 1 - c;
+}
+
+////////////////////////////////////////////////////////
+/// Method to compute length of XY route
+/// \param from source tile
+/// \param to destination tile
+/// \return number of router to router links
+////////////////////////////////////////////////////////
+UI multicast_table::hops(UI from, UI to) {
+	int dr = (int)(from / num_cols) - (int)(to / num_cols);
+	int dc = (int)(from % num_cols) - (int)(to % num_cols);
+	return abs(dr) + abs(dc);
+}
+
+/// XY direction from tile towards different destination
+static UI xy_dir(UI tile, UI dst) {
+	UI r = tile / num_cols, c = tile % num_cols;
+	UI dr = dst / num_cols, dc = dst % num_cols;
+	if(dc > c)
+		return E;
+	if(dc < c)
+		return W;
+	return (dr > r) ? S : N;
+}
+
+////////////////////////////////////////////////////////
+/// Function to find label-monotone direction of a worm (dual-path routing)
+/// \param tile current tile
+/// \param dst next destination of worm
+/// \param up worm visits increasing labels
+/// \return direction of neighbour with highest label not above that of dst
+/// (up), lowest label not below that of dst (down)
+///
+/// Up worms use only channels to higher labels, down worms only channels to
+/// lower labels, so the two subnetworks are acyclic. The snake neighbour of
+/// tile always qualifies, the chosen one gives a minimal route in a mesh.
+////////////////////////////////////////////////////////
+static UI snake_dir(UI tile, UI dst, bool up) {
+	UI r = tile / num_cols, c = tile % num_cols;
+	UI lab = multicast_table::label(tile);
+	UI dst_lab = multicast_table::label(dst);
+	UI best_dir = C;
+	UI best_lab = lab;
+	UI nbr[4] = {N, S, E, W};
+	for(UI k = 0; k < 4; k++) {
+		UI d = nbr[k];
+		if((d == N && r == 0) || (d == S && r + 1 >= num_rows) || (d == W && c == 0) || (d == E && c + 1 >= num_cols))
+			continue;
+		UI next = (d == E) ? tile + 1 : (d == W) ? tile - 1 : (d == S) ? tile + num_cols : tile - num_cols;
+		UI l = multicast_table::label(next);
+		bool ok = up ? (l > lab && l <= dst_lab) : (l < lab && l >= dst_lab);
+		if(ok && (best_dir == C || (up ? (l > best_lab) : (l < best_lab)))) {
+			best_dir = d;
+			best_lab = l;
+		}
+	}
+	return best_dir;
+}
+
+/// true if v lies between a and b (inclusive)
+static bool between(UI v, UI a, UI b) {
+	return (a <= b) ? (a <= v && v <= b) : (b <= v && v <= a);
+}
+
+////////////////////////////////////////////////////////
+/// Method to find next destination of a worm
+/// \param group group id
+/// \param tile current tile
+/// \param up worm visits increasing labels
+/// \return destination with nearest label after tile, MCAST_NO_TARGET if none
+////////////////////////////////////////////////////////
+UI multicast_table::path_next(UI group, UI tile, bool up) const {
+	if(group >= groups.size())
+		return MCAST_NO_TARGET;
+	const tile_set &dsts = groups[group];
+	UI lab = label(tile);
+	UI best = MCAST_NO_TARGET;
+	UI best_lab = 0;
+	for(UI d = 0; d < num_tiles; d++) {
+		if(!dsts.test(d))
+			continue;
+		UI l = label(d);
+		if(up ? (l <= lab) : (l >= lab))
+			continue;
+		if(best == MCAST_NO_TARGET || (up ? (l < best_lab) : (l > best_lab))) {
+			best = d;
+			best_lab = l;
+		}
+	}
+	return best;
+}
+
+////////////////////////////////////////////////////////
+/// Method to compute branches of XY tree at a tile
+/// \param group group id
+/// \param src source tile
+/// \param tile current tile
+/// \return bit (1 << dir) set for each output direction, C if tile is destination
+///
+/// A tile lies on XY route from src to d if it is in row of src between both
+/// columns, or in column of d between both rows.
+////////////////////////////////////////////////////////
+UI multicast_table::tree_dirs(UI group, UI src, UI tile) const {
+	if(group >= groups.size())
+		return 0;
+	const tile_set &dsts = groups[group];
+	UI r = tile / num_cols, c = tile % num_cols;
+	UI sr = src / num_cols, sc = src % num_cols;
+	UI dirs = 0;
+	for(UI d = 0; d < num_tiles; d++) {
+		if(!dsts.test(d))
+			continue;
+		if(d == tile) {
+			dirs |= 1 << C;
+			continue;
+		}
+		UI dr = d / num_cols, dc = d % num_cols;
+		bool on_row = (r == sr) && between(c, sc, dc);
+		bool on_col = (c == dc) && between(r, sr, dr);
+		if(on_row || on_col)
+			dirs |= 1 << xy_dir(tile, d);
+	}
+	return dirs;
+}
+
+////////////////////////////////////////////////////////
+/// Method to compute branches of a worm at a tile
+/// \param group group id
+/// \param tile current tile
+/// \param up worm visits increasing labels
+/// \param target current destination of worm, replaced by next one if reached
+/// \return bit (1 << dir) set for each output direction, C if tile is destination
+///
+/// Between destinations worm follows label-monotone routes, tiles it passes
+/// have labels between those of two consecutive destinations, so none of
+/// them is a destination.
+////////////////////////////////////////////////////////
+UI multicast_table::path_dirs(UI group, UI tile, bool up, UI &target) const {
+	UI dirs = 0;
+	if(target == tile) {
+		dirs |= 1 << C;
+		target = path_next(group, tile, up);
+	}
+	if(target != MCAST_NO_TARGET)
+		dirs |= 1 << snake_dir(tile, target, up);
+	return dirs;
+}
+
+////////////////////////////////////////////////////////
+/// Method to compute direction of reduction packet
+/// \param tile current tile
+/// \param root root of reduction
+/// \return bit (1 << dir) of XY direction towards root, C at root
+////////////////////////////////////////////////////////
+UI multicast_table::reduce_dirs(UI tile, UI root) const {
+	return 1 << ((tile == root) ? C : xy_dir(tile, root));
+}
+
+////////////////////////////////////////////////////////
+/// Method to compute reduction tree of group
+/// \param group members (root is not a member)
+/// \param root root of reduction
+/// \return number of packets each tile waits for before forwarding
+///
+/// XY routes of all members to root form a tree, a tile gets one (combined)
+/// packet from each neighbour whose subtree holds members, plus one from
+/// its own core if it is a member
+////////////////////////////////////////////////////////
+const vector<UI>& multicast_table::reduce_expected(UI group, UI root) {
+	ULL key = ((ULL)group << 8) | root;
+	map<ULL, vector<UI> >::iterator it = reduce_expect.find(key);
+	if(it != reduce_expect.end())
+		return it->second;
+	
+	vector<UI> &expect = reduce_expect[key];
+	expect.assign(num_tiles, 0);
+	vector<bool> on_tree(num_tiles, false);
+	const tile_set &members = groups[group];
+	for(UI m = 0; m < num_tiles; m++) {
+		if(!members.test(m) || m == root)
+			continue;
+		expect[m]++;	// own contribution
+		for(UI t = m; t != root; ) {	// walk to root, each tree edge counted once
+			UI d = xy_dir(t, root);
+			UI next = (d == E) ? t + 1 : (d == W) ? t - 1 : (d == S) ? t + num_cols : t - num_cols;
+			if(on_tree[t])
+				break;
+			on_tree[t] = true;
+			expect[next]++;
+			t = next;
+		}
+	}
+	return expect;
+}
+
+////////////////////////////////////////////////////////
+/// Method to count arrival of reduction packet at router
+/// \param rid reduction id
+/// \param group members of reduction
+/// \param root root of reduction
+/// \param tile tile of router
+/// \return REDUCE_ABSORB if more packets are expected, otherwise packet is forwarded
+///
+/// Count of a tile is dropped when its combined packet is forwarded.
+////////////////////////////////////////////////////////
+reduce_action multicast_table::reduce_arrive(UI rid, UI group, UI root, UI tile) {
+	UI expect = reduce_expected(group, root)[tile];
+	if(expect <= 1)
+		return REDUCE_PASS;
+	pair<ULL, UI> key(reduce_key(rid, group, root), tile);
+	UI seen = ++reduce_seen[key];
+	if(seen < expect) {
+		stats[MCAST_REDUCE].combines++;
+		return REDUCE_ABSORB;
+	}
+	reduce_seen.erase(key);
+	return REDUCE_COMBINED;
+}
+
+////////////////////////////////////////////////////////
+/// Method to register contribution to reduction
+/// \param src contributing tile
+/// \param group members of reduction
+/// \param root root of reduction
+/// \param rid reduction id, same at all members
+/// \param num_flits flits per packet
+/// \param mode MCAST_REDUCE or MCAST_REDUCE_END
+/// \param cycle generation cycle
+////////////////////////////////////////////////////////
+void multicast_table::start_reduction(UI src, UI group, UI root, UI rid, UI num_flits, UI mode, ULL cycle) {
+	ULL key = reduce_key(rid, group, root);
+	map<ULL, mcast_op>::iterator it = pending.find(key);
+	mcast_stats &s = stats[stats_mode(mode)];
+	if(it == pending.end()) {
+		mcast_op op;
+		op.start = cycle;
+		op.mode = stats_mode(mode);
+		op.remaining = (mode == MCAST_REDUCE) ? 1 : groups[group].count();
+		op.combine = REDUCE_COMBINE_CYCLES;
+		op.ready = 0;
+		pending[key] = op;
+		s.ops++;
+	}
+	else if(cycle < it->second.start)
+		it->second.start = cycle;
+	UI flits = (num_flits < 1) ? 1 : num_flits;
+	s.destinations++;
+	s.unicast_flits += flits;
+	s.unicast_link_flits += (ULL)flits * hops(src, root);
+}
+
+////////////////////////////////////////////////////////
+/// Method to register multicast operation
+/// \param src source tile
+/// \param group group id
+/// \param num_flits flits per packet
+/// \param mode delivery mode
+/// \param cycle generation cycle
+/// \return sequence number of operation at source
+////////////////////////////////////////////////////////
+UI multicast_table::start(UI src, UI group, UI num_flits, UI mode, ULL cycle) {
+	UI seq = next_seq[src]++;
+	const tile_set &dsts = groups[group];
+	mcast_op op;
+	op.start = cycle;
+	op.mode = stats_mode(mode);
+	op.remaining = dsts.count();
+	op.combine = 0;
+	op.ready = 0;
+	pending[mcast_key(src, seq)] = op;
+
+	mcast_stats &s = stats[op.mode];
+	UI flits = (num_flits < 1) ? 1 : num_flits;
+	s.ops++;
+	s.destinations += op.remaining;
+	s.unicast_flits += (ULL)flits * op.remaining;
+	for(UI d = 0; d < num_tiles; d++)
+		if(dsts.test(d))
+			s.unicast_link_flits += (ULL)flits * hops(src, d);
+	return seq;
+}
+
+////////////////////////////////////////////////////////
+/// Method to count flits injected for a multicast operation
+/// \param mode delivery mode
+/// \param num_flits number of injected flits
+////////////////////////////////////////////////////////
+void multicast_table::add_injected(UI mode, UI num_flits) {
+	stats[stats_mode(mode)].injected_flits += num_flits;
+}
+
+////////////////////////////////////////////////////////
+/// Method to count flit of multicast operation leaving router towards neighbour
+/// \param mode delivery mode
+////////////////////////////////////////////////////////
+void multicast_table::add_link_flit(UI mode) {
+	stats[stats_mode(mode)].link_flits++;
+}
+
+////////////////////////////////////////////////////////
+/// Method to count flit consumed by router when its packet was combined
+/// \param mode delivery mode
+////////////////////////////////////////////////////////
+void multicast_table::add_absorbed_flit(UI mode) {
+	stats[stats_mode(mode)].absorbed_flits++;
+	absorbed_flits++;
+}
+
+////////////////////////////////////////////////////////
+/// Method to count delivery of packet to one destination
+/// \param key operation key
+/// \param cycle arrival cycle of tail flit
+///
+/// Destination combines delivered packets one after another (combine cycles
+/// of operation each), operation completes when the last one is combined
+////////////////////////////////////////////////////////
+void multicast_table::deliver(ULL key, ULL cycle) {
+	map<ULL, mcast_op>::iterator it = pending.find(key);
+	if(it == pending.end())
+		return;
+	mcast_op &op = it->second;
+	mcast_stats &s = stats[op.mode];
+	ULL latency = (cycle > op.start) ? cycle - op.start : 0;
+	s.deliveries++;
+	s.delivery.record(latency);
+	op.ready = ((cycle > op.ready) ? cycle : op.ready) + op.combine;
+	if(op.remaining > 0)
+		op.remaining--;
+	if(op.remaining == 0) {
+		s.completed++;
+		s.completion.record((op.ready > op.start) ? op.ready - op.start : 0);
+		pending.erase(it);
+	}
+}
+
+////////////////////////////////////////////////////////
+/// Method to write statistics of multicast operations and reductions
+/// \param out output stream
+///
+/// Traffic of hardware modes is compared to the unicast emulation of the same
+/// operations (one packet per destination on XY route), in-network reduction
+/// to end-point reduction. Latency comparison needs operations of MCAST_UNICAST
+/// (MCAST_REDUCE_END) mode in the same or a separate run.
+////////////////////////////////////////////////////////
+void multicast_table::print(ofstream &out) const {
+	bool used = false;
+	for(UI m = MCAST_TREE; m < MCAST_NUM_MODES; m++)
+		if(stats[m].ops > 0)
+			used = true;
+	if(!used)
+		return;
+
+	out<<"\nMulticast operations and reductions (groups = "<<groups.size()<<", dests of reduction are its members)"<<endl;
+	out<<"  mode        ops         dests       completed   inj flits   link flits  avg lat     avg compl   p99 compl"<<endl;
+	for(UI m = MCAST_TREE; m < MCAST_NUM_MODES; m++) {
+		const mcast_stats &s = stats[m];
+		if(s.ops == 0)
+			continue;
+		out<<"  "<<setw(10)<<left<<mcast_mode_name[m]<<"  "<<setw(10)<<s.ops<<"  "<<setw(10)<<s.destinations<<"  "<<setw(10)<<s.completed
+		   <<"  "<<setw(10)<<s.injected_flits<<"  "<<setw(10)<<s.link_flits<<"  "<<setw(10)<<s.delivery.mean()
+		   <<"  "<<setw(10)<<s.completion.mean()<<"  "<<s.completion.percentile(99)<<right<<endl;
+	}
+	for(UI m = MCAST_TREE; m < MCAST_NUM_MODES; m++) {
+		const mcast_stats &s = stats[m];
+		if(s.ops == 0 || !mcast_in_network(m) || s.unicast_flits == 0)
+			continue;
+		bool reduce = (m == MCAST_REDUCE);
+		const char *base = reduce ? "end-point reduction" : "unicast emulation  ";
+		if(!reduce)
+			out<<mcast_mode_name[m]<<" injected flits relative to "<<base<<"    (in percent) = "
+			   <<100.0 * s.injected_flits / s.unicast_flits<<endl;
+		if(s.unicast_link_flits > 0)
+			out<<mcast_mode_name[m]<<" link traversals relative to "<<base<<"   (in percent) = "
+			   <<100.0 * s.link_flits / s.unicast_link_flits<<endl;
+		if(reduce)
+			out<<"REDUCE packets combined in routers                              = "<<s.combines
+			   <<" ("<<s.absorbed_flits<<" flits, combine latency "<<REDUCE_COMBINE_CYCLES<<" cycles)"<<endl;
+		const mcast_stats &u = stats[reduce ? MCAST_REDUCE_END : MCAST_UNICAST];
+		if(u.completed > 0 && s.completed > 0 && u.completion.mean() > 0.0)
+			out<<mcast_mode_name[m]<<" completion latency relative to "<<mcast_mode_name[reduce ? MCAST_REDUCE_END : MCAST_UNICAST]
+			   <<" mode    (in percent) = "<<100.0 * s.completion.mean() / u.completion.mean()<<endl;
+	}
+	if(!pending.empty())
+		out<<"Multicast operations not completed at end of simulation        = "<<pending.size()<<endl;
+}
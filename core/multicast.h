@@ -0,0 +1,207 @@
+/*
+ * multicast.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file multicast.h
+/// \brief Defines multicast groups, tree/path replication and reduction rules and their statistics
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _MULTICAST_
+#define _MULTICAST_
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <bitset>
+#include "../config/constants.h"
+#include "histogram.h"
+
+using namespace std;
+
+/// set of destination tiles of a multicast packet
+typedef bitset<MAX_NUM_TILES> tile_set;
+
+/// no next destination on path (end of worm)
+#define MCAST_NO_TARGET 0xFF
+
+/////////////////////////////////////////////////////////////////
+/// types of multicast delivery:
+/// - MCAST_NONE: ordinary unicast packet
+/// - MCAST_TREE: one packet, routers replicate it along XY tree
+/// - MCAST_PATH_UP, MCAST_PATH_DOWN: dual-path worms visiting destinations in
+///   increasing (decreasing) order of snake (Hamiltonian path) label
+/// - MCAST_UNICAST: one unicast packet per destination (emulation at source)
+/// - MCAST_REDUCE: packets of group members to root, routers on XY reduction
+///   tree combine packets of the same reduction id into one
+/// - MCAST_REDUCE_END: packets of group members to root, combined by root only
+/////////////////////////////////////////////////////////////////
+enum mcast_mode {
+	MCAST_NONE,
+	MCAST_TREE,
+	MCAST_PATH_UP,
+	MCAST_PATH_DOWN,
+	MCAST_UNICAST,
+	MCAST_REDUCE,
+	MCAST_REDUCE_END,
+	MCAST_NUM_MODES
+};
+
+/// result of arrival of reduction packet at a router
+enum reduce_action {
+	REDUCE_ABSORB,		///< packet is combined into one still expected, its flits are consumed
+	REDUCE_PASS,		///< only packet expected at router, forwarded unchanged
+	REDUCE_COMBINED		///< last expected packet, forwarded with combined data after combine latency
+};
+
+/// true if routers replicate (or combine) packet of given mode
+inline bool mcast_in_network(UI mode) {
+	return mode == MCAST_TREE || mode == MCAST_PATH_UP || mode == MCAST_PATH_DOWN || mode == MCAST_REDUCE;
+}
+
+/// true if packet of given mode is part of a reduction
+inline bool mcast_reduction(UI mode) {
+	return mode == MCAST_REDUCE || mode == MCAST_REDUCE_END;
+}
+
+/// returns mode for its name in config files: TREE, PATH, UNICAST, REDUCE, REDUCE_END (false if name is unknown)
+bool parse_mcast_mode(const string &name, UI &mode);
+
+/////////////////////////////////////////
+/// \brief multicast operation in flight
+/////////////////////////////////////////
+struct mcast_op {
+	ULL start;	        ///< generation cycle (first contribution of reduction)
+	UI  mode;	        ///< delivery mode
+	UI  remaining;	    ///< destinations (reduction: packets at root) not reached yet
+	ULL combine;	    ///< cycles destination needs to combine each packet
+	ULL ready;	        ///< cycle destination finishes combining delivered packets
+};
+
+/////////////////////////////////////////
+/// \brief statistics of one delivery mode
+/////////////////////////////////////////
+struct mcast_stats {
+	ULL ops;	            ///< started multicast operations
+	ULL destinations;	    ///< destinations of started operations (reduction: contributing members)
+	ULL deliveries;	        ///< packets delivered to destination cores
+	ULL completed;	        ///< operations that reached all destinations
+	ULL injected_flits;	    ///< flits injected by sources
+	ULL link_flits;	        ///< flits traversing router to router links
+	ULL unicast_flits;	    ///< flits a unicast emulation (end-point reduction) would inject
+	ULL unicast_link_flits;	///< link traversals of a unicast emulation (end-point reduction) with minimal routes
+	ULL combines;	        ///< packets combined into others by routers
+	ULL absorbed_flits;	    ///< flits consumed by routers when combining
+	histogram delivery;	    ///< latency from generation to tail arrival at each destination
+	histogram completion;	///< latency from generation to arrival at last destination (reduction: combined at root)
+
+	/// statistics constructor
+	mcast_stats() {
+		ops = destinations = deliveries = completed = 0;
+		injected_flits = link_flits = unicast_flits = unicast_link_flits = 0;
+		combines = absorbed_flits = 0;
+	};
+};
+
+//////////////////////////////////////////////////////////////////////////
+/// \brief Multicast groups and statistics shared by network interfaces and routers
+///
+/// Head flit of a multicast packet carries the id of its destination set in
+/// this table (like a multicast group address), so a packet of any fan-out
+/// fits the fixed flit header. Groups are created on first use and reused.
+///
+/// Replication rules are functions of the group, source and current tile:
+/// - tree: union of XY paths from source to every destination, a router
+///   forwards a copy to every direction used by at least one of them
+/// - path: a worm goes through destinations in snake label order over
+///   channels to increasing (decreasing) labels only, a router on a
+///   destination delivers a copy and retargets the worm
+/// - reduction: members send to root by XY routes, a router waits for one
+///   packet from each input whose subtree holds members (and from its own
+///   core if member) and forwards only the last of them
+//////////////////////////////////////////////////////////////////////////
+struct multicast_table {
+	vector<tile_set> groups;	            ///< destination sets, index is group id
+	map<ULL, mcast_op> pending;	            ///< operations in flight, key is mcast_key or reduce_key
+	map<ULL, vector<UI> > reduce_expect;	///< packets expected at each tile, key is (group, root)
+	map<pair<ULL, UI>, UI> reduce_seen;	    ///< packets arrived at combining tile, key is (reduce_key, tile)
+	ULL absorbed_flits;	                    ///< flits consumed by routers (never delivered, for drain detection)
+	ULL replicated_flits;	                ///< extra flit copies made by routers (delivered, never injected, for drain detection)
+	UI next_seq[MAX_NUM_TILES];	            ///< next sequence number of each source
+	mcast_stats stats[MCAST_NUM_MODES];	    ///< statistics per delivery mode
+
+	/// multicast table constructor
+	multicast_table() {
+		for(UI i = 0; i < MAX_NUM_TILES; i++)
+			next_seq[i] = 0;
+		absorbed_flits = 0;
+		replicated_flits = 0;
+	};
+
+	// FUNCTIONS /////////////////////////////////////////////////////////////////////////////
+	UI   add_group(const tile_set &dsts);	            ///< returns id of group with given destinations
+	/// returns set of tiles in rectangle (inclusive corners)
+	tile_set region(UI row0, UI col0, UI row1, UI col1) const;
+	static UI label(UI tile);	                    ///< returns snake (boustrophedon) label of tile
+	static UI hops(UI from, UI to);	                ///< returns number of links on XY route
+	/// returns next destination after tile on path in given direction (MCAST_NO_TARGET at end)
+	UI   path_next(UI group, UI tile, bool up) const;
+	/// returns directions (bit per direction) a tree packet is forwarded to at tile
+	UI   tree_dirs(UI group, UI src, UI tile) const;
+	/// returns directions (bit per direction) and next target of a worm at tile
+	UI   path_dirs(UI group, UI tile, bool up, UI &target) const;
+	/// returns direction (bit) of reduction packet at tile towards root
+	UI   reduce_dirs(UI tile, UI root) const;
+	/// returns number of packets of a reduction each tile waits for
+	const vector<UI>& reduce_expected(UI group, UI root);
+	/// counts arrival of reduction packet at tile and returns what router does with it
+	reduce_action reduce_arrive(UI rid, UI group, UI root, UI tile);
+
+	/// registers operation and returns its sequence number
+	UI   start(UI src, UI group, UI num_flits, UI mode, ULL cycle);
+	/// registers contribution of src to reduction (operation is created by first one)
+	void start_reduction(UI src, UI group, UI root, UI rid, UI num_flits, UI mode, ULL cycle);
+	void add_injected(UI mode, UI num_flits);	    ///< counts flits injected for an operation
+	void add_link_flit(UI mode);	                ///< counts flit crossing a router to router link
+	void add_absorbed_flit(UI mode);	            ///< counts flit consumed by router when combining
+	void deliver(ULL key, ULL cycle);	            ///< counts packet delivered to one destination
+	void print(ofstream &out) const;	            ///< write multicast statistics (nothing if unused)
+	// FUNCTIONS END /////////////////////////////////////////////////////////////////////////
+};
+
+/// returns key of multicast operation
+inline ULL mcast_key(UI src, UI seq) {
+	return ((ULL)src << 32) | seq;
+}
+
+/// returns key of reduction (top bit keeps it apart from multicast keys)
+inline ULL reduce_key(UI rid, UI group, UI root) {
+	return (1ULL << 63) | ((ULL)(rid & 0x7FFFFFFF) << 32) | ((ULL)(group & 0xFFFFFF) << 8) | (root & 0xFF);
+}
+
+/// returns key of operation a packet belongs to, from fields of its multicast header
+inline ULL mcast_op_key(UI src, UI mode, UI group, UI target, UI seq) {
+	return mcast_reduction(mode) ? reduce_key(seq, group, target) : mcast_key(src, seq);
+}
+
+extern multicast_table multicast;	///< multicast groups shared by all tiles
+
+#endif
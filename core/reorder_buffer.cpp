@@ -0,0 +1,95 @@
+/*
+ * reorder_buffer.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file reorder_buffer.cpp
+/// \brief Implements reorder buffer model of a receiving core
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reorder_buffer.h"
+
+////////////////////////////////////////////////////////
+/// Method to empty buffer and remove all samples
+////////////////////////////////////////////////////////
+void reorder_buffer::reset() {
+	for(UI i = 0; i < MAX_NUM_TILES; i++)
+		expect[i] = 0;
+	held.clear();
+	packets = 0;
+	ooo_packets = 0;
+	overflows = 0;
+	max_occupancy = 0;
+	total_delay = 0;
+}
+
+////////////////////////////////////////////////////////
+/// Method to count arrival of a packet
+/// \param src source tile
+/// \param seq sequence number of packet in its flow
+/// \param cycle arrival cycle
+/// \param measured packet belongs to measurement window
+/// \param depth histogram of reorder depth
+/// \param delay histogram of extra delivery latency
+/// \return number of packets delivered in order (0 if packet is held)
+////////////////////////////////////////////////////////
+UI reorder_buffer::arrive(UI src, UI seq, ULL cycle, bool measured, histogram &depth, histogram &delay) {
+	if(src >= MAX_NUM_TILES)
+		return 1;
+	packets++;
+	if(seq < expect[src])	// number already passed (wrapped), deliver
+		return 1;
+	
+	// ahead of predecessors: hold
+	if(seq > expect[src]) {
+		ooo_packets++;
+		if(size > 0 && held.size() >= size)
+			overflows++;
+		rob_entry &e = held[((ULL)src << 32) | seq];
+		e.arrival = cycle;
+		e.measured = measured;
+		if(held.size() > max_occupancy)
+			max_occupancy = held.size();
+		if(measured)
+			depth.record(seq - expect[src]);
+		return 0;
+	}
+	
+	// in order: deliver with held successors that are now in order
+	if(measured) {
+		depth.record(0);
+		delay.record(0);
+	}
+	UI released = 1;
+	expect[src]++;
+	while(!held.empty()) {
+		map<ULL, rob_entry>::iterator it = held.find(((ULL)src << 32) | expect[src]);
+		if(it == held.end())
+			break;
+		ULL wait = cycle - it->second.arrival;
+		total_delay += wait;
+		if(it->second.measured)
+			delay.record(wait);
+		held.erase(it);
+		expect[src]++;
+		released++;
+	}
+	return released;
+}
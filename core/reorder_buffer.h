@@ -0,0 +1,82 @@
+/*
+ * reorder_buffer.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file reorder_buffer.h
+/// \brief Defines reorder buffer model of a receiving core (in-order delivery of flows)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _REORDER_BUFFER_
+#define _REORDER_BUFFER_
+
+#include <map>
+#include "../config/constants.h"
+#include "histogram.h"
+
+using namespace std;
+
+/// sequence number of packets not tracked for reordering (multicast, source routed, foreign flits)
+#define FLOW_SEQ_NONE 0xFFFFFFFF
+
+/////////////////////////////////////////
+/// \brief packet held in reorder buffer
+/////////////////////////////////////////
+struct rob_entry {
+	ULL  arrival;	///< cycle packet arrived at core
+	bool measured;	///< packet belongs to measurement window
+};
+
+//////////////////////////////////////////////////////////////////////////
+/// \brief Reorder buffer of a receiving core
+///
+/// Sources number packets of each flow (src, dst) in injection order. A
+/// packet arriving ahead of the next expected number of its flow is held
+/// until all its predecessors arrived, then delivered with them. Buffer is
+/// shared by all flows of the core; a packet that finds it full is still
+/// held (the simulated network cannot drop it) but counted as overflow,
+/// which a real endpoint would have to resolve by retransmission.
+/// - depth: number of missing predecessors at arrival (0 - in order)
+/// - delay: cycles a packet waited for its predecessors (0 - in order)
+//////////////////////////////////////////////////////////////////////////
+struct reorder_buffer {
+	UI   size;	                    ///< capacity (in packets), 0 - unlimited
+	UI   expect[MAX_NUM_TILES];	    ///< next in-order sequence number of each source
+	map<ULL, rob_entry> held;	    ///< packets waiting for predecessors, key is (src, seq)
+	ULL  packets;	                ///< tracked packets arrived
+	ULL  ooo_packets;	            ///< packets arrived out of order
+	ULL  overflows;	                ///< out-of-order arrivals that found buffer full
+	ULL  max_occupancy;	            ///< largest number of held packets
+	ULL  total_delay;	            ///< sum of cycles packets waited for predecessors
+
+	/// reorder buffer constructor
+	reorder_buffer() {
+		size = 0;
+		reset();
+	};
+
+	// FUNCTIONS /////////////////////////////////////////////////////////////////////////////
+	void reset();	///< empty buffer and remove all samples
+	/// counts arrival of packet, records depth and delay of measured packets, returns number of packets delivered in order
+	UI   arrive(UI src, UI seq, ULL cycle, bool measured, histogram &depth, histogram &delay);
+	// FUNCTIONS END /////////////////////////////////////////////////////////////////////////
+};
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * route_table.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file route_table.cpp
+/// \brief Implements routing table precomputed from a deterministic routing algorithm
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "route_table.h"
+#include "../config/extern.h"
+
+////////////////////////////////////////////////////////
+/// Method to fill routing table
+/// \param rt routing algorithm of tile (must be deterministic)
+/// \param tile tile ID
+/// - source of request is passed as this tile, deterministic algorithm must not use it
+/// - directions out of N, S, E, W, C are not stored (algorithm is called for them)
+////////////////////////////////////////////////////////
+void route_table::build(router *rt, UI tile) {
+	next.assign(num_tiles * RT_TABLE_DIRS, RT_TABLE_NONE);
+	for(UI dst = 0; dst < num_tiles; dst++)
+		for(UI ip_dir = 0; ip_dir < RT_TABLE_DIRS; ip_dir++) {
+			routing_fault_info rfi;
+			rfi.fail = false;
+			rfi.last_back_adap = false;
+			rfi.last_back = false;
+			rfi.last_dir = ND;
+			rfi.history = 0;
+			UI op_dir = rt->calc_next(ip_dir, tile, dst, &rfi);
+			if(op_dir <= C)
+				next[dst * RT_TABLE_DIRS + ip_dir] = (unsigned char)op_dir;
+		}
+}
+
+////////////////////////////////////////////////////////
+/// Method to remove all entries of routing table
+////////////////////////////////////////////////////////
+void route_table::clear() {
+	next.clear();
+}
@@ -0,0 +1,66 @@
+/*
+ * route_table.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file route_table.h
+/// \brief Defines routing table precomputed from a deterministic routing algorithm
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ROUTE_TABLE_
+#define _ROUTE_TABLE_
+
+#include <vector>
+#include "router.h"
+#include "../config/constants.h"
+
+using namespace std;
+
+/// entry of routing table without next hop (routing algorithm is called)
+#define RT_TABLE_NONE 0xFF
+/// input directions kept per destination (N, S, E, W, C)
+#define RT_TABLE_DIRS 5
+
+//////////////////////////////////////////////////////////////////////////
+/// \brief Routing table of a tile
+///
+/// Holds next hop of every (destination, input direction) pair in one byte,
+/// filled at startup by calling calc_next of a routing plugin that declares
+/// itself deterministic (router::is_deterministic). Lookup replaces the
+/// virtual call and the coordinate arithmetic of the plugin for head flits.
+//////////////////////////////////////////////////////////////////////////
+struct route_table {
+	vector<unsigned char> next;	///< next hop, index is dst * RT_TABLE_DIRS + ip_dir
+
+	// FUNCTIONS /////////////////////////////////////////////////////////////////////////////
+	void build(router *rt, UI tile);	///< fill table from routing algorithm of given tile
+	void clear();	                    ///< remove all entries (routing algorithm is called again)
+	
+	/// returns next hop for destination and input direction, RT_TABLE_NONE if not in table
+	UI lookup(UI ip_dir, UI dst) const {
+		ULL index = (ULL)dst * RT_TABLE_DIRS + ip_dir;
+		if(ip_dir >= RT_TABLE_DIRS || index >= next.size())
+			return RT_TABLE_NONE;
+		return next[index];
+	}
+	// FUNCTIONS END /////////////////////////////////////////////////////////////////////////
+};
+
+#endif
@@ -26,6 +26,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "router.h"
+#include "multicast.h"
 #include "../config/extern.h"
 
 ///////////////////////
@@ -157,5 +158,35 @@ bool router::is_router_shutdown() {
     return (state.faultDir[N] && state.faultDir[W] && state.faultDir[S] && state.faultDir[E]);
 }
 
+////////////////////////////////////////////////////
+/// Method to declare routing algorithm deterministic
+/// \return true if next hop does not depend on source, congestion,
+/// faults, routing fault info or random numbers
+///
+/// Controller of a deterministic algorithm precomputes next hops into a
+/// routing table (see route_table.h) and calls calc_next only for entries
+/// missing in it.
+///////////////////////////////////////////////////
+bool router::is_deterministic() {
+    return false;
+}
 
-
+////////////////////////////////////////////////////
+/// Method to compute output directions of multicast packet
+/// \param ip_dir input direction from which flit entered the tile
+/// \param src_id tileID of source tile
+/// \param mode delivery mode (MCAST_TREE, MCAST_PATH_UP, MCAST_PATH_DOWN, MCAST_REDUCE)
+/// \param group id of destination group
+/// \param target next destination of worm (updated if this tile is reached), root of reduction
+/// \return bit (1 << dir) set for each output direction
+///
+/// Tree and reduction packets follow XY routes, path worms label-monotone
+/// routes, whatever unicast algorithm is loaded; routing plugins may override it (e.g. to avoid faulty links).
+///////////////////////////////////////////////////
+UI router::calc_multicast(UI, ULL src_id, UI mode, UI group, UI *target) {
+    if (mode == MCAST_TREE)
+        return multicast.tree_dirs(group, src_id, id);
+    if (mode == MCAST_REDUCE)
+        return multicast.reduce_dirs(id, *target);
+    return multicast.path_dirs(group, id, mode == MCAST_PATH_UP, *target);
+}
@@ -59,9 +59,15 @@ class router {
 		/// \brief virtual function that implements routing 
 		virtual UI calc_next(UI ip_dir, ULL src_id, ULL dst_id, routing_fault_info* rfi) = 0;
         
+		/// \brief virtual function that implements multicast replication (default: XY tree or dual-path)
+		virtual UI calc_multicast(UI ip_dir, ULL src_id, UI mode, UI group, UI *target);
+        
 		/// \brief virtual function to perform some initialization in routing algorithm
 		virtual void initialize() = 0;
         
+		/// \brief true if calc_next depends only on tile, input direction and destination (default: false)
+		virtual bool is_deterministic();
+        
 		void setID(UI);                             ///< function to set identifier
         void init_adaptive_ability(UI dir_list[6]); ///< init for adaptive routing algorithms
         void init_DyXY_routing(UI* stress_arr);     ///< DyXY-like algorithm init
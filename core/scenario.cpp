@@ -0,0 +1,225 @@
+/*
+ * scenario.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file scenario.cpp
+/// \brief Implements phased traffic scenario and its transient analysis
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <stdlib.h>
+#include <math.h>
+#include "scenario.h"
+
+traffic_scenario scenario;
+
+////////////////////////////////////////////////////////
+/// Function to convert pattern name to pattern
+/// \param name pattern name as used in config files
+/// \param pattern result
+/// \return false if name is unknown (pattern is not changed)
+////////////////////////////////////////////////////////
+bool parse_pattern(const string &name, traffic_pattern &pattern) {
+	if(name == "UNIFORM") pattern = PAT_UNIFORM;
+	else if(name == "TRANSPOSE") pattern = PAT_TRANSPOSE;
+	else if(name == "BIT_COMPLEMENT") pattern = PAT_BIT_COMPLEMENT;
+	else if(name == "BIT_REVERSE") pattern = PAT_BIT_REVERSE;
+	else if(name == "SHUFFLE") pattern = PAT_SHUFFLE;
+	else if(name == "TORNADO") pattern = PAT_TORNADO;
+	else if(name == "NEIGHBOR") pattern = PAT_NEIGHBOR;
+	else if(name == "HOTSPOT") pattern = PAT_HOTSPOT;
+	else return false;
+	return true;
+}
+
+/// orders phases by start cycle
+static bool phase_before(const traffic_phase &a, const traffic_phase &b) {
+	return a.start < b.start;
+}
+
+////////////////////////////////////////////////////////
+/// Method to read scenario file
+/// \param filename scenario file
+/// \return false if file cannot be opened
+////////////////////////////////////////////////////////
+bool traffic_scenario::load(const string &filename) {
+	phases.clear();
+	ifstream instream;
+	instream.open(filename.c_str());
+	if(!instream.is_open()) {
+		cout<<"Cannot open "<<filename<<endl;
+		return false;
+	}
+
+	string field;
+	while(instream >> field) {
+		if(field[0] == '#') {	// comment up to end of line
+			getline(instream, field);
+			continue;
+		}
+		if(field == "PHASE") {
+			traffic_phase phase;
+			instream >> phase.start;
+			phases.push_back(phase);
+			continue;
+		}
+		if(phases.empty()) {
+			cout<<filename<<": "<<field<<" before first PHASE ignored"<<endl;
+			continue;
+		}
+		traffic_phase &phase = phases.back();
+		if(field == "RATE_SCALE") {
+			double value = -1.0; instream >> value;
+			if(value >= 0.0)
+				phase.rate_scale = value;
+			else
+				cout<<filename<<": RATE_SCALE of PHASE "<<phase.start<<" must be >= 0 (0 - tiles silent), ignored"<<endl;
+		}
+		else if(field == "PATTERN") {
+			string value; instream >> value;
+			phase.set_pattern = (value != "KEEP");
+			if(phase.set_pattern && !parse_pattern(value, phase.pattern)) {
+				cout<<filename<<": unknown PATTERN "<<value<<", using UNIFORM"<<endl;
+				phase.pattern = PAT_UNIFORM;
+			}
+		}
+		else if(field == "HOTSPOT_TILES") {	// number of tiles followed by tile ids
+			UI n; instream >> n;
+			phase.hotspots.clear();
+			for(UI i = 0; i < n; i++) {
+				UI value; instream >> value;
+				phase.hotspots.push_back(value);
+			}
+		}
+		else if(field == "HOTSPOT_FRACTION") {
+			instream >> phase.hotspot_fraction;
+		}
+		else if(field == "TILES") {	// ALL or number of tiles followed by tile ids
+			string value; instream >> value;
+			phase.all_tiles = (value == "ALL");
+			if(phase.all_tiles)
+				continue;
+			UI n = atoi(value.c_str());
+			phase.tiles.assign(MAX_NUM_TILES, false);
+			for(UI i = 0; i < n; i++) {
+				UI id; instream >> id;
+				if(id < MAX_NUM_TILES)
+					phase.tiles[id] = true;
+			}
+		}
+		else
+			cout<<filename<<": unknown field "<<field<<endl;
+	}
+	instream.close();
+
+	stable_sort(phases.begin(), phases.end(), phase_before);
+	// traffic before first phase is unchanged
+	if(!phases.empty() && phases[0].start > 0)
+		phases.insert(phases.begin(), traffic_phase());
+	return true;
+}
+
+////////////////////////////////////////////////////////
+/// Method to find phase holding at a cycle
+/// \param cycle simulation cycle
+/// \return phase, NULL if there is no scenario
+////////////////////////////////////////////////////////
+const traffic_phase* traffic_scenario::phase_at(ULL cycle) const {
+	if(phases.empty())
+		return NULL;
+	UI lo = 0, hi = phases.size();	// last phase with start <= cycle lies in [lo, hi)
+	while(hi - lo > 1) {
+		UI mid = (lo + hi) / 2;
+		if(phases[mid].start <= cycle)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return &phases[lo];
+}
+
+////////////////////////////////////////////////////////
+/// Method to check for phases yet to come
+/// \param cycle simulation cycle
+/// \return true if a phase starts after cycle
+////////////////////////////////////////////////////////
+bool traffic_scenario::pending(ULL cycle) const {
+	return !phases.empty() && phases.back().start > cycle;
+}
+
+////////////////////////////////////////////////////////
+/// Method to measure transient response of each phase
+/// \param ts_cycle end cycle of each statistics window
+/// \param ts_flits flits received in each window
+/// \param ts_latency average flit latency in each window
+/// \param end_cycle last simulated cycle
+/// \param tolerance relative band around steady latency
+/// \param reports one report per phase started before end_cycle
+///
+/// Steady latency of a phase is average over windows of its second half.
+/// Phase has recovered at end of first window from which all later windows
+/// of phase stay within tolerance of it; this must happen before second half.
+////////////////////////////////////////////////////////
+void traffic_scenario::analyse(const vector<ULL> &ts_cycle, const vector<ULL> &ts_flits, const vector<double> &ts_latency,
+                               ULL end_cycle, double tolerance, vector<phase_report> &reports) const {
+	reports.clear();
+	for(UI p = 0; p < phases.size() && phases[p].start < end_cycle; p++) {
+		phase_report r;
+		r.start = phases[p].start;
+		r.end = (p + 1 < phases.size() && phases[p + 1].start < end_cycle) ? phases[p + 1].start : end_cycle;
+		r.windows = 0;
+		r.steady_latency = 0.0;
+		r.peak_latency = 0.0;
+		r.recovered = false;
+		r.recovery = 0;
+
+		// windows ending inside phase which received flits
+		vector<UI> win;
+		for(UI k = 0; k < ts_cycle.size(); k++)
+			if(ts_cycle[k] > r.start && ts_cycle[k] <= r.end && ts_flits[k] > 0)
+				win.push_back(k);
+		r.windows = win.size();
+		for(UI i = 0; i < win.size(); i++)
+			r.peak_latency = max(r.peak_latency, ts_latency[win[i]]);
+		if(win.size() < 4) {
+			reports.push_back(r);
+			continue;
+		}
+
+		UI half = win.size() / 2;
+		for(UI i = half; i < win.size(); i++)
+			r.steady_latency += ts_latency[win[i]];
+		r.steady_latency /= (win.size() - half);
+
+		// walk back from end of phase while windows stay within band
+		double band = tolerance * r.steady_latency;
+		UI first = win.size();
+		while(first > 0 && fabs(ts_latency[win[first - 1]] - r.steady_latency) <= band)
+			first--;
+		if(first < win.size() && first <= half) {
+			r.recovered = true;
+			r.recovery = ts_cycle[win[first]] - r.start;
+		}
+		reports.push_back(r);
+	}
+}
@@ -0,0 +1,129 @@
+/*
+ * scenario.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file scenario.h
+/// \brief Defines phased traffic scenario applied to all traffic generators
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCENARIO_
+#define _SCENARIO_
+
+#include <string>
+#include <vector>
+#include "../config/constants.h"
+
+using namespace std;
+
+/// synthetic traffic patterns (destination as function of source)
+enum traffic_pattern {
+	PAT_UNIFORM,		///< uniform random destination
+	PAT_TRANSPOSE,		///< (row, col) -> (col, row)
+	PAT_BIT_COMPLEMENT,	///< all bits of source id inverted
+	PAT_BIT_REVERSE,	///< bits of source id in reverse order
+	PAT_SHUFFLE,		///< bits of source id rotated left by one
+	PAT_TORNADO,		///< half way around each dimension: (r + ceil(R/2) - 1, c + ceil(C/2) - 1)
+	PAT_NEIGHBOR,		///< next tile in each dimension: (r + 1, c + 1)
+	PAT_HOTSPOT			///< hotspot tiles with given fraction, uniform random otherwise
+};
+
+/// returns pattern for its name in config files (false if name is unknown)
+bool parse_pattern(const string &name, traffic_pattern &pattern);
+
+/////////////////////////////////////////
+/// \brief one phase of traffic scenario
+///
+/// holds from its start cycle until start of next phase
+/////////////////////////////////////////
+struct traffic_phase {
+	ULL    start;	                ///< first cycle of phase
+	double rate_scale;	            ///< multiplies packet rate of every generator, 0 - no traffic
+	bool   set_pattern;	            ///< destinations are replaced by pattern
+	traffic_pattern pattern;	    ///< destination pattern (if set_pattern)
+	vector<UI> hotspots;	        ///< hotspot tiles of PAT_HOTSPOT
+	double hotspot_fraction;	    ///< fraction of packets sent to hotspot tiles
+	bool   all_tiles;	            ///< every tile generates traffic
+	vector<bool> tiles;	            ///< tiles generating traffic (if not all_tiles)
+
+	/// traffic phase constructor, phase does not change traffic
+	traffic_phase() {
+		start = 0;
+		rate_scale = 1.0;
+		set_pattern = false;
+		pattern = PAT_UNIFORM;
+		hotspot_fraction = 0.0;
+		all_tiles = true;
+	};
+
+	/// true if tile generates traffic in this phase
+	bool active(UI tile) const {
+		if(rate_scale <= 0.0)
+			return false;
+		return all_tiles || (tile < tiles.size() && tiles[tile]);
+	};
+};
+
+/////////////////////////////////////////
+/// \brief result of transient analysis of one phase
+/////////////////////////////////////////
+struct phase_report {
+	ULL    start;	                ///< first cycle of phase
+	ULL    end;	                    ///< first cycle after phase (or end of simulation)
+	UI     windows;	                ///< statistics windows ending inside phase
+	double steady_latency;	        ///< average window latency over second half of phase
+	double peak_latency;	        ///< largest window latency in phase
+	bool   recovered;	            ///< latency settled within RECOVERY_TOLERANCE before second half of phase
+	ULL    recovery;	            ///< cycles from phase start to end of first settled window
+};
+
+//////////////////////////////////////////////////////////////////////////
+/// \brief Phased traffic scenario
+///
+/// Read from SCENARIO_FILE, a sequence of PHASE blocks:
+/// - PHASE start_cycle
+/// - RATE_SCALE factor (0 silences all tiles, use TILES to silence some)
+/// - PATTERN name (UNIFORM, TRANSPOSE, BIT_COMPLEMENT, BIT_REVERSE, SHUFFLE,
+///   TORNADO, NEIGHBOR, HOTSPOT)
+/// - HOTSPOT_TILES n id1 .. idn, HOTSPOT_FRACTION f
+/// - TILES ALL | n id1 .. idn (participating tiles)
+///
+/// Each phase starts from unchanged traffic, i.e. fields are not inherited
+/// from previous phase. Traffic before first phase is unchanged.
+//////////////////////////////////////////////////////////////////////////
+struct traffic_scenario {
+	vector<traffic_phase> phases;	///< phases sorted by start cycle, first starts at cycle 0
+
+	// FUNCTIONS /////////////////////////////////////////////////////////////////////////////
+	bool load(const string &filename);	            ///< read scenario file
+	bool empty() const {	                        ///< true if there is no scenario
+		return phases.empty();
+	};
+	const traffic_phase* phase_at(ULL cycle) const;	///< returns phase holding at cycle (NULL if no scenario)
+	bool pending(ULL cycle) const;	                ///< true if a phase starts after cycle
+	/// transient analysis of windowed latency time series
+	void analyse(const vector<ULL> &ts_cycle, const vector<ULL> &ts_flits, const vector<double> &ts_latency,
+	             ULL end_cycle, double tolerance, vector<phase_report> &reports) const;
+	// FUNCTIONS END /////////////////////////////////////////////////////////////////////////
+};
+
+extern traffic_scenario scenario;	///< scenario shared by all traffic generators
+
+#endif
@@ -0,0 +1,402 @@
+/*
+ * trace_bin.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file trace_bin.cpp
+/// \brief Implements binary trace reader (mmap based) and writer
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <map>
+#include <algorithm>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "trace_bin.h"
+
+/// mapped trace files shared by all cursors
+static map<string, trace_bin_file*> trace_bin_files;
+
+////////////////////////////////////////////////////////
+/// appends unsigned LEB128 encoding of value
+////////////////////////////////////////////////////////
+static void put_varint(vector<unsigned char> &data, ULL value) {
+	while(value >= 0x80) {
+		data.push_back((unsigned char)(value & 0x7F) | 0x80);
+		value >>= 7;
+	}
+	data.push_back((unsigned char)value);
+}
+
+////////////////////////////////////////////////////////
+/// decodes unsigned LEB128 value and moves position
+/// \param pos decoding position
+/// \param end end of block data
+/// \param value decoded value
+/// \return false if encoding runs over end of block or past 64 bits
+////////////////////////////////////////////////////////
+static bool get_varint(const unsigned char *&pos, const unsigned char *end, ULL &value) {
+	value = 0;
+	for(UI shift = 0; pos < end && shift < 64; shift += 7) {
+		unsigned char byte = *pos++;
+		value |= (ULL)(byte & 0x7F) << shift;
+		if(!(byte & 0x80))
+			return true;
+	}
+	return false;
+}
+
+////////////////////////////////////////////////////////
+/// orders blocks by source tile (stable, keeps cycle order)
+////////////////////////////////////////////////////////
+static bool block_src_less(const trace_bin_block &a, const trace_bin_block &b) {
+	return a.src < b.src;
+}
+
+////////////////////////////////////////////////////////
+/// Method to map trace file
+/// \param path file name
+/// \return shared mapping, NULL on error
+////////////////////////////////////////////////////////
+trace_bin_file* trace_bin_file::open(const string &path) {
+	map<string, trace_bin_file*>::iterator it = trace_bin_files.find(path);
+	if(it != trace_bin_files.end()) {
+		it->second->refs++;
+		return it->second;
+	}
+	
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0) {
+		cout<<"Cannot open trace "<<path<<endl;
+		return NULL;
+	}
+	struct stat st;
+	if(fstat(fd, &st) != 0 || (ULL)st.st_size < sizeof(trace_bin_header)) {
+		cout<<"Trace "<<path<<" is too short"<<endl;
+		::close(fd);
+		return NULL;
+	}
+	void *mem = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	if(mem == MAP_FAILED) {
+		cout<<"Cannot map trace "<<path<<endl;
+		::close(fd);
+		return NULL;
+	}
+	
+	trace_bin_file *file = new trace_bin_file;
+	file->path = path;
+	file->fd = fd;
+	file->base = (const unsigned char*)mem;
+	file->length = st.st_size;
+	file->refs = 1;
+	file->hdr = (const trace_bin_header*)file->base;
+	
+	// header, index and tile table must lie inside file (checked without overflow)
+	const trace_bin_header *hdr = file->hdr;
+	bool ok = (memcmp(hdr->magic, TRACE_BIN_MAGIC, 8) == 0) && (hdr->version == TRACE_BIN_VERSION)
+	          && (hdr->index_offset <= file->length)
+	          && (hdr->num_blocks <= (file->length - hdr->index_offset) / sizeof(trace_bin_block))
+	          && (hdr->tiles_offset <= file->length)
+	          && ((ULL)hdr->num_tiles <= (file->length - hdr->tiles_offset) / sizeof(trace_bin_tile));
+	// data of every block must lie inside file
+	if(ok) {
+		const trace_bin_block *blocks = (const trace_bin_block*)(file->base + hdr->index_offset);
+		for(ULL i = 0; ok && i < hdr->num_blocks; i++)
+			ok = (blocks[i].offset <= file->length) && (blocks[i].bytes <= file->length - blocks[i].offset);
+	}
+	if(!ok) {
+		cout<<"Trace "<<path<<" is not a binary trace of version "<<TRACE_BIN_VERSION<<endl;
+		munmap(mem, file->length);
+		::close(fd);
+		delete file;
+		return NULL;
+	}
+	file->blocks = (const trace_bin_block*)(file->base + hdr->index_offset);
+	file->tiles = (const trace_bin_tile*)(file->base + hdr->tiles_offset);
+	
+	trace_bin_files[path] = file;
+	return file;
+}
+
+////////////////////////////////////////////////////////
+/// Method to release mapping, last user unmaps file
+////////////////////////////////////////////////////////
+void trace_bin_file::release() {
+	if(--refs > 0)
+		return;
+	trace_bin_files.erase(path);
+	munmap((void*)base, length);
+	::close(fd);
+	delete this;
+}
+
+////////////////////////////////////////////////////////
+/// cursor constructor
+////////////////////////////////////////////////////////
+trace_bin_cursor::trace_bin_cursor() {
+	file = NULL;
+	tile = 0;
+	block = 0;
+	block_end = 0;
+	pos = NULL;
+	end = NULL;
+	left = 0;
+	cycle = 0;
+}
+
+////////////////////////////////////////////////////////
+/// Method to open cursor over packets of a tile
+/// \param path trace file name
+/// \param tileID source tile
+/// \return false if trace cannot be mapped or blocks of tile are outside index
+////////////////////////////////////////////////////////
+bool trace_bin_cursor::open(const string &path, UI tileID) {
+	close();
+	file = trace_bin_file::open(path);
+	if(file == NULL)
+		return false;
+	tile = tileID;
+	if(tile < file->hdr->num_tiles) {
+		const trace_bin_tile &t = file->tiles[tile];
+		if(t.first_block > file->hdr->num_blocks || t.num_blocks > file->hdr->num_blocks - t.first_block) {
+			cout<<"Trace "<<path<<" is not a binary trace of version "<<TRACE_BIN_VERSION<<endl;
+			close();
+			return false;
+		}
+		block = t.first_block;
+		block_end = block + t.num_blocks;
+	}
+	return true;
+}
+
+////////////////////////////////////////////////////////
+/// Method to decode next packet of tile
+/// \param rec decoded packet
+/// \return false if tile has no more packets (or its block data is corrupt)
+////////////////////////////////////////////////////////
+bool trace_bin_cursor::next(trace_record &rec) {
+	if(file == NULL)
+		return false;
+	while(left == 0) {
+		if(block >= block_end)
+			return false;
+		const trace_bin_block &b = file->blocks[block];
+		pos = file->base + b.offset;
+		end = pos + b.bytes;
+		left = b.num_records;
+		cycle = b.first_cycle;
+		// ask OS to read ahead next block of this tile
+		if(block + 1 < block_end) {
+			const trace_bin_block &nb = file->blocks[block + 1];
+			ULL page = sysconf(_SC_PAGESIZE);
+			ULL start = nb.offset & ~(page - 1);
+			madvise((void*)(file->base + start), nb.offset + nb.bytes - start, MADV_WILLNEED);
+		}
+		block++;
+	}
+	ULL delta, dst, size, cls = 0;
+	bool ok = get_varint(pos, end, delta) && get_varint(pos, end, dst) && get_varint(pos, end, size);
+	if(ok && (file->hdr->flags & TRACE_BIN_HAS_CLASS))
+		ok = get_varint(pos, end, cls);
+	if(!ok) {	// record runs over end of block, drop rest of tile
+		cout<<"Trace "<<file->path<<" is not a binary trace of version "<<TRACE_BIN_VERSION<<endl;
+		block = block_end;
+		left = 0;
+		return false;
+	}
+	cycle += delta;
+	rec.cycle = cycle;
+	rec.src = tile;
+	rec.dst = (UI)dst;
+	rec.size = (UI)size;
+	rec.cls = (UI)cls;
+	left--;
+	return true;
+}
+
+////////////////////////////////////////////////////////
+/// \return inter-flit interval of tile (1 if tile is not in trace)
+////////////////////////////////////////////////////////
+UI trace_bin_cursor::flit_interval() {
+	if(file == NULL || tile >= file->hdr->num_tiles || file->tiles[tile].flit_interval == 0)
+		return 1;
+	return file->tiles[tile].flit_interval;
+}
+
+////////////////////////////////////////////////////////
+/// Method to release trace file
+////////////////////////////////////////////////////////
+void trace_bin_cursor::close() {
+	if(file != NULL)
+		file->release();
+	file = NULL;
+	block = 0;
+	block_end = 0;
+	left = 0;
+}
+
+////////////////////////////////////////////////////////
+/// writer constructor
+////////////////////////////////////////////////////////
+trace_bin_writer::trace_bin_writer() {
+	out = NULL;
+	memset(&hdr, 0, sizeof(hdr));
+}
+
+////////////////////////////////////////////////////////
+/// Method to create trace file
+/// \param path file name
+/// \param num_tiles number of source tiles
+/// \param flags TRACE_BIN_HAS_CLASS or 0
+/// \param block_size number of records per block
+/// \return false if file cannot be created
+////////////////////////////////////////////////////////
+bool trace_bin_writer::open(const string &path, UI num_tiles, UI flags, UI block_size) {
+	out = fopen(path.c_str(), "wb");
+	if(out == NULL) {
+		cout<<"Cannot create trace "<<path<<endl;
+		return false;
+	}
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, TRACE_BIN_MAGIC, 8);
+	hdr.version = TRACE_BIN_VERSION;
+	hdr.flags = flags;
+	hdr.num_tiles = num_tiles;
+	hdr.block_size = (block_size > 0) ? block_size : TRACE_BIN_BLOCK_SIZE;
+	
+	trace_bin_tile t;
+	memset(&t, 0, sizeof(t));
+	t.flit_interval = 1;
+	tiles.assign(num_tiles, t);
+	trace_bin_block b;
+	memset(&b, 0, sizeof(b));
+	open_block.assign(num_tiles, b);
+	open_data.assign(num_tiles, vector<unsigned char>());
+	last_cycle.assign(num_tiles, 0);
+	blocks.clear();
+	
+	// header is rewritten on close
+	return fwrite(&hdr, sizeof(hdr), 1, out) == 1;
+}
+
+////////////////////////////////////////////////////////
+/// Method to set inter-flit interval of tile
+////////////////////////////////////////////////////////
+void trace_bin_writer::set_flit_interval(UI tileID, UI interval) {
+	if(tileID < tiles.size())
+		tiles[tileID].flit_interval = interval;
+}
+
+////////////////////////////////////////////////////////
+/// Method to append packet to trace
+/// \param rec packet
+/// \return false if tile is unknown or cycle goes back in time
+////////////////////////////////////////////////////////
+bool trace_bin_writer::add(const trace_record &rec) {
+	if(out == NULL || rec.src >= tiles.size())
+		return false;
+	UI t = rec.src;
+	bool tile_started = (tiles[t].num_records > 0 || open_block[t].num_records > 0);
+	if(tile_started && rec.cycle < last_cycle[t])
+		return false;
+	
+	trace_bin_block &b = open_block[t];
+	if(b.num_records == 0) {
+		b.src = t;
+		b.first_cycle = rec.cycle;
+		last_cycle[t] = rec.cycle;
+	}
+	vector<unsigned char> &data = open_data[t];
+	put_varint(data, rec.cycle - last_cycle[t]);
+	put_varint(data, rec.dst);
+	put_varint(data, rec.size);
+	if(hdr.flags & TRACE_BIN_HAS_CLASS)
+		put_varint(data, rec.cls);
+	last_cycle[t] = rec.cycle;
+	b.num_records++;
+	hdr.num_records++;
+	
+	if(b.num_records >= hdr.block_size)
+		return flush_block(t);
+	return true;
+}
+
+////////////////////////////////////////////////////////
+/// Method to write open block of tile
+////////////////////////////////////////////////////////
+bool trace_bin_writer::flush_block(UI tileID) {
+	trace_bin_block &b = open_block[tileID];
+	if(b.num_records == 0)
+		return true;
+	vector<unsigned char> &data = open_data[tileID];
+	b.offset = ftello(out);
+	b.bytes = data.size();
+	if(fwrite(&data[0], 1, data.size(), out) != data.size())
+		return false;
+	blocks.push_back(b);
+	tiles[tileID].num_records += b.num_records;
+	b.num_records = 0;
+	data.clear();
+	return true;
+}
+
+////////////////////////////////////////////////////////
+/// Method to finish trace file
+/// \return false on write error
+////////////////////////////////////////////////////////
+bool trace_bin_writer::close() {
+	if(out == NULL)
+		return false;
+	bool ok = true;
+	for(UI t = 0; t < tiles.size(); t++)
+		ok &= flush_block(t);
+	
+	// index sorted by tile, blocks of a tile stay in cycle order
+	stable_sort(blocks.begin(), blocks.end(), block_src_less);
+	for(ULL k = 0; k < blocks.size(); k++) {
+		trace_bin_tile &t = tiles[blocks[k].src];
+		if(t.num_blocks == 0)
+			t.first_block = k;
+		t.num_blocks++;
+	}
+	
+	// align index to 8 bytes
+	ULL offset = ftello(out);
+	while(offset % 8 != 0) {
+		fputc(0, out);
+		offset++;
+	}
+	hdr.num_blocks = blocks.size();
+	hdr.index_offset = offset;
+	if(!blocks.empty())
+		ok &= (fwrite(&blocks[0], sizeof(trace_bin_block), blocks.size(), out) == blocks.size());
+	hdr.tiles_offset = ftello(out);
+	if(!tiles.empty())
+		ok &= (fwrite(&tiles[0], sizeof(trace_bin_tile), tiles.size(), out) == tiles.size());
+	
+	fseeko(out, 0, SEEK_SET);
+	ok &= (fwrite(&hdr, sizeof(hdr), 1, out) == 1);
+	ok &= (fclose(out) == 0);
+	out = NULL;
+	return ok;
+}
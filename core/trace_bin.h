@@ -0,0 +1,164 @@
+/*
+ * trace_bin.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file trace_bin.h
+/// \brief Defines compact binary trace format, its memory-mapped reader and writer
+///
+/// Layout of trace file (all integers in native byte order):
+/// - trace_bin_header at offset 0
+/// - data blocks, each holds up to block_size records of one source tile:
+///   varint(cycle - previous cycle), varint(destination), varint(size in flits) [, varint(class)]
+///   (first record of block is relative to first_cycle of block)
+/// - block index (trace_bin_block per block, sorted by source tile and cycle)
+/// - tile table (trace_bin_tile per tile, range of its blocks in index)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _TRACE_BIN_
+#define _TRACE_BIN_
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "../config/constants.h"
+
+using namespace std;
+
+#define TRACE_BIN_MAGIC         "NIRGTRB"   ///< magic string at file start (8 bytes with terminating zero)
+#define TRACE_BIN_VERSION       1           ///< version of format
+#define TRACE_BIN_HAS_CLASS     0x1         ///< flag: records carry traffic class
+#define TRACE_BIN_BLOCK_SIZE    4096        ///< default number of records per block
+
+/////////////////////////////////////////
+/// \brief header of binary trace file
+/////////////////////////////////////////
+struct trace_bin_header {
+	char    magic[8];       ///< TRACE_BIN_MAGIC
+	UI      version;        ///< TRACE_BIN_VERSION
+	UI      flags;          ///< TRACE_BIN_HAS_CLASS or 0
+	UI      num_tiles;      ///< number of tiles in tile table
+	UI      block_size;     ///< largest number of records in block
+	ULL     num_records;    ///< total number of records
+	ULL     num_blocks;     ///< total number of blocks
+	ULL     index_offset;   ///< file offset of block index
+	ULL     tiles_offset;   ///< file offset of tile table
+};
+
+/////////////////////////////////////////
+/// \brief entry of tile table
+/////////////////////////////////////////
+struct trace_bin_tile {
+	UI      flit_interval;  ///< inter-flit interval of source (in clock cycles)
+	UI      reserved;       ///< padding, always 0
+	ULL     first_block;    ///< index of first block of tile
+	ULL     num_blocks;     ///< number of blocks of tile
+	ULL     num_records;    ///< number of records of tile
+};
+
+/////////////////////////////////////////
+/// \brief entry of block index
+/////////////////////////////////////////
+struct trace_bin_block {
+	ULL     offset;         ///< file offset of block data
+	ULL     first_cycle;    ///< injection cycle of first record
+	UI      src;            ///< source tile of all records in block
+	UI      num_records;    ///< number of records in block
+	UI      bytes;          ///< size of block data (in bytes)
+	UI      reserved;       ///< padding, always 0
+};
+
+/////////////////////////////////////////
+/// \brief one packet of trace
+/////////////////////////////////////////
+struct trace_record {
+	ULL     cycle;          ///< injection cycle, relative to start of traffic generation
+	UI      src;            ///< source tile
+	UI      dst;            ///< destination tile or route code
+	UI      size;           ///< packet size (in flits)
+	UI      cls;            ///< traffic class (0 if trace has no classes)
+};
+
+//////////////////////////////////////////////////////////////////////////
+/// \brief memory-mapped binary trace file
+///
+/// File is mapped read-only once and shared by all cursors, pages are
+/// loaded by OS on demand, so trace may be larger than RAM.
+//////////////////////////////////////////////////////////////////////////
+struct trace_bin_file {
+	string                  path;       ///< file name
+	int                     fd;         ///< file descriptor
+	const unsigned char     *base;      ///< start of mapping
+	ULL                     length;     ///< size of mapping (in bytes)
+	UI                      refs;       ///< number of users of mapping
+	const trace_bin_header  *hdr;       ///< file header
+	const trace_bin_block   *blocks;    ///< block index
+	const trace_bin_tile    *tiles;     ///< tile table
+
+	static trace_bin_file* open(const string &path);   ///< map file (or return already mapped one)
+	void release();                                     ///< drop one user, unmap on last
+};
+
+//////////////////////////////////////////////////////////////////////////
+/// \brief sequential reader of packets of one source tile
+//////////////////////////////////////////////////////////////////////////
+struct trace_bin_cursor {
+	trace_bin_file          *file;      ///< mapped trace (NULL if not opened)
+	UI                      tile;       ///< source tile
+	ULL                     block;      ///< current block in index
+	ULL                     block_end;  ///< index of first block after blocks of tile
+	const unsigned char     *pos;       ///< decoding position inside current block
+	const unsigned char     *end;       ///< end of data of current block
+	UI                      left;       ///< records left in current block
+	ULL                     cycle;      ///< cycle of last decoded record
+
+	trace_bin_cursor();
+	bool open(const string &path, UI tileID);   ///< open cursor over packets of given tile
+	bool next(trace_record &rec);               ///< decode next packet, false at end of tile
+	UI   flit_interval();                       ///< inter-flit interval of tile
+	void close();                               ///< release trace file
+};
+
+//////////////////////////////////////////////////////////////////////////
+/// \brief writer of binary trace
+///
+/// Records of a tile must be added in non-decreasing cycle order, tiles
+/// may be interleaved. Each tile keeps one open block in memory.
+//////////////////////////////////////////////////////////////////////////
+struct trace_bin_writer {
+	FILE                            *out;       ///< output file
+	trace_bin_header                hdr;        ///< header written on close
+	vector<trace_bin_tile>          tiles;      ///< tile table
+	vector<trace_bin_block>         blocks;     ///< index of written blocks
+	vector< vector<unsigned char> > open_data;  ///< data of open block per tile
+	vector<trace_bin_block>         open_block; ///< open block per tile
+	vector<ULL>                     last_cycle; ///< cycle of last record per tile
+
+	trace_bin_writer();
+	bool open(const string &path, UI num_tiles, UI flags = 0, UI block_size = TRACE_BIN_BLOCK_SIZE); ///< create trace file
+	void set_flit_interval(UI tileID, UI interval);     ///< set inter-flit interval of tile
+	bool add(const trace_record &rec);                  ///< append packet, false if out of order or bad tile
+	bool close();                                       ///< flush blocks, write index, tile table and header
+
+private:
+	bool flush_block(UI tileID);                        ///< write open block of tile to file
+};
+
+#endif
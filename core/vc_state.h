@@ -0,0 +1,52 @@
+/*
+ * vc_state.h
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file vc_state.h
+/// \brief Defines snapshot of an occupied virtual channel (used by deadlock/livelock watchdog)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _VC_STATE_
+#define _VC_STATE_
+
+#include "../config/constants.h"
+
+///////////////////////////////////////////////////////////////
+/// \brief snapshot of occupied virtual channel
+///
+/// describes the flit at the front of a non-empty VC
+///////////////////////////////////////////////////////////////
+struct vc_state {
+	UI	        tile;	        ///< tile ID
+	UI	        port_dir;	    ///< direction of input channel (N, S, E, W, C)
+	UI	        vc;	            ///< VC id in input channel
+	UI	        route;	        ///< routing decision of VC (N, S, E, W, C), 5 - not routed yet
+	UI	        next_vc;	    ///< allocated VC on next tile, NUM_VCS + 1 - not allocated
+	UI	        num_flits;	    ///< number of flits in VC
+	ULL	        stuck_cycles;	///< cycles since front flit changed last time
+	UI	        src;	        ///< source tile of front flit
+	UI	        pktid;	        ///< packet id of front flit
+	UI	        flitid;	        ///< flit id of front flit
+	UI	        hopcount;	    ///< hop count of front flit
+	flit_type	flittype;	    ///< type of front flit
+};
+
+#endif
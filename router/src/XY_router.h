@@ -43,6 +43,9 @@ class XY_router : public router {
 		UI calc_next(UI ip_dir, ULL source_id, ULL dest_id, routing_fault_info* rfi);
 		
 		void initialize();	///< any initializations to be done
+		
+		/// \brief next hop depends only on tile and destination, routing table is used
+		bool is_deterministic() { return true; }
 };
 
 #endif
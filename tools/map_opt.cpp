@@ -0,0 +1,452 @@
+/*
+ * map_opt.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file map_opt.cpp
+/// \brief Maps tasks of task graph onto tiles by simulated annealing
+///
+/// Usage: map_opt task_graph [-c nirgam_config] [-o prefix] [-w contention_weight]
+///        [-n steps] [-s seed] [-p period] [-v every command results_file]
+/// - cost is sum of (message flits * hops) plus contention_weight times
+///   sum of squared link loads over total volume, links loaded along routes of RT_ALGO
+///   (XY and SOURCE exactly, adaptive algorithms split over XY and YX paths)
+/// - mesh size, topology and RT_ALGO are read from nirgam_config (config/nirgam.config)
+/// - every -v steps, best mapping (if changed) is written and command is run;
+///   makespan is read from results_file and best simulated mapping wins
+/// - writes prefix + application.config, task.graph and traffic.matrix
+///   (prefix defaults to config/mapped_), matrix rates are flits over period
+///   (default: longest path of computation times)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <math.h>
+#include "../config/constants.h"
+
+using namespace std;
+
+/// number of annealing moves per temperature step and task
+#define MOVES_PER_TASK	20
+/// temperature is multiplied by this after each step
+#define COOLING			0.95
+
+/// task of task graph
+struct map_task {
+	UI  id;				///< task id in file
+	UI  tile;			///< tile in file
+	ULL compute;		///< computation time (in cycles)
+};
+
+/// edge of task graph, between task indices
+struct map_edge {
+	UI src;				///< producing task (index)
+	UI dst;				///< consuming task (index)
+	UI flits;			///< message size (in flits)
+};
+
+static UI rows = 4;						///< mesh rows
+static UI cols = 4;						///< mesh columns
+static bool torus = false;				///< torus topology
+static bool adaptive = false;			///< routing algorithm is adaptive
+static vector<string> header;			///< PACKET_FLITS/FLIT_INTERVAL lines of task graph
+static vector<map_task> tasks;			///< tasks
+static vector<map_edge> edges;			///< edges
+static double weight = 1.0;				///< contention weight
+static double total_volume = 0.0;		///< sum of message sizes
+
+////////////////////////////////////////////////
+/// Function to read mesh size, topology and routing algorithm
+/// \param filename simulator configuration
+////////////////////////////////////////////////
+static void read_config(string filename) {
+	ifstream in(filename.c_str());
+	if(!in.is_open()) {
+		cout<<"Cannot open "<<filename<<", using 4x4 mesh with XY routing"<<endl;
+		return;
+	}
+	string line;
+	while(getline(in, line)) {
+		istringstream fields(line);
+		string name, value;
+		fields >> name >> value;
+		if(name == "NUM_ROWS")
+			rows = atoi(value.c_str());
+		else if(name == "NUM_COLS")
+			cols = atoi(value.c_str());
+		else if(name == "TOPOLOGY")
+			torus = (value == "TORUS");
+		else if(name == "RT_ALGO")
+			adaptive = (value != "XY" && value != "SOURCE");
+	}
+}
+
+////////////////////////////////////////////////
+/// Function to read task graph
+/// \param filename task graph in TaskGraph format
+/// \return false if file cannot be read
+////////////////////////////////////////////////
+static bool read_graph(string filename) {
+	ifstream in(filename.c_str());
+	if(!in.is_open()) {
+		cout<<"Cannot open "<<filename<<endl;
+		return false;
+	}
+	vector<int> index;
+	vector<UI> esrc, edst, eflits;
+	string field;
+	while(in >> field) {
+		if(field[0] == '#') {	// comment up to end of line
+			getline(in, field);
+		}
+		else if(field == "PACKET_FLITS" || field == "FLIT_INTERVAL") {
+			string value; in >> value;
+			header.push_back(field + " " + value);
+		}
+		else if(field == "TASK") {
+			map_task t;
+			in >> t.id >> t.tile >> t.compute;
+			if(t.id >= index.size())
+				index.resize(t.id + 1, -1);
+			index[t.id] = tasks.size();
+			tasks.push_back(t);
+		}
+		else if(field == "EDGE") {
+			UI s, d, f;
+			in >> s >> d >> f;
+			esrc.push_back(s);
+			edst.push_back(d);
+			eflits.push_back((f < 1) ? 1 : f);
+		}
+		else
+			cout<<filename<<": unknown field "<<field<<endl;
+	}
+	for(UI e = 0; e < esrc.size(); e++) {
+		if(esrc[e] >= index.size() || edst[e] >= index.size() || index[esrc[e]] < 0 || index[edst[e]] < 0) {
+			cout<<filename<<": edge "<<esrc[e]<<" -> "<<edst[e]<<" joins undefined task"<<endl;
+			continue;
+		}
+		map_edge me;
+		me.src = index[esrc[e]];
+		me.dst = index[edst[e]];
+		me.flits = eflits[e];
+		edges.push_back(me);
+		total_volume += me.flits;
+	}
+	return true;
+}
+
+////////////////////////////////////////////////
+/// Function to walk one dimension towards destination
+/// \param from present coordinate
+/// \param to destination coordinate
+/// \param size ring/row length
+/// \return +1, -1 or 0
+////////////////////////////////////////////////
+static int step(UI from, UI to, UI size) {
+	if(from == to)
+		return 0;
+	int fwd = ((int)to - (int)from + (int)size) % (int)size;	// hops in + direction with wraparound
+	if(!torus)
+		return (to > from) ? 1 : -1;
+	return (fwd <= (int)size - fwd) ? 1 : -1;
+}
+
+////////////////////////////////////////////////
+/// Function to add load along dimension-ordered route
+/// \param load link loads, 4 directed links per tile
+/// \param src source tile
+/// \param dst destination tile
+/// \param flits load to add
+/// \param x_first route X (columns) before Y (rows)
+/// \return number of hops
+////////////////////////////////////////////////
+static UI route(vector<double> &load, UI src, UI dst, double flits, bool x_first) {
+	UI r = src / cols, c = src % cols;
+	UI dr = dst / cols, dc = dst % cols;
+	UI hops = 0;
+	for(UI phase = 0; phase < 2; phase++) {
+		bool x = (phase == 0) == x_first;
+		while(x ? (c != dc) : (r != dr)) {
+			int s = x ? step(c, dc, cols) : step(r, dr, rows);
+			UI dir = x ? ((s > 0) ? E : W) : ((s > 0) ? S : N);
+			load[(r * cols + c) * 4 + dir] += flits;
+			if(x)
+				c = (c + cols + s) % cols;
+			else
+				r = (r + rows + s) % rows;
+			hops++;
+		}
+	}
+	return hops;
+}
+
+////////////////////////////////////////////////
+/// Function to compute cost of mapping
+/// \param map tile of each task
+/// \return hop-weighted volume plus contention term
+////////////////////////////////////////////////
+static double cost(const vector<UI> &map) {
+	vector<double> load(rows * cols * 4, 0.0);
+	double volume_hops = 0.0;
+	for(UI e = 0; e < edges.size(); e++) {
+		UI src = map[edges[e].src], dst = map[edges[e].dst];
+		if(src == dst)
+			continue;
+		double flits = edges[e].flits;
+		UI hops;
+		if(adaptive) {
+			hops = route(load, src, dst, flits / 2, true);
+			route(load, src, dst, flits / 2, false);
+		}
+		else
+			hops = route(load, src, dst, flits, true);
+		volume_hops += flits * hops;
+	}
+	double contention = 0.0;
+	for(UI l = 0; l < load.size(); l++)
+		contention += load[l] * load[l];
+	return volume_hops + ((total_volume > 0.0) ? weight * contention / total_volume : 0.0);
+}
+
+////////////////////////////////////////////////
+/// Function to compute longest path of computation times
+/// \return cycles of longest path (edges taken as free)
+////////////////////////////////////////////////
+static ULL longest_path() {
+	vector<ULL> finish(tasks.size(), 0);
+	for(UI t = 0; t < tasks.size(); t++)
+		finish[t] = tasks[t].compute;
+	for(UI round = 0; round < tasks.size(); round++) {	// relax edges, graph is acyclic
+		bool changed = false;
+		for(UI e = 0; e < edges.size(); e++) {
+			ULL f = finish[edges[e].src] + tasks[edges[e].dst].compute;
+			if(f > finish[edges[e].dst]) {
+				finish[edges[e].dst] = f;
+				changed = true;
+			}
+		}
+		if(!changed)
+			break;
+	}
+	ULL res = 1;
+	for(UI t = 0; t < tasks.size(); t++)
+		if(finish[t] > res)
+			res = finish[t];
+	return res;
+}
+
+////////////////////////////////////////////////
+/// Function to write mapping
+/// \param map tile of each task
+/// \param prefix prefix of output files
+/// \param period cycles matrix rates are averaged over
+////////////////////////////////////////////////
+static void write_mapping(const vector<UI> &map, string prefix, ULL period) {
+	string app_file = prefix + "application.config";
+	ofstream app(app_file.c_str());
+	vector<bool> used(rows * cols, false);
+	for(UI t = 0; t < tasks.size(); t++)
+		used[map[t]] = true;
+	for(UI i = 0; i < rows * cols; i++)
+		if(used[i])
+			app<<i<<" TaskGraph.so"<<endl;
+	app.close();
+	
+	string graph_file = prefix + "task.graph";
+	ofstream graph(graph_file.c_str());
+	graph<<"# task graph mapped by map_opt"<<endl;
+	for(UI i = 0; i < header.size(); i++)
+		graph<<header[i]<<endl;
+	graph<<"# TASK id tile compute_cycles"<<endl;
+	for(UI t = 0; t < tasks.size(); t++)
+		graph<<"TASK "<<tasks[t].id<<" "<<map[t]<<" "<<tasks[t].compute<<endl;
+	graph<<"# EDGE src_task dst_task flits"<<endl;
+	for(UI e = 0; e < edges.size(); e++)
+		graph<<"EDGE "<<tasks[edges[e].src].id<<" "<<tasks[edges[e].dst].id<<" "<<edges[e].flits<<endl;
+	graph.close();
+	
+	string matrix_file = prefix + "traffic.matrix";
+	ofstream matrix(matrix_file.c_str());
+	matrix<<"# traffic matrix of task graph mapped by map_opt, flits over "<<period<<" cycles"<<endl;
+	for(UI e = 0; e < edges.size(); e++) {
+		UI src = map[edges[e].src], dst = map[edges[e].dst];
+		if(src != dst)
+			matrix<<"FLOW "<<src<<" "<<dst<<" "<<(double)edges[e].flits / period<<endl;
+	}
+	matrix.close();
+}
+
+////////////////////////////////////////////////
+/// Function to run simulation of mapping
+/// \param command shell command running the simulator
+/// \param results_file results written by simulator
+/// \return makespan, 0 if it cannot be read
+////////////////////////////////////////////////
+static ULL simulate(string command, string results_file) {
+	if(system(command.c_str()) != 0)
+		cout<<"Validation command returned error"<<endl;
+	ifstream in(results_file.c_str());
+	string line;
+	while(getline(in, line)) {
+		if(line.compare(0, 8, "Makespan") != 0)
+			continue;
+		size_t pos = line.find('=');
+		if(pos != string::npos)
+			return strtoull(line.c_str() + pos + 1, NULL, 10);
+	}
+	cout<<"No makespan in "<<results_file<<endl;
+	return 0;
+}
+
+int main(int argc, char *argv[]) {
+	if(argc < 2) {
+		cout<<"Usage: "<<argv[0]<<" task_graph [-c nirgam_config] [-o prefix] [-w contention_weight]"
+		    <<" [-n steps] [-s seed] [-p period] [-v every command results_file]"<<endl;
+		return 1;
+	}
+	string graph_file = argv[1];
+	string config_file = "config/nirgam.config";
+	string prefix = "config/mapped_";
+	UI steps = 200;
+	UI seed = 1;
+	ULL period = 0;
+	UI every = 0;
+	string command, results_file;
+	for(int i = 2; i < argc; i++) {
+		string opt = argv[i];
+		if(opt == "-c" && i + 1 < argc)
+			config_file = argv[++i];
+		else if(opt == "-o" && i + 1 < argc)
+			prefix = argv[++i];
+		else if(opt == "-w" && i + 1 < argc)
+			weight = atof(argv[++i]);
+		else if(opt == "-n" && i + 1 < argc)
+			steps = atoi(argv[++i]);
+		else if(opt == "-s" && i + 1 < argc)
+			seed = atoi(argv[++i]);
+		else if(opt == "-p" && i + 1 < argc)
+			period = strtoull(argv[++i], NULL, 10);
+		else if(opt == "-v" && i + 3 < argc) {
+			every = atoi(argv[++i]);
+			command = argv[++i];
+			results_file = argv[++i];
+		}
+		else {
+			cout<<"Unknown option "<<opt<<endl;
+			return 1;
+		}
+	}
+	
+	read_config(config_file);
+	if(!read_graph(graph_file))
+		return 1;
+	UI num_tiles = rows * cols;
+	if(tasks.empty() || tasks.size() > num_tiles) {
+		cout<<"Need 1 to "<<num_tiles<<" tasks, found "<<tasks.size()<<endl;
+		return 1;
+	}
+	if(period == 0)
+		period = longest_path();
+	srand(seed);
+	
+	// slot[i] is task on tile i or -1, starting from mapping in file (if valid)
+	vector<UI> map(tasks.size());
+	vector<int> slot(num_tiles, -1);
+	for(UI t = 0; t < tasks.size(); t++) {
+		UI tile = tasks[t].tile;
+		if(tile >= num_tiles || slot[tile] >= 0) {
+			for(tile = 0; slot[tile] >= 0; tile++)
+				;
+		}
+		map[t] = tile;
+		slot[tile] = t;
+	}
+	double current = cost(map);
+	cout<<"Initial cost "<<current<<endl;
+	
+	// initial temperature from average cost change of random moves
+	double temp = 0.0;
+	for(UI i = 0; i < 100; i++) {
+		vector<UI> trial = map;
+		trial[rand() % tasks.size()] = rand() % num_tiles;
+		temp += fabs(cost(trial) - current);
+	}
+	temp = (temp > 0.0) ? temp / 100 : 1.0;
+	
+	vector<UI> best = map, best_sim = map;
+	double best_cost = current;
+	ULL best_makespan = 0;
+	bool best_changed = true;
+	for(UI s = 0; s < steps; s++) {
+		for(UI m = 0; m < MOVES_PER_TASK * tasks.size(); m++) {
+			// move task to random tile, swapping with task already there
+			UI t = rand() % tasks.size();
+			UI to = rand() % num_tiles;
+			UI from = map[t];
+			if(to == from)
+				continue;
+			int other = slot[to];
+			map[t] = to;
+			if(other >= 0)
+				map[other] = from;
+			double trial = cost(map);
+			if(trial <= current || (double)rand() / RAND_MAX < exp((current - trial) / temp)) {
+				current = trial;
+				slot[to] = t;
+				slot[from] = other;
+				if(current < best_cost) {
+					best_cost = current;
+					best = map;
+					best_changed = true;
+				}
+			}
+			else {
+				map[t] = from;
+				if(other >= 0)
+					map[other] = to;
+			}
+		}
+		temp *= COOLING;
+		
+		if(every > 0 && best_changed && ((s + 1) % every == 0 || s + 1 == steps)) {
+			best_changed = false;
+			write_mapping(best, prefix, period);
+			ULL makespan = simulate(command, results_file);
+			cout<<"Step "<<s + 1<<": cost "<<best_cost<<", simulated makespan "<<makespan<<endl;
+			if(makespan > 0 && (best_makespan == 0 || makespan <= best_makespan)) {	// on tie, later candidate has lower cost
+				best_makespan = makespan;
+				best_sim = best;
+			}
+		}
+	}
+	
+	vector<UI> &winner = (best_makespan > 0) ? best_sim : best;
+	write_mapping(winner, prefix, period);
+	cout<<"Best cost "<<cost(winner);
+	if(best_makespan > 0)
+		cout<<", simulated makespan "<<best_makespan;
+	cout<<endl<<"Written "<<prefix<<"application.config, "<<prefix<<"task.graph and "<<prefix<<"traffic.matrix"<<endl;
+	return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * trace_convert.cpp
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ *
+ */
+ /*
+ * Portions of changes by Alexander Rumyanthev (darkstreamray@gmail.com) SPbSU ITMO 2010.
+ */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// \file trace_convert.cpp
+/// \brief Converts text traffic logs (log/traffic/tile-N) into binary trace
+///
+/// Usage: trace_convert num_tiles output_file [input_dir] [block_size]
+/// - input_dir defaults to log/traffic
+/// - first packet of each tile is placed at cycle 0, next ones follow NEXT_PKT_INTERVAL
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <fstream>
+#include <stdlib.h>
+#include "../core/trace_bin.h"
+
+int main(int argc, char *argv[]) {
+	if(argc < 3) {
+		cout<<"Usage: "<<argv[0]<<" num_tiles output_file [input_dir] [block_size]"<<endl;
+		return 1;
+	}
+	UI num_tiles = atoi(argv[1]);
+	string out_file = argv[2];
+	string in_dir = (argc > 3) ? string(argv[3]) : string("log/traffic");
+	UI block_size = (argc > 4) ? atoi(argv[4]) : TRACE_BIN_BLOCK_SIZE;
+	
+	trace_bin_writer writer;
+	if(!writer.open(out_file, num_tiles, 0, block_size))
+		return 1;
+	
+	for(UI t = 0; t < num_tiles; t++) {
+		char str_id[12];
+		sprintf(str_id, "%d", t);
+		string traffic_filename = in_dir + string("/tile-") + string(str_id);
+		ifstream trafstream(traffic_filename.c_str());
+		if(!trafstream.is_open())
+			continue;
+		
+		string field;
+		int flit_interval = 1;
+		trafstream >> field >> flit_interval;
+		writer.set_flit_interval(t, flit_interval);
+		
+		trace_record rec;
+		rec.src = t;
+		rec.cls = 0;
+		ULL cycle = 0;
+		int next_pkt_time, num_flits, route_info;
+		while(trafstream >> field >> next_pkt_time >> field >> num_flits >> field >> route_info) {
+			rec.cycle = cycle;
+			rec.dst = route_info;
+			rec.size = num_flits;
+			writer.add(rec);
+			cycle += (next_pkt_time > 0) ? next_pkt_time : 0;
+		}
+		trafstream.close();
+	}
+	
+	if(!writer.close()) {
+		cout<<"Error writing "<<out_file<<endl;
+		return 1;
+	}
+	cout<<"Written "<<writer.hdr.num_records<<" packets in "<<writer.hdr.num_blocks<<" blocks to "<<out_file<<endl;
+	return 0;
+}